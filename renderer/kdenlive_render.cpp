@@ -25,6 +25,8 @@
 #include <QUrl>
 #include <QDebug>
 #include "renderjob.h"
+#include "parallelrenderjob.h"
+#include "rendertelemetry.h"
 
 int main(int argc, char **argv)
 {
@@ -58,6 +60,33 @@ int main(int argc, char **argv)
             locale = args.at(0).section(QLatin1Char(':'), 1);
             args.removeFirst();
         }
+        RenderTelemetry telemetry;
+        if (args.at(0) == QLatin1String("-progress-json")) {
+            telemetry.setStreamEnabled(true);
+            args.removeFirst();
+        }
+        if (args.at(0).startsWith(QLatin1String("-summary:"))) {
+            telemetry.setSummaryPath(args.takeFirst().section(QLatin1Char(':'), 1));
+        }
+        int segments = 0;
+        QList<int> splits;
+        QString ffmpeg;
+        QString ffprobe;
+        if (args.at(0).startsWith(QLatin1String("-parallel:"))) {
+            segments = args.takeFirst().section(QLatin1Char(':'), 1).toInt();
+        }
+        if (args.at(0).startsWith(QLatin1String("-splits:"))) {
+            const QStringList positions = args.takeFirst().section(QLatin1Char(':'), 1).split(QLatin1Char(','), QString::SkipEmptyParts);
+            for (const QString &pos : positions) {
+                splits << pos.toInt();
+            }
+        }
+        if (args.at(0).startsWith(QLatin1String("-ffmpeg:"))) {
+            ffmpeg = args.takeFirst().section(QLatin1Char(':'), 1);
+        }
+        if (args.at(0).startsWith(QLatin1String("-ffprobe:"))) {
+            ffprobe = args.takeFirst().section(QLatin1Char(':'), 1);
+        }
         if (args.at(0).startsWith(QLatin1String("in="))) {
             in = args.takeFirst().section(QLatin1Char('='), -1).toInt();
         }
@@ -119,11 +148,36 @@ int main(int argc, char **argv)
             }
         }
 
+        if (telemetry.isActive()) {
+            telemetry.start(dest, in >= 0 && out >= in ? out - in + 1 : 0);
+        }
+
+        if ((segments > 1 || !splits.isEmpty()) && rendermodule == QLatin1String("avformat") && ParallelRenderJob::canSplit(args, dest, in, out)) {
+            qDebug() << "//STARTING PARALLEL RENDERING: " << segments << ',' << splits << ',' << render << ',' << profile << ',' << src << ',' << dest << ',' << preargs << ',' << args << ',' << in << ',' << out;
+            ParallelRenderJob *parallelJob = new ParallelRenderJob(erase, pid, render, profile, rendermodule, player, src, dest, preargs, args, in, out);
+            if (!locale.isEmpty()) {
+                parallelJob->setLocale(locale);
+            }
+            parallelJob->setSegmentCount(segments);
+            parallelJob->setSplitPoints(splits);
+            parallelJob->setToolPaths(ffmpeg, ffprobe);
+            if (telemetry.isActive()) {
+                parallelJob->setTelemetry(&telemetry);
+            }
+            parallelJob->start();
+            app.exec();
+            delete parallelJob;
+            return 0;
+        }
+
         qDebug() << "//STARTING RENDERING: " << erase << ',' << usekuiserver << ',' << render << ',' << profile << ',' << rendermodule << ',' << player << ',' << src << ',' << dest << ',' << preargs << ',' << args << ',' << in << ',' << out;
         RenderJob *job = new RenderJob(doerase, usekuiserver, pid, render, profile, rendermodule, player, src, dest, preargs, args, in, out);
         if (!locale.isEmpty()) {
             job->setLocale(locale);
         }
+        if (telemetry.isActive()) {
+            job->setTelemetry(&telemetry);
+        }
         job->start();
         RenderJob *dualjob = nullptr;
         if (dualpass) {
@@ -132,16 +186,24 @@ int main(int argc, char **argv)
             }
             args.replace(args.indexOf(QStringLiteral("pass=1")), QStringLiteral("pass=2"));
             dualjob = new RenderJob(erase, usekuiserver, pid, render, profile, rendermodule, player, src, dest, preargs, args, in, out);
+            if (telemetry.isActive()) {
+                dualjob->setTelemetry(&telemetry);
+            }
             QObject::connect(job, &RenderJob::renderingFinished, dualjob, &RenderJob::start);
         }
         app.exec();
         delete dualjob;
     } else {
         fprintf(stderr, "Kdenlive video renderer for MLT.\nUsage: "
-                "kdenlive_render [-erase] [-kuiserver] [-locale:LOCALE] [in=pos] [out=pos] [render] [profile] [rendermodule] [player] [src] [dest] [[arg1] [arg2] ...]\n"
+                "kdenlive_render [-erase] [-kuiserver] [-locale:LOCALE] [-progress-json] [-summary:FILE] [-parallel:N] [-splits:POS,...] [-ffmpeg:PATH] [-ffprobe:PATH] [in=pos] [out=pos] [render] [profile] [rendermodule] [player] [src] [dest] [[arg1] [arg2] ...]\n"
                 "  -erase: if that parameter is present, src file will be erased at the end\n"
                 "  -kuiserver: if that parameter is present, use KDE job tracker\n"
                 "  -locale:LOCALE : set a locale for rendering. For example, -locale:fr_FR.UTF-8 will use a french locale (comma as numeric separator)\n"
+                "  -progress-json: write progress on stdout as one JSON object per line (frames, fps, elapsed time, ETA, output size)\n"
+                "  -summary:FILE : write a JSON summary of the render (status, timings per stage, average and peak fps) to FILE\n"
+                "  -parallel:N : render the video in N segments in parallel and join them without re-encoding\n"
+                "  -splits:POS,... : render the video in segments starting at these frame positions (for example guides)\n"
+                "  -ffmpeg:PATH, -ffprobe:PATH : tools used to join and verify segments in parallel mode\n"
                 "  in=pos: start rendering at frame pos\n"
                 "  out=pos: end rendering at frame pos\n"
                 "  render: path to MLT melt renderer\n"
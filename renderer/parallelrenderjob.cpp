@@ -0,0 +1,543 @@
+/***************************************************************************
+ *   Copyright (C) 2018 by Jean-Baptiste Mardelle (jb@kdenlive.org)        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+#include "parallelrenderjob.h"
+#include "renderjob.h"
+#include "rendertelemetry.h"
+
+#include <QtDBus>
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QRegExp>
+#include <QUrl>
+#include <QDebug>
+
+#include <algorithm>
+
+// Segments shorter than this are not worth the concatenation overhead
+static const int MIN_SEGMENT_FRAMES = 250;
+
+ParallelRenderJob::ParallelRenderJob(bool erase, int pid, const QString &renderer, const QString &profile, const QString &rendermodule, const QString &player, const QString &scenelist, const QString &dest, const QStringList &preargs, const QStringList &args, int in, int out) :
+    QObject(),
+    m_erase(erase),
+    m_pid(pid),
+    m_renderer(renderer),
+    m_profile(profile),
+    m_rendermodule(rendermodule),
+    m_player(player),
+    m_scenelist(scenelist),
+    m_dest(dest),
+    m_preargs(preargs),
+    m_args(args),
+    m_in(in),
+    m_out(out),
+    m_segmentCount(2),
+    m_ffmpeg(QStringLiteral("ffmpeg")),
+    m_ffprobe(QStringLiteral("ffprobe")),
+    m_audioJob(nullptr),
+    m_audioProgress(0),
+    m_runningJobs(0),
+    m_progress(0),
+    m_aborted(false),
+    m_concatProcess(nullptr),
+    m_probeProcess(nullptr),
+    m_telemetry(nullptr),
+    m_kdenliveinterface(nullptr),
+    m_logfile(dest + QStringLiteral(".txt"))
+{
+    if (!m_logfile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "Unable to log to " << m_logfile.fileName();
+    } else {
+        m_logstream.setDevice(&m_logfile);
+    }
+}
+
+ParallelRenderJob::~ParallelRenderJob()
+{
+    qDeleteAll(m_segments);
+    delete m_audioJob;
+    delete m_concatProcess;
+    delete m_probeProcess;
+    m_logfile.close();
+}
+
+bool ParallelRenderJob::canSplit(const QStringList &args, const QString &dest, int in, int out)
+{
+    if (in < 0 || out <= in) {
+        // We need to know the rendered zone to split it
+        return false;
+    }
+    if (args.contains(QStringLiteral("pass=1")) || args.contains(QStringLiteral("pass=2")) || args.contains(QStringLiteral("vn=1"))) {
+        // Two pass encoding and audio only renders are done in one go
+        return false;
+    }
+    // Image sequences are already split
+    return !QRegExp(QStringLiteral(".*%[0-9]*d.*")).exactMatch(dest);
+}
+
+void ParallelRenderJob::setLocale(const QString &locale)
+{
+    m_locale = locale;
+    qputenv("LC_NUMERIC", locale.toUtf8().constData());
+}
+
+void ParallelRenderJob::setSegmentCount(int count)
+{
+    m_segmentCount = qMax(1, count);
+}
+
+void ParallelRenderJob::setSplitPoints(const QList<int> &points)
+{
+    m_splitPoints = points;
+}
+
+void ParallelRenderJob::setToolPaths(const QString &ffmpeg, const QString &ffprobe)
+{
+    if (!ffmpeg.isEmpty()) {
+        m_ffmpeg = ffmpeg;
+    }
+    if (!ffprobe.isEmpty()) {
+        m_ffprobe = ffprobe;
+    }
+}
+
+void ParallelRenderJob::setTelemetry(RenderTelemetry *telemetry)
+{
+    m_telemetry = telemetry;
+}
+
+QList<int> ParallelRenderJob::segmentBoundaries() const
+{
+    QList<int> boundaries;
+    if (!m_splitPoints.isEmpty()) {
+        // Split at the requested positions (usually guides)
+        for (int pos : m_splitPoints) {
+            if (pos > m_in && pos <= m_out && !boundaries.contains(pos)) {
+                boundaries << pos;
+            }
+        }
+        std::sort(boundaries.begin(), boundaries.end());
+        return boundaries;
+    }
+    // Align boundaries on the GOP size so that the joined file has the same structure as a single pass render
+    int gop = 0;
+    for (const QString &arg : m_args) {
+        if (arg.startsWith(QLatin1String("g="))) {
+            gop = arg.section(QLatin1Char('='), 1).toInt();
+        }
+    }
+    const int total = m_out - m_in + 1;
+    const int count = qMin(m_segmentCount, total / qMax(MIN_SEGMENT_FRAMES, 2 * gop));
+    for (int i = 1; i < count; ++i) {
+        int pos = total * i / count;
+        if (gop > 1) {
+            pos = qRound((double)pos / gop) * gop;
+        }
+        pos += m_in;
+        if (pos > m_in && pos <= m_out && (boundaries.isEmpty() || pos > boundaries.last())) {
+            boundaries << pos;
+        }
+    }
+    return boundaries;
+}
+
+QString ParallelRenderJob::segmentPath(const QString &suffix) const
+{
+    QFileInfo info(m_dest);
+    return info.absolutePath() + QLatin1Char('/') + info.completeBaseName() + QLatin1Char('.') + suffix + QLatin1Char('.') + info.suffix();
+}
+
+QString ParallelRenderJob::concatListPath() const
+{
+    return m_dest + QStringLiteral(".concat.txt");
+}
+
+void ParallelRenderJob::start()
+{
+    const QList<int> boundaries = segmentBoundaries();
+    if (boundaries.isEmpty()) {
+        // Zone is too short, render it in one go
+        m_logfile.remove();
+        RenderJob *job = new RenderJob(m_erase, false, m_pid, m_renderer, m_profile, m_rendermodule, m_player, m_scenelist, m_dest, m_preargs, m_args, m_in, m_out);
+        if (!m_locale.isEmpty()) {
+            job->setLocale(m_locale);
+        }
+        job->setParent(this);
+        job->setTelemetry(m_telemetry);
+        job->start();
+        return;
+    }
+    initKdenliveDbusInterface();
+
+    // Video segments, without audio
+    QStringList videoArgs = m_args;
+    videoArgs << QStringLiteral("an=1");
+    int segmentIn = m_in;
+    for (int i = 0; i <= boundaries.count(); ++i) {
+        int segmentOut = i < boundaries.count() ? boundaries.at(i) - 1 : m_out;
+        RenderJob *job = new RenderJob(false, false, m_pid, m_renderer, m_profile, m_rendermodule, QStringLiteral("-"), m_scenelist, segmentPath(QStringLiteral("part%1").arg(i + 1)), m_preargs, videoArgs, segmentIn, segmentOut);
+        job->setEmbedded(true);
+        connect(job, &RenderJob::renderingProgress, this, &ParallelRenderJob::slotSegmentProgress);
+        connect(job, &RenderJob::jobFinished, this, &ParallelRenderJob::slotSegmentFinished);
+        m_segments << job;
+        m_segmentFrames << segmentOut - segmentIn + 1;
+        m_segmentProgress << 0;
+        segmentIn = segmentOut + 1;
+    }
+
+    // Audio is rendered in one pass to avoid seams at segment boundaries
+    if (!m_args.contains(QStringLiteral("an=1"))) {
+        QStringList audioArgs = m_args;
+        audioArgs << QStringLiteral("vn=1");
+        m_audioJob = new RenderJob(false, false, m_pid, m_renderer, m_profile, m_rendermodule, QStringLiteral("-"), m_scenelist, segmentPath(QStringLiteral("audio")), m_preargs, audioArgs, m_in, m_out);
+        m_audioJob->setEmbedded(true);
+        connect(m_audioJob, &RenderJob::renderingProgress, this, &ParallelRenderJob::slotSegmentProgress);
+        connect(m_audioJob, &RenderJob::jobFinished, this, &ParallelRenderJob::slotSegmentFinished);
+    }
+    m_logstream << "Parallel render of " << m_dest << " in " << m_segments.count() << " segments, boundaries: ";
+    for (int pos : boundaries) {
+        m_logstream << pos << ' ';
+    }
+    m_logstream << endl;
+
+    m_runningJobs = m_segments.count() + (m_audioJob ? 1 : 0);
+    if (m_telemetry) {
+        QStringList files;
+        for (RenderJob *job : m_segments) {
+            files << job->destination();
+        }
+        if (m_audioJob) {
+            files << m_audioJob->destination();
+        }
+        m_telemetry->setOutputFiles(files);
+        m_telemetry->beginStage(QStringLiteral("render"));
+    }
+    for (RenderJob *job : m_segments) {
+        job->start();
+    }
+    if (m_audioJob) {
+        m_audioJob->start();
+    }
+}
+
+void ParallelRenderJob::initKdenliveDbusInterface()
+{
+    QDBusConnection connection = QDBusConnection::sessionBus();
+    QDBusConnectionInterface *ibus = connection.interface();
+    QString kdenliveId = QStringLiteral("org.kde.kdenlive-%1").arg(m_pid);
+    if (!ibus->isServiceRegistered(kdenliveId)) {
+        kdenliveId.clear();
+        const QStringList services = ibus->registeredServiceNames();
+        for (const QString &service : services) {
+            if (service.startsWith(QLatin1String("org.kde.kdenlive"))) {
+                kdenliveId = service;
+                break;
+            }
+        }
+    }
+    m_dbusargs.clear();
+    if (kdenliveId.isEmpty()) {
+        return;
+    }
+    m_kdenliveinterface = new QDBusInterface(kdenliveId, QStringLiteral("/kdenlive/MainWindow_1"), QStringLiteral("org.kde.kdenlive.rendering"), connection, this);
+    m_dbusargs.append(m_dest);
+    m_dbusargs.append((int) 0);
+    m_kdenliveinterface->callWithArgumentList(QDBus::NoBlock, QStringLiteral("setRenderingProgress"), m_dbusargs);
+    connect(m_kdenliveinterface, SIGNAL(abortRenderJob(QString)), this, SLOT(slotAbort(QString)));
+}
+
+void ParallelRenderJob::slotSegmentProgress(int progress)
+{
+    RenderJob *job = qobject_cast<RenderJob *>(sender());
+    if (job == m_audioJob) {
+        m_audioProgress = progress;
+    } else {
+        int ix = m_segments.indexOf(job);
+        if (ix < 0) {
+            return;
+        }
+        m_segmentProgress[ix] = progress;
+    }
+    // Weight segments by their length, audio counts as a tenth of the video
+    const int total = m_out - m_in + 1;
+    const double audioWeight = m_audioJob ? total / 10.0 : 0.;
+    double done = audioWeight * m_audioProgress;
+    for (int i = 0; i < m_segments.count(); ++i) {
+        done += (double)m_segmentFrames.at(i) * m_segmentProgress.at(i);
+    }
+    // Keep the last percent for concatenation
+    int pro = qMin(99, (int)(done / (total + audioWeight)));
+    if (m_telemetry) {
+        double frames = 0;
+        for (int i = 0; i < m_segments.count(); ++i) {
+            frames += m_segmentFrames.at(i) * m_segmentProgress.at(i) / 100.0;
+        }
+        m_telemetry->update((int) frames, qMax(pro, m_progress));
+    }
+    if (pro <= m_progress) {
+        return;
+    }
+    m_progress = pro;
+    if (m_kdenliveinterface && m_kdenliveinterface->isValid()) {
+        m_dbusargs[1] = m_progress;
+        m_kdenliveinterface->callWithArgumentList(QDBus::NoBlock, QStringLiteral("setRenderingProgress"), m_dbusargs);
+    }
+}
+
+void ParallelRenderJob::slotSegmentFinished(bool success, const QString &error)
+{
+    if (m_aborted) {
+        return;
+    }
+    RenderJob *job = qobject_cast<RenderJob *>(sender());
+    if (!success) {
+        QString message = error;
+        if (job) {
+            m_logstream << "Rendering of segment " << job->destination() << " failed, see " << job->logFile() << endl;
+            message.append(QStringLiteral("<br>") + tr("See %1 for details.").arg(job->logFile()));
+        }
+        abortJobs(job);
+        finish(false, message);
+        return;
+    }
+    m_runningJobs--;
+    if (m_runningJobs == 0) {
+        concatenate();
+    }
+}
+
+void ParallelRenderJob::concatenate()
+{
+    // Write the list of segments for the concat demuxer
+    QFile list(concatListPath());
+    if (!list.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        finish(false, tr("Cannot write to %1, check permissions.").arg(list.fileName()));
+        return;
+    }
+    QTextStream stream(&list);
+    for (RenderJob *job : m_segments) {
+        QString path = job->destination();
+        path.replace(QLatin1Char('\''), QStringLiteral("'\\''"));
+        stream << "file '" << path << "'\n";
+    }
+    stream.flush();
+    list.close();
+
+    QStringList args;
+    args << QStringLiteral("-y") << QStringLiteral("-v") << QStringLiteral("error");
+    args << QStringLiteral("-f") << QStringLiteral("concat") << QStringLiteral("-safe") << QStringLiteral("0") << QStringLiteral("-i") << list.fileName();
+    if (m_audioJob) {
+        args << QStringLiteral("-i") << m_audioJob->destination();
+        args << QStringLiteral("-map") << QStringLiteral("0:v") << QStringLiteral("-map") << QStringLiteral("1:a");
+    }
+    args << QStringLiteral("-c") << QStringLiteral("copy") << m_dest;
+    if (m_telemetry) {
+        m_telemetry->setOutputFiles(QStringList() << m_dest);
+        m_telemetry->beginStage(QStringLiteral("concat"));
+    }
+    m_concatProcess = new QProcess;
+    m_concatProcess->setProcessChannelMode(QProcess::MergedChannels);
+    connect(m_concatProcess, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this, &ParallelRenderJob::slotConcatFinished);
+    m_logstream << "Joining segments: " << m_ffmpeg << ' ' << args.join(QLatin1Char(' ')) << endl;
+    m_concatProcess->start(m_ffmpeg, args);
+    if (!m_concatProcess->waitForStarted()) {
+        finish(false, tr("Cannot start %1 to join rendered segments.").arg(m_ffmpeg));
+    }
+}
+
+void ParallelRenderJob::slotConcatFinished(int exitCode, QProcess::ExitStatus status)
+{
+    if (m_aborted) {
+        return;
+    }
+    if (status == QProcess::CrashExit || exitCode != 0) {
+        finish(false, QString::fromLocal8Bit(m_concatProcess->readAll()));
+        return;
+    }
+    // Verify the joined file: count video frames and compare stream timings
+    QStringList args;
+    args << QStringLiteral("-v") << QStringLiteral("error") << QStringLiteral("-count_packets");
+    args << QStringLiteral("-show_entries") << QStringLiteral("stream=codec_type,nb_read_packets,start_time,duration,r_frame_rate");
+    args << QStringLiteral("-of") << QStringLiteral("json") << m_dest;
+    if (m_telemetry) {
+        m_telemetry->beginStage(QStringLiteral("verify"));
+    }
+    m_probeProcess = new QProcess;
+    connect(m_probeProcess, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this, &ParallelRenderJob::slotProbeFinished);
+    m_probeProcess->start(m_ffprobe, args);
+    if (!m_probeProcess->waitForStarted()) {
+        m_logstream << "Cannot start " << m_ffprobe << ", skipping verification" << endl;
+        finish(true);
+    }
+}
+
+void ParallelRenderJob::slotProbeFinished(int exitCode, QProcess::ExitStatus status)
+{
+    if (m_aborted) {
+        return;
+    }
+    if (status == QProcess::CrashExit || exitCode != 0) {
+        m_logstream << "Verification of " << m_dest << " failed to run, skipping" << endl;
+        finish(true);
+        return;
+    }
+    const QJsonArray streams = QJsonDocument::fromJson(m_probeProcess->readAllStandardOutput()).object().value(QStringLiteral("streams")).toArray();
+    int frames = -1;
+    double fps = 0;
+    double videoStart = 0;
+    double videoDuration = 0;
+    double audioStart = 0;
+    double audioDuration = 0;
+    bool hasAudio = false;
+    for (const QJsonValue &value : streams) {
+        const QJsonObject stream = value.toObject();
+        const QString type = stream.value(QStringLiteral("codec_type")).toString();
+        if (type == QLatin1String("video") && frames < 0) {
+            frames = stream.value(QStringLiteral("nb_read_packets")).toString().toInt();
+            videoStart = stream.value(QStringLiteral("start_time")).toString().toDouble();
+            videoDuration = stream.value(QStringLiteral("duration")).toString().toDouble();
+            const QString rate = stream.value(QStringLiteral("r_frame_rate")).toString();
+            if (rate.section(QLatin1Char('/'), 1).toDouble() > 0) {
+                fps = rate.section(QLatin1Char('/'), 0, 0).toDouble() / rate.section(QLatin1Char('/'), 1).toDouble();
+            }
+        } else if (type == QLatin1String("audio") && !hasAudio) {
+            hasAudio = true;
+            audioStart = stream.value(QStringLiteral("start_time")).toString().toDouble();
+            audioDuration = stream.value(QStringLiteral("duration")).toString().toDouble();
+        }
+    }
+    const int expectedFrames = m_out - m_in + 1;
+    const double frameDuration = fps > 0 ? 1.0 / fps : 0.;
+    const double offset = hasAudio ? audioStart - videoStart : 0.;
+    QString summary = QStringLiteral("Verification: %1 frames (expected %2), video duration %3s, audio duration %4s, A/V offset %5 ms")
+                      .arg(frames).arg(expectedFrames).arg(videoDuration, 0, 'f', 3).arg(audioDuration, 0, 'f', 3).arg(offset * 1000, 0, 'f', 1);
+    m_logstream << summary << endl;
+    qDebug() << summary;
+
+    QStringList errors;
+    if (frames != expectedFrames) {
+        errors << tr("Joined file has %1 frames instead of %2.").arg(frames).arg(expectedFrames);
+    }
+    if (fps > 0 && videoDuration > 0 && qAbs(videoDuration - expectedFrames * frameDuration) > 2 * frameDuration) {
+        errors << tr("Joined file duration is %1s instead of %2s.").arg(videoDuration, 0, 'f', 3).arg(expectedFrames * frameDuration, 0, 'f', 3);
+    }
+    if (hasAudio && fps > 0 && qAbs(offset) > frameDuration) {
+        errors << tr("Audio is offset by %1 ms.").arg(offset * 1000, 0, 'f', 1);
+    }
+    if (errors.isEmpty()) {
+        finish(true);
+    } else {
+        finish(false, summary + QStringLiteral("<br>") + errors.join(QStringLiteral("<br>")));
+    }
+}
+
+void ParallelRenderJob::slotAbort(const QString &url)
+{
+    if (m_dest != url) {
+        return;
+    }
+    qWarning() << "Job aborted by user...";
+    abortJobs();
+    if (m_kdenliveinterface) {
+        m_dbusargs[1] = -3;
+        m_dbusargs.append(QString());
+        m_kdenliveinterface->callWithArgumentList(QDBus::NoBlock, QStringLiteral("setRenderingFinished"), m_dbusargs);
+    }
+    if (m_telemetry) {
+        m_telemetry->finish(QStringLiteral("aborted"));
+    }
+    removeTemporaryFiles();
+    if (m_erase) {
+        QFile(m_scenelist).remove();
+    }
+    QFile(m_dest).remove();
+    m_logstream << "Job aborted by user" << endl;
+    m_logstream.flush();
+    m_logfile.close();
+    qApp->quit();
+}
+
+void ParallelRenderJob::abortJobs(RenderJob *failed)
+{
+    m_aborted = true;
+    for (RenderJob *job : m_segments) {
+        if (job != failed) {
+            job->slotAbort();
+        }
+    }
+    if (m_audioJob && m_audioJob != failed) {
+        m_audioJob->slotAbort();
+    }
+    if (m_concatProcess) {
+        m_concatProcess->kill();
+    }
+    if (m_probeProcess) {
+        m_probeProcess->kill();
+    }
+}
+
+void ParallelRenderJob::removeTemporaryFiles()
+{
+    for (RenderJob *job : m_segments) {
+        QFile(job->destination()).remove();
+    }
+    if (m_audioJob) {
+        QFile(m_audioJob->destination()).remove();
+    }
+    QFile(concatListPath()).remove();
+}
+
+void ParallelRenderJob::finish(bool success, const QString &error)
+{
+    if (m_telemetry) {
+        m_telemetry->finish(success ? QStringLiteral("finished") : QStringLiteral("failed"), error);
+    }
+    removeTemporaryFiles();
+    if (m_erase) {
+        QFile(m_scenelist).remove();
+    }
+    if (m_kdenliveinterface) {
+        m_dbusargs[1] = success ? (int) - 1 : (int) - 2;
+        m_dbusargs.append(error);
+        m_kdenliveinterface->callWithArgumentList(QDBus::NoBlock, QStringLiteral("setRenderingFinished"), m_dbusargs);
+    }
+    if (!success) {
+        QString message = tr("Rendering of %1 aborted, resulting video will probably be corrupted.").arg(m_dest);
+        m_logstream << message << endl << error << endl;
+        m_logstream.flush();
+        QProcess::startDetached(QStringLiteral("kdialog"), QStringList() << QStringLiteral("--error") << message);
+        qApp->quit();
+        return;
+    }
+    m_logstream << "Rendering of " << m_dest << " finished" << endl;
+    if (m_player.length() > 3 && m_player.contains(QLatin1Char(' '))) {
+        QStringList args = m_player.split(QLatin1Char(' '));
+        QString exec = args.takeFirst();
+        // Decode url
+        QString url = QUrl::fromEncoded(args.takeLast().toUtf8()).toLocalFile();
+        args << url;
+        QProcess::startDetached(exec, args);
+    }
+    m_logstream.flush();
+    m_logfile.remove();
+    qApp->quit();
+}
@@ -0,0 +1,117 @@
+/***************************************************************************
+ *   Copyright (C) 2018 by Jean-Baptiste Mardelle (jb@kdenlive.org)        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+#ifndef PARALLELRENDERJOB_H
+#define PARALLELRENDERJOB_H
+
+#include <QObject>
+#include <QProcess>
+#include <QStringList>
+#include <QFile>
+#include <QTextStream>
+#include <QList>
+
+class RenderJob;
+class RenderTelemetry;
+class QDBusInterface;
+
+/**
+ * @class ParallelRenderJob
+ * @brief Renders a zone as several video segments in parallel, then joins them without re-encoding.
+ *
+ * The video is split at GOP aligned positions (or at the given split points, usually guides),
+ * each segment being rendered without audio by its own RenderJob. The audio is rendered in a
+ * separate single pass to avoid seams. Segments and audio are then concatenated by FFmpeg using
+ * stream copy, and the resulting file is checked for frame count, duration and A/V offset.
+ */
+class ParallelRenderJob : public QObject
+{
+    Q_OBJECT
+
+public:
+    ParallelRenderJob(bool erase, int pid, const QString &renderer, const QString &profile, const QString &rendermodule, const QString &player, const QString &scenelist, const QString &dest, const QStringList &preargs, const QStringList &args, int in, int out);
+    ~ParallelRenderJob();
+    void setLocale(const QString &locale);
+    /** @brief Number of video segments to render in parallel. */
+    void setSegmentCount(int count);
+    /** @brief Use these frame positions as segment boundaries instead of GOP aligned ones. */
+    void setSplitPoints(const QList<int> &points);
+    void setToolPaths(const QString &ffmpeg, const QString &ffprobe);
+    void setTelemetry(RenderTelemetry *telemetry);
+    /** @brief Returns true if the render parameters allow a segmented render. */
+    static bool canSplit(const QStringList &args, const QString &dest, int in, int out);
+
+public slots:
+    void start();
+
+private slots:
+    void slotSegmentProgress(int progress);
+    void slotSegmentFinished(bool success, const QString &error);
+    void slotConcatFinished(int exitCode, QProcess::ExitStatus status);
+    void slotProbeFinished(int exitCode, QProcess::ExitStatus status);
+    void slotAbort(const QString &url);
+
+private:
+    bool m_erase;
+    int m_pid;
+    QString m_renderer;
+    QString m_profile;
+    QString m_rendermodule;
+    QString m_player;
+    QString m_scenelist;
+    QString m_dest;
+    QStringList m_preargs;
+    QStringList m_args;
+    int m_in;
+    int m_out;
+    int m_segmentCount;
+    QList<int> m_splitPoints;
+    QString m_ffmpeg;
+    QString m_ffprobe;
+    QString m_locale;
+    /** @brief Video segment jobs, in timeline order. */
+    QList<RenderJob *> m_segments;
+    /** @brief Frame count of each video segment. */
+    QList<int> m_segmentFrames;
+    QList<int> m_segmentProgress;
+    RenderJob *m_audioJob;
+    int m_audioProgress;
+    int m_runningJobs;
+    int m_progress;
+    bool m_aborted;
+    QProcess *m_concatProcess;
+    QProcess *m_probeProcess;
+    RenderTelemetry *m_telemetry;
+    QDBusInterface *m_kdenliveinterface;
+    QList<QVariant> m_dbusargs;
+    QFile m_logfile;
+    QTextStream m_logstream;
+    /** @brief Returns the first frame of each segment after the first one. */
+    QList<int> segmentBoundaries() const;
+    QString segmentPath(const QString &suffix) const;
+    QString concatListPath() const;
+    void initKdenliveDbusInterface();
+    void concatenate();
+    /** @brief Stop all running jobs except @param failed, which already stopped and keeps its log. */
+    void abortJobs(RenderJob *failed = nullptr);
+    void removeTemporaryFiles();
+    void finish(bool success, const QString &error = QString());
+};
+
+#endif
@@ -18,6 +18,7 @@
  ***************************************************************************/
 
 #include "renderjob.h"
+#include "rendertelemetry.h"
 
 #include <QtDBus>
 #include <QFile>
@@ -50,7 +51,10 @@ RenderJob::RenderJob(bool erase, bool usekuiserver, int pid, const QString &rend
     m_seconds(0),
     m_frame(0),
     m_pid(pid),
-    m_dualpass(false)
+    m_dualpass(false),
+    m_embedded(false),
+    m_aborted(false),
+    m_telemetry(nullptr)
 {
     m_renderProcess = new QProcess;
     m_renderProcess->setReadChannel(QProcess::StandardError);
@@ -96,6 +100,37 @@ void RenderJob::setLocale(const QString &locale)
     qputenv("LC_NUMERIC", locale.toUtf8().constData());
 }
 
+void RenderJob::setEmbedded(bool embedded)
+{
+    m_embedded = embedded;
+}
+
+const QString &RenderJob::destination() const
+{
+    return m_dest;
+}
+
+QString RenderJob::logFile() const
+{
+    return m_logfile.fileName();
+}
+
+void RenderJob::setTelemetry(RenderTelemetry *telemetry)
+{
+    m_telemetry = telemetry;
+}
+
+QString RenderJob::encodingStage() const
+{
+    if (m_args.contains(QStringLiteral("pass=1"))) {
+        return QStringLiteral("pass1");
+    }
+    if (m_args.contains(QStringLiteral("pass=2"))) {
+        return QStringLiteral("pass2");
+    }
+    return QStringLiteral("encode");
+}
+
 void RenderJob::slotAbort(const QString &url)
 {
     if (m_dest == url) {
@@ -106,13 +141,26 @@ void RenderJob::slotAbort(const QString &url)
 void RenderJob::slotAbort()
 {
     qWarning() << "Job aborted by user...";
+    m_aborted = true;
     m_renderProcess->kill();
+    if (m_embedded) {
+        // The parent job handles notifications and cleanup of the source
+        QFile(m_dest).remove();
+        m_logstream << "Job aborted by user" << endl;
+        m_logstream.flush();
+        m_logfile.remove();
+        emit jobFinished(false, QString());
+        return;
+    }
 
     if (m_kdenliveinterface) {
         m_dbusargs[1] = -3;
         m_dbusargs.append(QString());
         m_kdenliveinterface->callWithArgumentList(QDBus::NoBlock, QStringLiteral("setRenderingFinished"), m_dbusargs);
     }
+    if (m_telemetry) {
+        m_telemetry->finish(QStringLiteral("aborted"));
+    }
     if (m_jobUiserver) {
         m_jobUiserver->call(QStringLiteral("terminate"), QString());
     }
@@ -133,7 +181,20 @@ void RenderJob::receivedStderr()
         m_errorMessage.append(result + QStringLiteral("<br>"));
     } else {
         m_logstream << "melt: " << result << endl;
-        int pro = result.section(QLatin1Char(' '), -1).toInt();
+        // Several progress lines can be received at once, only keep the last one
+        const QString last = result.section(QStringLiteral("Current Frame:"), -1);
+        int frame = last.section(QLatin1Char(','), 0, 0).simplified().toInt();
+        int pro = last.section(QLatin1Char(' '), -1).toInt();
+        if (m_telemetry) {
+            m_telemetry->beginStage(encodingStage());
+            int percent = pro;
+            if (m_args.contains(QStringLiteral("pass=1"))) {
+                percent /= 2.0;
+            } else if (m_args.contains(QStringLiteral("pass=2"))) {
+                percent = 50 + percent / 2.0;
+            }
+            m_telemetry->update(frame, qMax(percent, m_progress));
+        }
         if (pro <= m_progress || pro <= 0 || pro > 100) {
             return;
         }
@@ -143,7 +204,10 @@ void RenderJob::receivedStderr()
         } else if (m_args.contains(QStringLiteral("pass=2"))) {
             m_progress = 50 + m_progress / 2.0;
         }
-        int frame = result.section(QLatin1Char(','), 1).section(QLatin1Char(' '), -1).toInt();
+        if (m_embedded) {
+            emit renderingProgress(m_progress);
+            return;
+        }
         if (m_kdenliveinterface && m_kdenliveinterface->isValid()) {
             m_dbusargs[1] = m_progress;
             m_kdenliveinterface->callWithArgumentList(QDBus::NoBlock, QStringLiteral("setRenderingProgress"), m_dbusargs);
@@ -169,7 +233,7 @@ void RenderJob::receivedStderr()
 void RenderJob::start()
 {
     QDBusConnectionInterface *interface = QDBusConnection::sessionBus().interface();
-    if (interface && m_usekuiserver) {
+    if (interface && m_usekuiserver && !m_embedded) {
         if (!interface->isServiceRegistered(QStringLiteral("org.kde.JobViewServer"))) {
             qWarning() << "No org.kde.JobViewServer registered, trying to start kuiserver";
             if (QProcess::startDetached(QStringLiteral("kuiserver"))) {
@@ -203,12 +267,20 @@ void RenderJob::start()
             }
         }
     }
-    initKdenliveDbusInterface();
+    if (!m_embedded) {
+        initKdenliveDbusInterface();
+    }
+    if (m_telemetry) {
+        m_telemetry->beginStage(m_args.contains(QStringLiteral("pass=2")) ? encodingStage() : QStringLiteral("startup"));
+    }
 
     // Make sure the destination directory is writable
     QFileInfo checkDestination(QFileInfo(m_dest).absolutePath());
     if (!checkDestination.isWritable()) {
         slotIsOver(QProcess::NormalExit, false);
+        if (m_embedded) {
+            return;
+        }
     }
 
     // Because of the logging, we connect to stderr in all cases.
@@ -264,6 +336,30 @@ void RenderJob::slotCheckProcess(QProcess::ProcessState state)
 
 void RenderJob::slotIsOver(QProcess::ExitStatus status, bool isWritable)
 {
+    if (m_aborted) {
+        return;
+    }
+    if (m_embedded) {
+        if (m_erase) {
+            QFile(m_scenelist).remove();
+        }
+        if (!isWritable) {
+            QString error = tr("Cannot write to %1, check permissions.").arg(m_dest);
+            m_logstream << error << endl;
+            m_logstream.flush();
+            emit jobFinished(false, error);
+        } else if (status == QProcess::CrashExit || m_renderProcess->error() != QProcess::UnknownError || m_renderProcess->exitCode() != 0) {
+            m_logstream << "Rendering of " << m_dest << " crashed" << endl;
+            m_logstream.flush();
+            emit jobFinished(false, m_errorMessage);
+        } else {
+            m_logstream << "Rendering of " << m_dest << " finished" << endl;
+            m_logstream.flush();
+            m_logfile.remove();
+            emit jobFinished(true, QString());
+        }
+        return;
+    }
     if (m_jobUiserver) {
         m_jobUiserver->call(QStringLiteral("setDescriptionField"), (uint) 1,
                             tr("Rendered file"), m_dest);
@@ -276,6 +372,9 @@ void RenderJob::slotIsOver(QProcess::ExitStatus status, bool isWritable)
             m_dbusargs.append(error);
             m_kdenliveinterface->callWithArgumentList(QDBus::NoBlock, QStringLiteral("setRenderingFinished"), m_dbusargs);
         }
+        if (m_telemetry) {
+            m_telemetry->finish(QStringLiteral("failed"), error);
+        }
         QProcess::startDetached(QStringLiteral("kdialog"), QStringList() << QStringLiteral("--error") << error);
         m_logstream << error << endl;
         qApp->quit();
@@ -290,6 +389,9 @@ void RenderJob::slotIsOver(QProcess::ExitStatus status, bool isWritable)
             m_dbusargs.append(m_errorMessage);
             m_kdenliveinterface->callWithArgumentList(QDBus::NoBlock, QStringLiteral("setRenderingFinished"), m_dbusargs);
         }
+        if (m_telemetry) {
+            m_telemetry->finish(QStringLiteral("failed"), m_errorMessage);
+        }
         QStringList args;
         QString error = tr("Rendering of %1 aborted, resulting video will probably be corrupted.").arg(m_dest);
         args << QStringLiteral("--error") << error;
@@ -303,6 +405,9 @@ void RenderJob::slotIsOver(QProcess::ExitStatus status, bool isWritable)
             m_kdenliveinterface->callWithArgumentList(QDBus::NoBlock, QStringLiteral("setRenderingFinished"), m_dbusargs);
         }
         m_logstream << "Rendering of " << m_dest << " finished" << endl;
+        if (!m_dualpass && m_telemetry) {
+            m_telemetry->finish(QStringLiteral("finished"));
+        }
         if (!m_dualpass && m_player.length() > 3 && m_player.contains(QLatin1Char(' '))) {
             QStringList args = m_player.split(QLatin1Char(' '));
             QString exec = args.takeFirst();
@@ -28,6 +28,8 @@
 #include <QTemporaryFile>
 #include <QTextStream>
 
+class RenderTelemetry;
+
 class RenderJob : public QObject
 {
     Q_OBJECT
@@ -36,14 +38,23 @@ public:
     RenderJob(bool erase, bool usekuiserver, int pid, const QString &renderer, const QString &profile, const QString &rendermodule, const QString &player, const QString &scenelist, const QString &dest, const QStringList &preargs, const QStringList &args, int in = -1, int out = -1);
     ~RenderJob();
     void setLocale(const QString &locale);
+    /** @brief Run this job as a part of a ParallelRenderJob: do not talk to Kdenlive or kuiserver,
+     *  do not quit the application when done, but emit renderingProgress() and jobFinished() instead. */
+    void setEmbedded(bool embedded);
+    /** @brief The file rendered by this job. */
+    const QString &destination() const;
+    /** @brief The log of this job, kept after a failure. */
+    QString logFile() const;
+    /** @brief Report progress and the final status of this job to @param telemetry. */
+    void setTelemetry(RenderTelemetry *telemetry);
 
 public slots:
     void start();
+    void slotAbort();
 
 private slots:
     void slotIsOver(QProcess::ExitStatus status, bool isWritable = true);
     void receivedStderr();
-    void slotAbort();
     void slotAbort(const QString &url);
     void slotCheckProcess(QProcess::ProcessState state);
 
@@ -71,10 +82,19 @@ private:
     QStringList m_args;
     /** @brief Used to write to the log file. */
     QTextStream m_logstream;
+    bool m_embedded;
+    bool m_aborted;
+    RenderTelemetry *m_telemetry;
     void initKdenliveDbusInterface();
+    /** @brief Name of the telemetry stage for this job's encoding. */
+    QString encodingStage() const;
 
 signals:
     void renderingFinished();
+    /** @brief Progress of an embedded job, in percent. */
+    void renderingProgress(int progress);
+    /** @brief An embedded job is over. */
+    void jobFinished(bool success, const QString &error);
 };
 
 #endif
@@ -0,0 +1,201 @@
+/***************************************************************************
+ *   Copyright (C) 2018 by Jean-Baptiste Mardelle (jb@kdenlive.org)        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+#include "rendertelemetry.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+
+#include <stdio.h>
+
+// Minimum delay between two progress lines, also used to compute the instantaneous fps
+static const qint64 EMIT_INTERVAL = 500;
+
+RenderTelemetry::RenderTelemetry() :
+    m_stream(false),
+    m_totalFrames(0),
+    m_frames(0),
+    m_percent(0),
+    m_lastEmit(0),
+    m_lastEmitFrames(0),
+    m_fps(0),
+    m_peakFps(0),
+    m_stageStart(0),
+    m_finished(false)
+{
+}
+
+void RenderTelemetry::setStreamEnabled(bool enabled)
+{
+    m_stream = enabled;
+}
+
+void RenderTelemetry::setSummaryPath(const QString &path)
+{
+    m_summaryPath = path;
+}
+
+bool RenderTelemetry::isActive() const
+{
+    return m_stream || !m_summaryPath.isEmpty();
+}
+
+void RenderTelemetry::start(const QString &dest, int totalFrames)
+{
+    m_dest = dest;
+    m_outputFiles = QStringList() << dest;
+    m_totalFrames = qMax(0, totalFrames);
+    m_startDate = QDateTime::currentDateTime();
+    m_timer.start();
+}
+
+void RenderTelemetry::setOutputFiles(const QStringList &files)
+{
+    m_outputFiles = files;
+}
+
+void RenderTelemetry::beginStage(const QString &name)
+{
+    if (name == m_stage) {
+        return;
+    }
+    endStage();
+    m_stage = name;
+    m_stageStart = m_timer.elapsed();
+}
+
+void RenderTelemetry::endStage()
+{
+    if (m_stage.isEmpty()) {
+        return;
+    }
+    m_stages << QPair<QString, qint64>(m_stage, m_timer.elapsed() - m_stageStart);
+    m_stage.clear();
+}
+
+qint64 RenderTelemetry::outputBytes() const
+{
+    qint64 bytes = 0;
+    for (const QString &file : m_outputFiles) {
+        bytes += QFileInfo(file).size();
+    }
+    return bytes;
+}
+
+double RenderTelemetry::averageFps() const
+{
+    qint64 elapsed = m_timer.elapsed();
+    return elapsed > 0 ? m_frames * 1000.0 / elapsed : 0.;
+}
+
+void RenderTelemetry::update(int frames, int percent, bool force)
+{
+    if (!m_timer.isValid()) {
+        return;
+    }
+    if (m_totalFrames > 0) {
+        frames = qMin(frames, m_totalFrames);
+    }
+    m_frames = qMax(0, frames);
+    m_percent = qBound(0, percent, 100);
+    const qint64 now = m_timer.elapsed();
+    if (!force && now - m_lastEmit < EMIT_INTERVAL) {
+        return;
+    }
+    if (now > m_lastEmit && m_frames >= m_lastEmitFrames) {
+        m_fps = (m_frames - m_lastEmitFrames) * 1000.0 / (now - m_lastEmit);
+        m_peakFps = qMax(m_peakFps, m_fps);
+    }
+    m_lastEmit = now;
+    m_lastEmitFrames = m_frames;
+    if (!m_stream) {
+        return;
+    }
+    QJsonObject line;
+    line.insert(QStringLiteral("event"), QStringLiteral("progress"));
+    line.insert(QStringLiteral("stage"), m_stage);
+    line.insert(QStringLiteral("frame"), m_frames);
+    line.insert(QStringLiteral("total"), m_totalFrames);
+    line.insert(QStringLiteral("percent"), m_percent);
+    line.insert(QStringLiteral("fps"), m_fps);
+    line.insert(QStringLiteral("avg_fps"), averageFps());
+    line.insert(QStringLiteral("elapsed"), now / 1000.0);
+    if (m_percent > 0) {
+        line.insert(QStringLiteral("eta"), now / 1000.0 * (100 - m_percent) / m_percent);
+    } else {
+        line.insert(QStringLiteral("eta"), -1);
+    }
+    line.insert(QStringLiteral("bytes"), outputBytes());
+    fputs(QJsonDocument(line).toJson(QJsonDocument::Compact).constData(), stdout);
+    fputc('\n', stdout);
+    fflush(stdout);
+}
+
+void RenderTelemetry::finish(const QString &status, const QString &error)
+{
+    if (m_finished || !m_timer.isValid()) {
+        return;
+    }
+    m_finished = true;
+    endStage();
+    if (status == QLatin1String("finished")) {
+        update(m_totalFrames > 0 ? m_totalFrames : m_frames, 100, true);
+    }
+    if (m_stream) {
+        QJsonObject line;
+        line.insert(QStringLiteral("event"), status);
+        line.insert(QStringLiteral("elapsed"), m_timer.elapsed() / 1000.0);
+        fputs(QJsonDocument(line).toJson(QJsonDocument::Compact).constData(), stdout);
+        fputc('\n', stdout);
+        fflush(stdout);
+    }
+    if (m_summaryPath.isEmpty()) {
+        return;
+    }
+    QJsonObject stages;
+    for (const QPair<QString, qint64> &stage : m_stages) {
+        // A stage can be entered several times, sum the durations
+        stages.insert(stage.first, stages.value(stage.first).toDouble() + stage.second / 1000.0);
+    }
+    QJsonObject summary;
+    summary.insert(QStringLiteral("dest"), m_dest);
+    summary.insert(QStringLiteral("status"), status);
+    if (!error.isEmpty()) {
+        summary.insert(QStringLiteral("error"), error);
+    }
+    summary.insert(QStringLiteral("started"), m_startDate.toString(Qt::ISODate));
+    summary.insert(QStringLiteral("finished"), QDateTime::currentDateTime().toString(Qt::ISODate));
+    summary.insert(QStringLiteral("elapsed"), m_timer.elapsed() / 1000.0);
+    summary.insert(QStringLiteral("frames"), m_frames);
+    summary.insert(QStringLiteral("total"), m_totalFrames);
+    summary.insert(QStringLiteral("avg_fps"), averageFps());
+    summary.insert(QStringLiteral("peak_fps"), m_peakFps);
+    summary.insert(QStringLiteral("bytes"), outputBytes());
+    summary.insert(QStringLiteral("stages"), stages);
+    QFile file(m_summaryPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "Unable to write render summary to " << m_summaryPath;
+        return;
+    }
+    file.write(QJsonDocument(summary).toJson());
+    file.close();
+}
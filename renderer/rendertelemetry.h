@@ -0,0 +1,82 @@
+/***************************************************************************
+ *   Copyright (C) 2018 by Jean-Baptiste Mardelle (jb@kdenlive.org)        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+#ifndef RENDERTELEMETRY_H
+#define RENDERTELEMETRY_H
+
+#include <QString>
+#include <QStringList>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QList>
+#include <QPair>
+
+/**
+ * @class RenderTelemetry
+ * @brief Machine readable progress of a render.
+ *
+ * When the stream is enabled, one JSON object per line is written on stdout with the rendered
+ * frames, total frames, instantaneous and average fps, elapsed time, ETA and output size.
+ * A JSON summary, including the time spent in each stage, can be written when the render is over.
+ */
+class RenderTelemetry
+{
+public:
+    RenderTelemetry();
+    /** @brief Write progress lines on stdout. */
+    void setStreamEnabled(bool enabled);
+    /** @brief Write a JSON summary to this file when the render is over. */
+    void setSummaryPath(const QString &path);
+    /** @brief Returns true if progress lines or a summary were requested. */
+    bool isActive() const;
+    /** @brief Start measuring the render of @param totalFrames frames (0 if unknown) into @param dest. */
+    void start(const QString &dest, int totalFrames);
+    /** @brief Files whose size is reported as output bytes, defaults to the destination. */
+    void setOutputFiles(const QStringList &files);
+    /** @brief Ends the current stage and starts a new one, does nothing if it is already the current stage. */
+    void beginStage(const QString &name);
+    /** @brief Report progress, lines are only written every few hundred milliseconds unless @param force is true. */
+    void update(int frames, int percent, bool force = false);
+    /** @brief Ends the current stage, writes the last progress line and the summary. */
+    void finish(const QString &status, const QString &error = QString());
+
+private:
+    bool m_stream;
+    QString m_summaryPath;
+    QString m_dest;
+    QStringList m_outputFiles;
+    int m_totalFrames;
+    int m_frames;
+    int m_percent;
+    QElapsedTimer m_timer;
+    QDateTime m_startDate;
+    qint64 m_lastEmit;
+    int m_lastEmitFrames;
+    double m_fps;
+    double m_peakFps;
+    QString m_stage;
+    qint64 m_stageStart;
+    QList<QPair<QString, qint64> > m_stages;
+    bool m_finished;
+    qint64 outputBytes() const;
+    double averageFps() const;
+    void endStage();
+};
+
+#endif
@@ -42,8 +42,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "utils/KoIconUtils.h"
 #include "mltcontroller/clipcontroller.h"
 #include "mltcontroller/clippropertiescontroller.h"
+#include "mltcontroller/producerqueue.h"
 #include "project/projectcommands.h"
 #include "project/invaliddialog.h"
+#include "project/cachemanager.h"
 #include "projectsortproxymodel.h"
 #include "bincommands.h"
 #include "doc/documentchecker.h"
@@ -62,6 +64,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QVBoxLayout>
 #include <QTimeLine>
 #include <QSlider>
+#include <QScrollBar>
 #include <QMenu>
 #include <QtConcurrent>
 #include <QUndoCommand>
@@ -565,6 +568,12 @@ Bin::Bin(QWidget *parent) :
     connect(m_itemModel, SIGNAL(dataChanged(QModelIndex, QModelIndex)), m_proxyModel, SLOT(slotDataChanged(const QModelIndex &, const
             QModelIndex &)));
     connect(m_itemModel, &QAbstractItemModel::rowsInserted, this, &Bin::rowsInserted);
+    m_visibleClipsTimer.setSingleShot(true);
+    m_visibleClipsTimer.setInterval(200);
+    connect(&m_visibleClipsTimer, &QTimer::timeout, this, &Bin::slotPrioritizeVisibleClips);
+    m_timelinePropertiesTimer.setSingleShot(true);
+    m_timelinePropertiesTimer.setInterval(0);
+    connect(&m_timelinePropertiesTimer, &QTimer::timeout, this, &Bin::slotUpdateTimelineProducers);
     connect(m_itemModel, &QAbstractItemModel::rowsRemoved, this, &Bin::rowsRemoved);
     connect(m_proxyModel, &ProjectSortProxyModel::selectModel, this, &Bin::selectProxyModel);
     connect(m_itemModel, SIGNAL(itemDropped(QStringList, QModelIndex)), this, SLOT(slotItemDropped(QStringList, QModelIndex)));
@@ -1246,6 +1255,8 @@ void Bin::setDocument(KdenliveDoc *project)
     setEnabled(false);
 
     // Cleanup previous project
+    m_timelinePropertiesTimer.stop();
+    m_pendingTimelineProperties.clear();
     if (m_rootFolder) {
         while (!m_rootFolder->isEmpty()) {
             AbstractProjectItem *child = m_rootFolder->at(0);
@@ -1609,6 +1620,37 @@ void Bin::rowsInserted(const QModelIndex &parent, int start, int end)
     Q_UNUSED(start)
     Q_UNUSED(end)
     //Moved selection stuff to emitItemAdded otherwise selection is messaed up by sorting
+    m_visibleClipsTimer.start();
+}
+
+void Bin::slotPrioritizeVisibleClips()
+{
+    if (!m_itemView) {
+        return;
+    }
+    QStringList ids;
+    visibleClipIds(m_itemView->rootIndex(), ids);
+    if (!ids.isEmpty()) {
+        pCore->producerQueue()->prioritize(ids);
+    }
+}
+
+void Bin::visibleClipIds(const QModelIndex &parent, QStringList &ids) const
+{
+    const QRect viewRect = m_itemView->viewport()->rect();
+    for (int i = 0; i < m_proxyModel->rowCount(parent); ++i) {
+        QModelIndex ix = m_proxyModel->index(i, 0, parent);
+        if (m_listType == BinTreeView && m_proxyModel->hasChildren(ix) && static_cast<QTreeView *>(m_itemView)->isExpanded(ix)) {
+            visibleClipIds(ix, ids);
+        }
+        if (!m_itemView->visualRect(ix).intersects(viewRect)) {
+            continue;
+        }
+        AbstractProjectItem *item = static_cast<AbstractProjectItem *>(m_proxyModel->mapToSource(ix).internalPointer());
+        if (item && item->itemType() == AbstractProjectItem::ClipItem) {
+            ids << item->clipId();
+        }
+    }
 }
 
 void Bin::rowsRemoved(const QModelIndex &parent, int start, int end)
@@ -1755,6 +1797,7 @@ void Bin::slotInitView(QAction *action)
     }
     m_itemView->setMouseTracking(true);
     m_itemView->viewport()->installEventFilter(this);
+    connect(m_itemView->verticalScrollBar(), &QAbstractSlider::valueChanged, &m_visibleClipsTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
     QSize zoom = m_iconSize * (m_slider->value() / 4.0);
     m_itemView->setIconSize(zoom);
     QPixmap pix(zoom);
@@ -2104,7 +2147,10 @@ void Bin::slotThumbnailReady(const QString &id, const QImage &img, bool fromFile
         // Save thumbnail for later reuse
         bool ok = false;
         if (!fromFile) {
-            img.save(m_doc->getCacheDir(CacheThumbs, &ok).absoluteFilePath(clip->hash() + QStringLiteral(".png")));
+            const QString thumbPath = m_doc->getCacheDir(CacheThumbs, &ok).absoluteFilePath(clip->hash() + QStringLiteral(".png"));
+            if (img.save(thumbPath)) {
+                pCore->cacheManager()->addFile(thumbPath);
+            }
         }
     }
 }
@@ -3737,8 +3783,32 @@ void Bin::slotUpdateClipProperties(const QString &id, const QMap<QString, QStrin
 
 void Bin::updateTimelineProducers(const QString &id, const QMap<QString, QString> &passProperties)
 {
-    pCore->projectManager()->currentTimeline()->updateClipProperties(id, passProperties);
-    m_doc->renderer()->updateSlowMotionProducers(id, passProperties);
+    QMap<QString, QString> &pending = m_pendingTimelineProperties[id];
+    QMapIterator<QString, QString> i(passProperties);
+    while (i.hasNext()) {
+        i.next();
+        pending.insert(i.key(), i.value());
+    }
+    m_timelinePropertiesTimer.start();
+}
+
+void Bin::slotUpdateTimelineProducers()
+{
+    if (m_pendingTimelineProperties.isEmpty()) {
+        return;
+    }
+    Timeline *timeline = pCore->projectManager()->currentTimeline();
+    if (timeline) {
+        timeline->updateClipProperties(m_pendingTimelineProperties);
+    }
+    if (m_doc) {
+        QMapIterator<QString, QMap<QString, QString> > i(m_pendingTimelineProperties);
+        while (i.hasNext()) {
+            i.next();
+            m_doc->renderer()->updateSlowMotionProducers(i.key(), i.value());
+        }
+    }
+    m_pendingTimelineProperties.clear();
 }
 
 void Bin::showSlideshowWidget(ProjectClip *clip)
@@ -38,6 +38,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QListView>
 #include <QFuture>
 #include <QMutex>
+#include <QTimer>
 #include <QLineEdit>
 #include <QDir>
 
@@ -350,6 +351,8 @@ public:
 
 private slots:
     void slotAddClip();
+    /** @brief Pass the pending clip properties to timeline producers. */
+    void slotUpdateTimelineProducers();
     void slotReloadClip();
     /** @brief Set sorting column */
     void slotSetSorting();
@@ -408,6 +411,8 @@ private slots:
      *  this is a workaround foq Qt bug 54676
      */
     void showClearButton(bool show);
+    /** @brief Ask the producer queue to process the clips visible in the view first */
+    void slotPrioritizeVisibleClips();
 
 public slots:
     void slotThumbnailReady(const QString &id, const QImage &img, bool fromFile = false);
@@ -545,6 +550,14 @@ private:
     long m_processedAudio;
     /** @brief Indicates whether audio thumbnail creation is running. */
     QFuture<void> m_audioThumbsThread;
+    /** @brief Delays the update of visible clips while scrolling. */
+    QTimer m_visibleClipsTimer;
+    /** @brief Properties waiting to be passed to timeline producers, indexed by clip id. */
+    QMap<QString, QMap<QString, QString> > m_pendingTimelineProperties;
+    /** @brief Collects the property changes of several clips (for example a group command) to update the timeline once. */
+    QTimer m_timelinePropertiesTimer;
+    /** @brief Append the ids of the clips visible in the view under @param parent. */
+    void visibleClipIds(const QModelIndex &parent, QStringList &ids) const;
     void showClipProperties(ProjectClip *clip, bool forceRefresh = false);
     /** @brief Get the QModelIndex value for an item in the Bin. */
     QModelIndex getIndexForId(const QString &id, bool folderWanted) const;
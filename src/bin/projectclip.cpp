@@ -33,6 +33,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "lib/audio/audioStreamInfo.h"
 #include "utils/KoIconUtils.h"
 #include "mltcontroller/clippropertiescontroller.h"
+#include "core.h"
+#include "project/cachemanager.h"
 
 #include <QDomElement>
 #include <QFile>
@@ -1304,7 +1306,9 @@ void ProjectClip::slotCreateAudioThumbs()
             }
             image.setPixel(i / channels, i % channels, p);
         }
-        image.save(audioPath);
+        if (image.save(audioPath)) {
+            pCore->cacheManager()->addFile(audioPath);
+        }
     }
     m_abortAudioThumb = false;
 }
@@ -12,6 +12,7 @@ the Free Software Foundation, either version 3 of the License, or
 #include "mainwindow.h"
 #include "kdenlivesettings.h"
 #include "project/projectmanager.h"
+#include "project/cachemanager.h"
 #include "monitor/monitormanager.h"
 #include "mltconnection.h"
 #include "profiles/profilerepository.hpp"
@@ -42,6 +43,7 @@ Core::Core() :
     , m_producerQueue(nullptr)
     , m_binWidget(nullptr)
     , m_library(nullptr)
+    , m_cacheManager(nullptr)
 {
     connect(qApp, &QCoreApplication::aboutToQuit, this, &QObject::deleteLater);
 }
@@ -50,6 +52,7 @@ Core::~Core()
 {
     m_monitorManager->stopActiveMonitor();
     delete m_producerQueue;
+    delete m_cacheManager;
     delete m_binWidget;
     delete m_projectManager;
     delete m_binController;
@@ -128,6 +131,8 @@ void Core::initialize(const QString &mltPath)
     }
 
     m_projectManager = new ProjectManager(this);
+    m_cacheManager = new CacheManager();
+    connect(m_projectManager, &ProjectManager::docOpened, m_cacheManager, &CacheManager::slotProjectOpened);
     m_binWidget = new Bin();
     m_binController = new BinController();
     m_library = new LibraryWidget(m_projectManager);
@@ -195,6 +200,11 @@ LibraryWidget *Core::library()
     return m_library;
 }
 
+CacheManager *Core::cacheManager()
+{
+    return m_cacheManager;
+}
+
 void Core::initLocale()
 {
     QLocale systemLocale = QLocale();
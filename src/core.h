@@ -23,6 +23,7 @@ class BinController;
 class Bin;
 class LibraryWidget;
 class ProducerQueue;
+class CacheManager;
 class MltConnection;
 
 namespace Mlt
@@ -82,6 +83,8 @@ public:
     ProducerQueue *producerQueue();
     /** @brief Returns a pointer to the library. */
     LibraryWidget *library();
+    /** @brief Returns a pointer to the cache manager. */
+    CacheManager *cacheManager();
 
     /** @brief Returns a pointer to MLT's repository */
     std::unique_ptr<Mlt::Repository>& getMltRepository();
@@ -103,6 +106,7 @@ private:
     ProducerQueue *m_producerQueue;
     Bin *m_binWidget;
     LibraryWidget *m_library;
+    CacheManager *m_cacheManager;
 
     std::unique_ptr<MltConnection> m_mltConnection;
 
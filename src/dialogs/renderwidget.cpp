@@ -248,6 +248,21 @@ RenderWidget::RenderWidget(const QString &projectfolder, bool enableProxy, const
     m_view.encoder_threads->setMaximum(QThread::idealThreadCount());
     m_view.encoder_threads->setValue(KdenliveSettings::encodethreads());
     connect(m_view.encoder_threads, SIGNAL(valueChanged(int)), this, SLOT(slotUpdateEncodeThreads(int)));
+    m_view.parallel_render->setChecked(KdenliveSettings::parallelrender());
+    m_view.thread_budget->setValue(KdenliveSettings::renderthreadbudget());
+    m_view.thread_budget->setEnabled(KdenliveSettings::parallelrender());
+    m_view.label_budget->setEnabled(KdenliveSettings::parallelrender());
+    m_view.thread_budget->setToolTip(i18n("Automatic uses the number of processor cores (%1)", QThread::idealThreadCount()));
+    connect(m_view.parallel_render, &QCheckBox::toggled, this, &RenderWidget::slotUpdateParallelRender);
+    m_view.parallel_export->setChecked(KdenliveSettings::parallelexport());
+    m_view.parallel_segments->setValue(KdenliveSettings::parallelsegments());
+    m_view.parallel_guides->setChecked(KdenliveSettings::parallelsplitguides());
+    m_view.parallel_segments->setEnabled(KdenliveSettings::parallelexport());
+    m_view.parallel_guides->setEnabled(KdenliveSettings::parallelexport());
+    connect(m_view.parallel_export, &QCheckBox::toggled, this, &RenderWidget::slotUpdateParallelExport);
+    connect(m_view.parallel_guides, &QCheckBox::toggled, this, &RenderWidget::slotUpdateParallelExport);
+    connect(m_view.parallel_segments, SIGNAL(valueChanged(int)), this, SLOT(slotUpdateParallelExport()));
+    connect(m_view.thread_budget, SIGNAL(valueChanged(int)), this, SLOT(slotUpdateThreadBudget(int)));
 
     m_view.rescale_keep->setChecked(KdenliveSettings::rescalekeepratio());
     connect(m_view.rescale_width, SIGNAL(valueChanged(int)), this, SLOT(slotUpdateRescaleWidth(int)));
@@ -1204,12 +1219,33 @@ void RenderWidget::slotExport(bool scriptExport, int zoneIn, int zoneOut,
         }
 
         // If there is an fps change, we need to use the producer consumer AND update the in/out points
+        double fpsRatio = 1;
         if (forcedfps > 0 && qAbs((int) 100 * forcedfps - ((int) 100 * profile->frame_rate_num() / profile->frame_rate_den())) > 2) {
             resizeProfile = true;
             double ratio = profile->frame_rate_num() / profile->frame_rate_den() / forcedfps;
             if (ratio > 0) {
                 zoneIn /= ratio;
                 zoneOut /= ratio;
+                fpsRatio = ratio;
+            }
+        }
+        // Parallel export, the renderer falls back to a single pass if the parameters don't allow it
+        if (m_view.parallel_export->isChecked() && !m_view.checkTwoPass->isChecked() && !imageSequences.contains(extension)) {
+            render_process_args << QStringLiteral("-parallel:%1").arg(m_view.parallel_segments->value());
+            if (m_view.parallel_guides->isChecked() && m_view.guide_start->count() > 1) {
+                // Guides are listed after the "Beginning" item, split positions use the same frame rate as the zone
+                double fps = profile->fps();
+                QStringList splits;
+                for (int ix = 1; ix < m_view.guide_start->count(); ++ix) {
+                    splits << QString::number((int) (GenTime(m_view.guide_start->itemData(ix).toDouble()).frames(fps) / fpsRatio));
+                }
+                render_process_args << QStringLiteral("-splits:") + splits.join(QLatin1Char(','));
+            }
+            if (!KdenliveSettings::ffmpegpath().isEmpty()) {
+                render_process_args << QStringLiteral("-ffmpeg:") + KdenliveSettings::ffmpegpath();
+            }
+            if (!KdenliveSettings::ffprobepath().isEmpty()) {
+                render_process_args << QStringLiteral("-ffprobe:") + KdenliveSettings::ffprobepath();
             }
         }
         if (m_view.render_guide->isChecked()) {
@@ -1486,32 +1522,100 @@ void RenderWidget::checkRenderStatus()
 
     RenderJobItem *item = static_cast<RenderJobItem *>(m_view.running_jobs->topLevelItem(0));
 
-    // Make sure no other rendering is running
+    // Count the threads used by running jobs
+    bool parallel = KdenliveSettings::parallelrender();
+    bool running = false;
+    int usedThreads = 0;
     while (item) {
-        if (item->status() == RUNNINGJOB) {
-            return;
+        if (item->status() == RUNNINGJOB || item->status() == STARTINGJOB) {
+            if (!parallel) {
+                // Make sure no other rendering is running
+                return;
+            }
+            running = true;
+            usedThreads += jobThreadCost(item);
         }
         item = static_cast<RenderJobItem *>(m_view.running_jobs->itemBelow(item));
     }
     item = static_cast<RenderJobItem *>(m_view.running_jobs->topLevelItem(0));
-    bool waitingJob = false;
+    const int budget = renderThreadBudget();
 
-    // Find first waiting job
+    // Start waiting jobs in queue order while they fit in the thread budget
     while (item) {
         if (item->status() == WAITINGJOB) {
+            int cost = jobThreadCost(item);
+            if (running && usedThreads + cost > budget) {
+                // Wait for a running job to finish, so that jobs are started in order
+                break;
+            }
             item->setData(1, TimeRole, QDateTime::currentDateTime());
-            waitingJob = true;
             startRendering(item);
+            if (item->status() == FAILEDJOB) {
+                item = static_cast<RenderJobItem *>(m_view.running_jobs->itemBelow(item));
+                continue;
+            }
             item->setStatus(STARTINGJOB);
-            break;
+            running = true;
+            usedThreads += cost;
+            if (!parallel) {
+                break;
+            }
         }
         item = static_cast<RenderJobItem *>(m_view.running_jobs->itemBelow(item));
     }
-    if (waitingJob == false && m_view.shutdown->isChecked()) {
+    if (!running && m_view.shutdown->isChecked()) {
         emit shutdown();
     }
 }
 
+int RenderWidget::jobThreadCost(RenderJobItem *item) const
+{
+    if (item->type() != DirectRenderType) {
+        // We don't know what a script does, let it use the whole budget
+        return renderThreadBudget();
+    }
+    // Encoder threads plus MLT processing threads, as passed to the renderer
+    int encodeThreads = 1;
+    int mltThreads = 1;
+    int segments = 1;
+    bool hasAudio = true;
+    bool hasVideo = true;
+    const QStringList args = item->data(1, ParametersRole).toStringList();
+    for (const QString &arg : args) {
+        if (arg.startsWith(QLatin1String("-parallel:"))) {
+            // Segments of a parallel export all run at the same time
+            segments = qMax(segments, arg.section(QLatin1Char(':'), 1).toInt());
+        } else if (arg.startsWith(QLatin1String("-splits:"))) {
+            // Guide splits replace the segment count
+            segments = arg.section(QLatin1Char(':'), 1).count(QLatin1Char(',')) + 2;
+        } else if (arg.startsWith(QLatin1String("threads="))) {
+            encodeThreads = qMax(1, arg.section(QLatin1Char('='), 1).toInt());
+        } else if (arg.startsWith(QLatin1String("real_time="))) {
+            mltThreads = qMax(1, qAbs(arg.section(QLatin1Char('='), 1).toInt()));
+        } else if (arg == QLatin1String("an=1")) {
+            hasAudio = false;
+        } else if (arg == QLatin1String("vn=1")) {
+            hasVideo = false;
+        }
+    }
+    if (segments < 2 || !hasVideo) {
+        // Rendered in one pass
+        return encodeThreads + mltThreads;
+    }
+    int cost = segments * (encodeThreads + mltThreads);
+    if (hasAudio) {
+        // Audio is rendered in a separate pass next to the video segments, its encoder uses a single thread
+        cost += 1 + mltThreads;
+    }
+    return cost;
+}
+
+int RenderWidget::renderThreadBudget() const
+{
+    int budget = KdenliveSettings::renderthreadbudget();
+    return budget > 0 ? budget : QThread::idealThreadCount();
+}
+
 void RenderWidget::startRendering(RenderJobItem *item)
 {
     if (item->type() == DirectRenderType) {
@@ -2223,6 +2327,22 @@ void RenderWidget::setRenderJob(const QString &dest, int progress)
         QString est = (days > 0) ? i18np("%1 day ", "%1 days ", days) : QString();
         est.append(when.toString(QStringLiteral("hh:mm:ss")));
         QString t = i18n("Remaining time %1", est);
+        // Compute the encoding speed from the rendered zone
+        int in = -1;
+        int out = -1;
+        const QStringList args = item->data(1, ParametersRole).toStringList();
+        for (const QString &arg : args) {
+            if (arg.startsWith(QLatin1String("in="))) {
+                in = arg.section(QLatin1Char('='), 1).toInt();
+            } else if (arg.startsWith(QLatin1String("out="))) {
+                out = arg.section(QLatin1Char('='), 1).toInt();
+            }
+        }
+        qint64 elapsedMs = startTime.msecsTo(QDateTime::currentDateTime());
+        if (in >= 0 && out > in && elapsedMs > 0) {
+            double fps = (out - in + 1) * progress / 100.0 / (elapsedMs / 1000.0);
+            t.append(QStringLiteral(" - ") + i18n("%1 fps", QString::number(fps, 'f', 1)));
+        }
         item->setData(1, Qt::UserRole, t);
     }
 }
@@ -2686,6 +2806,30 @@ void RenderWidget::slotUpdateEncodeThreads(int val)
     KdenliveSettings::setEncodethreads(val);
 }
 
+void RenderWidget::slotUpdateParallelRender(bool enable)
+{
+    KdenliveSettings::setParallelrender(enable);
+    m_view.thread_budget->setEnabled(enable);
+    m_view.label_budget->setEnabled(enable);
+    checkRenderStatus();
+}
+
+void RenderWidget::slotUpdateParallelExport()
+{
+    bool enable = m_view.parallel_export->isChecked();
+    KdenliveSettings::setParallelexport(enable);
+    KdenliveSettings::setParallelsegments(m_view.parallel_segments->value());
+    KdenliveSettings::setParallelsplitguides(m_view.parallel_guides->isChecked());
+    m_view.parallel_segments->setEnabled(enable);
+    m_view.parallel_guides->setEnabled(enable);
+}
+
+void RenderWidget::slotUpdateThreadBudget(int val)
+{
+    KdenliveSettings::setRenderthreadbudget(val);
+    checkRenderStatus();
+}
+
 void RenderWidget::slotUpdateRescaleWidth(int val)
 {
     KdenliveSettings::setDefaultrescalewidth(val);
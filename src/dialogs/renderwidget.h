@@ -187,6 +187,12 @@ private slots:
     void slotStartCurrentJob();
     void slotCopyToFavorites();
     void slotUpdateEncodeThreads(int);
+    /** @brief Enable / disable concurrent render jobs. */
+    void slotUpdateParallelRender(bool enable);
+    /** @brief The maximum number of threads used by concurrent render jobs changed. */
+    void slotUpdateThreadBudget(int val);
+    /** @brief Save the parallel export options. */
+    void slotUpdateParallelExport();
     void slotUpdateRescaleHeight(int);
     void slotUpdateRescaleWidth(int);
     void slotSwitchAspectRatio();
@@ -227,6 +233,10 @@ private:
     QUrl filenameWithExtension(QUrl url, const QString &extension);
     /** @brief Check if a job needs to be started. */
     void checkRenderStatus();
+    /** @brief Returns the number of threads a render job will use. */
+    int jobThreadCost(RenderJobItem *item) const;
+    /** @brief Returns the maximum number of threads concurrent render jobs may use. */
+    int renderThreadBudget() const;
     void startRendering(RenderJobItem *item);
     bool saveProfile(QDomElement newprofile);
     /** @brief Create a rendering profile from MLT preset. */
@@ -36,6 +36,12 @@
 #include <QFileDialog>
 #include <QCryptographicHash>
 #include <QStandardPaths>
+#include <QProgressDialog>
+#include <QtConcurrent>
+#include <QFutureWatcher>
+#include <QEventLoop>
+#include <QTimer>
+#include <QAtomicInt>
 
 const int hashRole = Qt::UserRole;
 const int sizeRole = Qt::UserRole + 1;
@@ -57,12 +63,187 @@ const int LUMAPLACEHOLDER = 12;
 
 enum TITLECLIPTYPE { TITLE_IMAGE_ELEMENT = 20, TITLE_FONT_ELEMENT = 21 };
 
-DocumentChecker::DocumentChecker(const QUrl &url, const QDomDocument &doc):
-    m_url(url), m_doc(doc), m_dialog(nullptr)
+/**
+ * @brief The files found in the folder chosen to search missing clips.
+ * Files are stored in the order of a depth first walk, files of a folder before its subfolders,
+ * so that the first match is the same as the one a recursive search would find.
+ */
+struct SearchIndex
 {
+    QStringList paths;
+    /** @brief Lower case file name to index of the first file with that name */
+    QHash<QString, int> byName;
+    /** @brief File size to indexes of the files with that size */
+    QHash<qint64, QVector<int> > bySize;
+    /** @brief Hash of the files whose size matched a missing clip */
+    QHash<QString, QString> hashes;
+
+    QString findName(const QString &fileName) const
+    {
+        int ix = byName.value(fileName.toLower(), -1);
+        return ix < 0 ? QString() : paths.at(ix);
+    }
+
+    /** @brief Find the folder of an image sequence, @param fileName is the sequence pattern, for example img_%05d.png */
+    QString findSequence(const QString &fileName) const
+    {
+        if (!fileName.contains(QLatin1Char('%'))) {
+            return QString();
+        }
+        const QString prefix = fileName.section(QLatin1Char('%'), 0, -2).toLower();
+        for (const QString &path : paths) {
+            QFileInfo info(path);
+            if (info.fileName().toLower().startsWith(prefix)) {
+                return info.absoluteDir().absoluteFilePath(fileName);
+            }
+        }
+        return QString();
+    }
+
+    /** @brief Find a file by size and hash, or by name if the clip has neither */
+    QString findFile(const QString &matchSize, const QString &matchHash, const QString &fileName) const
+    {
+        if (matchSize.isEmpty() && matchHash.isEmpty()) {
+            return findName(QUrl::fromLocalFile(fileName).fileName());
+        }
+        const QVector<int> candidates = bySize.value(matchSize.toLongLong());
+        for (int ix : candidates) {
+            const QString hash = hashes.value(paths.at(ix));
+            if (!hash.isEmpty() && hash == matchHash) {
+                return paths.at(ix);
+            }
+        }
+        return QString();
+    }
+};
+
+static void indexFolder(const QDir &dir, SearchIndex *index, QAtomicInt *fileCount, QAtomicInt *cancel)
+{
+    if (cancel->load()) {
+        return;
+    }
+    const QFileInfoList files = dir.entryInfoList(QDir::Files | QDir::Readable);
+    for (const QFileInfo &info : files) {
+        const int ix = index->paths.count();
+        index->paths << info.absoluteFilePath();
+        const QString name = info.fileName().toLower();
+        if (!index->byName.contains(name)) {
+            index->byName.insert(name, ix);
+        }
+        index->bySize[info.size()] << ix;
+    }
+    fileCount->fetchAndAddRelaxed(files.count());
+    const QStringList subFolders = dir.entryList(QDir::Dirs | QDir::Readable | QDir::Executable | QDir::NoDotAndDotDot);
+    for (const QString &folder : subFolders) {
+        indexFolder(QDir(dir.absoluteFilePath(folder)), index, fileCount, cancel);
+    }
 }
 
-bool DocumentChecker::hasErrorInClips()
+/** @brief Md5 of the first and last megabyte of a file, like kdenlive:file_hash */
+static QString fileHash(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    QByteArray fileData;
+    /*
+    * 1 MB = 1 second per 450 files (or faster)
+    * 10 MB = 9 seconds per 450 files (or faster)
+    */
+    if (file.size() > 1000000 * 2) {
+        fileData = file.read(1000000);
+        if (file.seek(file.size() - 1000000)) {
+            fileData.append(file.readAll());
+        }
+    } else {
+        fileData = file.readAll();
+    }
+    file.close();
+    return QString::fromLatin1(QCryptographicHash::hash(fileData, QCryptographicHash::Md5).toHex());
+}
+
+DocumentChecker::DocumentChecker(const QUrl &url, const QDomDocument &doc, const ProjectFiles &files):
+    m_url(url), m_doc(doc), m_dialog(nullptr), m_files(files)
+{
+}
+
+/** @brief Returns true if producers of @param service use files that must be checked. */
+static bool usesFiles(const QString &service)
+{
+    static const QStringList serviceToCheck { QStringLiteral("kdenlivetitle"), QStringLiteral("qimage"), QStringLiteral("pixbuf"), QStringLiteral("timewarp"), QStringLiteral("framebuffer"), QStringLiteral("xml") };
+    return service.startsWith(QLatin1String("avformat")) || serviceToCheck.contains(service);
+}
+
+QStringList DocumentChecker::usedFiles(const QUrl &url, const QDomDocument &doc)
+{
+    // Resolve paths like they will be after DocumentValidator and scanClips() fixed the project root
+    const QString projectFolder = url.adjusted(QUrl::RemoveFilename | QUrl::StripTrailingSlash).toLocalFile();
+    QString root = doc.documentElement().attribute(QStringLiteral("root"));
+    if (root.isEmpty() || root == QLatin1String("$CURRENTPATH") || !QDir(root).exists()) {
+        root = projectFolder;
+    }
+    root = QDir::cleanPath(root) + QDir::separator();
+    QSet<QString> files;
+    auto addFile = [&files, &root, &projectFolder](QString path) {
+        if (path.isEmpty()) {
+            return;
+        }
+        // Archived projects
+        path.replace(QLatin1String("$CURRENTPATH"), projectFolder);
+        if (QFileInfo(path).isRelative()) {
+            path.prepend(root);
+        }
+        files.insert(path);
+    };
+    QDomNodeList producers = doc.elementsByTagName(QStringLiteral("producer"));
+    for (int i = 0; i < producers.count(); ++i) {
+        QDomElement e = producers.item(i).toElement();
+        QString service = EffectsList::property(e, QStringLiteral("mlt_service"));
+        if (!usesFiles(service)) {
+            continue;
+        }
+        if (service == QLatin1String("kdenlivetitle")) {
+            foreach (const QString &image, TitleWidget::extractImageList(EffectsList::property(e, QStringLiteral("xmldata")))) {
+                files.insert(QString(image).replace(QLatin1String("$CURRENTPATH"), projectFolder));
+            }
+            continue;
+        }
+        QString resource = EffectsList::property(e, QStringLiteral("resource"));
+        if (service == QLatin1String("timewarp")) {
+            resource = EffectsList::property(e, QStringLiteral("warp_resource"));
+        } else if (service == QLatin1String("framebuffer")) {
+            resource = resource.section(QLatin1Char('?'), 0, 0);
+        }
+        addFile(resource);
+        QString proxy = EffectsList::property(e, QStringLiteral("kdenlive:proxy"));
+        if (proxy.length() > 1) {
+            addFile(proxy);
+            addFile(EffectsList::property(e, QStringLiteral("kdenlive:originalurl")));
+        }
+    }
+    QDomNodeList trans = doc.elementsByTagName(QStringLiteral("transition"));
+    for (int i = 0; i < trans.count(); ++i) {
+        QDomElement transition = trans.at(i).toElement();
+        QString service = EffectsList::property(transition, QStringLiteral("mlt_service"));
+        if (service == QLatin1String("luma")) {
+            addFile(EffectsList::property(transition, QStringLiteral("resource")));
+        } else if (service == QLatin1String("composite")) {
+            addFile(EffectsList::property(transition, QStringLiteral("luma")));
+        }
+    }
+    return files.toList();
+}
+
+bool DocumentChecker::fileExists(const QString &path) const
+{
+    if (m_files.checked.contains(path)) {
+        return m_files.existing.contains(path);
+    }
+    return QFile::exists(path);
+}
+
+bool DocumentChecker::scanClips()
 {
     int max;
     QDomElement baseElement = m_doc.documentElement();
@@ -81,6 +262,7 @@ bool DocumentChecker::hasErrorInClips()
             root = QDir::cleanPath(root) + QDir::separator();
         }
     }
+    m_root = root;
     // Check if strorage folder for temp files exists
     QString storageFolder;
     QDir projectDir(m_url.adjusted(QUrl::RemoveFilename).toLocalFile());
@@ -115,21 +297,19 @@ bool DocumentChecker::hasErrorInClips()
             hdProfile = false;
         }
     }
-    // List clips whose proxy is missing
-    QList<QDomElement> missingProxies;
-    // List clips who have a working proxy but no source clip
-    QList<QDomElement> missingSources;
+    m_missingClips.clear();
+    m_missingProxies.clear();
+    m_missingSources.clear();
+    m_missingLumas.clear();
     m_safeImages.clear();
     m_safeFonts.clear();
     m_missingFonts.clear();
     max = documentProducers.count();
     QStringList verifiedPaths;
-    QStringList serviceToCheck;
-    serviceToCheck << QStringLiteral("kdenlivetitle") << QStringLiteral("qimage") << QStringLiteral("pixbuf") << QStringLiteral("timewarp") << QStringLiteral("framebuffer") << QStringLiteral("xml");
     for (int i = 0; i < max; ++i) {
         QDomElement e = documentProducers.item(i).toElement();
         QString service = EffectsList::property(e, QStringLiteral("mlt_service"));
-        if (!service.startsWith(QLatin1String("avformat")) && !serviceToCheck.contains(service)) {
+        if (!usesFiles(service)) {
             continue;
         }
         if (service == QLatin1String("qtext")) {
@@ -171,7 +351,7 @@ bool DocumentChecker::hasErrorInClips()
             if (QFileInfo(proxy).isRelative()) {
                 proxy.prepend(root);
             }
-            if (!QFile::exists(proxy)) {
+            if (!fileExists(proxy)) {
                 // Missing clip found
                 // Check if proxy exists in current storage folder
                 bool fixed = false;
@@ -184,7 +364,7 @@ bool DocumentChecker::hasErrorInClips()
                     }
                 }
                 if (!fixed) {
-                    missingProxies.append(e);
+                    m_missingProxies.append(e);
                 }
             }
             QString original = EffectsList::property(e, QStringLiteral("kdenlive:originalurl"));
@@ -196,9 +376,9 @@ bool DocumentChecker::hasErrorInClips()
             if (slideshow && !EffectsList::property(e, QStringLiteral("ttl")).isEmpty()) {
                 original = QFileInfo(original).absolutePath();
             }
-            if (!QFile::exists(original)) {
+            if (!fileExists(original)) {
                 // clip has proxy but original clip is missing
-                missingSources.append(e);
+                m_missingSources.append(e);
             }
             verifiedPaths.append(resource);
             continue;
@@ -208,7 +388,7 @@ bool DocumentChecker::hasErrorInClips()
         if ((service == QLatin1String("qimage") || service == QLatin1String("pixbuf")) && slideshow) {
             resource = QFileInfo(resource).absolutePath();
         }
-        if (!QFile::exists(resource)) {
+        if (!fileExists(resource)) {
             // Missing clip found
             m_missingClips.append(e);
         }
@@ -217,7 +397,6 @@ bool DocumentChecker::hasErrorInClips()
     }
 
     // Get list of used Luma files
-    QStringList missingLumas;
     QStringList filesToCheck;
     QString filePath;
     QDomNodeList trans = m_doc.elementsByTagName(QStringLiteral("transition"));
@@ -244,7 +423,7 @@ bool DocumentChecker::hasErrorInClips()
         if (QFileInfo(filePath).isRelative()) {
             filePath.prepend(root);
         }
-        if (!QFile::exists(filePath)) {
+        if (!fileExists(filePath)) {
             QString lumaName = filePath.section(QLatin1Char('/'), -1);
             // check if this was an old format luma, not in correct folder
             QString fixedLuma = filePath.section(QLatin1Char('/'), 0, -2);
@@ -277,7 +456,7 @@ bool DocumentChecker::hasErrorInClips()
                 // Auto replace pgm with png for lumas
                 autoFixLuma.insert(filePath, fixedLuma);
             } else {
-                missingLumas.append(lumafile);
+                m_missingLumas.append(lumafile);
             }
         }
     }
@@ -296,21 +475,28 @@ bool DocumentChecker::hasErrorInClips()
             }
         }
     }
-    if (m_missingClips.isEmpty() && missingLumas.isEmpty() && missingProxies.isEmpty() && missingSources.isEmpty() && m_missingFonts.isEmpty()) {
+    return !m_missingClips.isEmpty() || !m_missingLumas.isEmpty() || !m_missingProxies.isEmpty() || !m_missingSources.isEmpty() || !m_missingFonts.isEmpty();
+}
+
+bool DocumentChecker::hasErrorInClips()
+{
+    if (!scanClips()) {
         return false;
     }
+    int max;
+    QDomNodeList documentProducers = m_doc.elementsByTagName(QStringLiteral("producer"));
 
     m_dialog = new QDialog();
     m_dialog->setFont(QFontDatabase::systemFont(QFontDatabase::SmallestReadableFont));
     m_ui.setupUi(m_dialog);
 
-    foreach (const QString &l, missingLumas) {
+    foreach (const QString &l, m_missingLumas) {
         QTreeWidgetItem *item = new QTreeWidgetItem(m_ui.treeWidget, QStringList() << i18n("Luma file") << l);
         item->setIcon(0, KoIconUtils::themedIcon(QStringLiteral("dialog-close")));
         item->setData(0, idRole, l);
         item->setData(0, statusRole, LUMAMISSING);
     }
-    m_ui.buttonBox->button(QDialogButtonBox::Ok)->setEnabled(m_missingClips.isEmpty() && missingProxies.isEmpty() && missingSources.isEmpty());
+    m_ui.buttonBox->button(QDialogButtonBox::Ok)->setEnabled(m_missingClips.isEmpty() && m_missingProxies.isEmpty() && m_missingSources.isEmpty());
     max = m_missingClips.count();
     m_missingProxyIds.clear();
     for (int i = 0; i < max; ++i) {
@@ -369,7 +555,7 @@ bool DocumentChecker::hasErrorInClips()
         } else {
             item->setIcon(0, KoIconUtils::themedIcon(QStringLiteral("dialog-close")));
             if (QFileInfo(resource).isRelative()) {
-                resource.prepend(root);
+                resource.prepend(m_root);
             }
             item->setData(0, hashRole, EffectsList::property(e, QStringLiteral("kdenlive:file_hash")));
             item->setData(0, sizeRole, EffectsList::property(e, QStringLiteral("kdenlive:file_size")));
@@ -401,25 +587,25 @@ bool DocumentChecker::hasErrorInClips()
     if (!m_missingClips.isEmpty()) {
         m_ui.infoLabel->setText(i18n("The project file contains missing clips or files"));
     }
-    if (!missingProxies.isEmpty()) {
+    if (!m_missingProxies.isEmpty()) {
         if (!m_ui.infoLabel->text().isEmpty()) {
             m_ui.infoLabel->setText(m_ui.infoLabel->text() + QStringLiteral(". "));
         }
         m_ui.infoLabel->setText(m_ui.infoLabel->text() + i18n("Missing proxies will be recreated after opening."));
     }
-    if (!missingSources.isEmpty()) {
+    if (!m_missingSources.isEmpty()) {
         if (!m_ui.infoLabel->text().isEmpty()) {
             m_ui.infoLabel->setText(m_ui.infoLabel->text() + QStringLiteral(". "));
         }
-        m_ui.infoLabel->setText(m_ui.infoLabel->text() + i18np("The project file contains a missing clip, you can still work with its proxy.", "The project file contains %1 missing clips, you can still work with their proxies.", missingSources.count()));
+        m_ui.infoLabel->setText(m_ui.infoLabel->text() + i18np("The project file contains a missing clip, you can still work with its proxy.", "The project file contains %1 missing clips, you can still work with their proxies.", m_missingSources.count()));
     }
 
     m_ui.removeSelected->setEnabled(!m_missingClips.isEmpty());
-    m_ui.recursiveSearch->setEnabled(!m_missingClips.isEmpty() || !missingLumas.isEmpty() || !missingSources.isEmpty());
+    m_ui.recursiveSearch->setEnabled(!m_missingClips.isEmpty() || !m_missingLumas.isEmpty() || !m_missingSources.isEmpty());
     m_ui.usePlaceholders->setEnabled(!m_missingClips.isEmpty());
 
     // Check missing proxies
-    max = missingProxies.count();
+    max = m_missingProxies.count();
     if (max > 0) {
         QTreeWidgetItem *item = new QTreeWidgetItem(m_ui.treeWidget, QStringList() << i18n("Proxy clip"));
         item->setIcon(0, KoIconUtils::themedIcon(QStringLiteral("dialog-warning")));
@@ -430,7 +616,7 @@ bool DocumentChecker::hasErrorInClips()
     }
 
     for (int i = 0; i < max; ++i) {
-        QDomElement e = missingProxies.at(i).toElement();
+        QDomElement e = m_missingProxies.at(i).toElement();
         QString realPath = EffectsList::property(e, QStringLiteral("kdenlive:originalurl"));
         QString id = e.attribute(QStringLiteral("id"));
         m_missingProxyIds << id;
@@ -473,7 +659,7 @@ bool DocumentChecker::hasErrorInClips()
     }
 
     // Check clips with available proxies but missing original source clips
-    max = missingSources.count();
+    max = m_missingSources.count();
     if (max > 0) {
         QTreeWidgetItem *item = new QTreeWidgetItem(m_ui.treeWidget, QStringList() << i18n("Source clip"));
         item->setIcon(0, KoIconUtils::themedIcon(QStringLiteral("dialog-warning")));
@@ -482,7 +668,7 @@ bool DocumentChecker::hasErrorInClips()
         item->setData(0, statusRole, SOURCEMISSING);
         item->setToolTip(0, i18n("Missing source clip"));
         for (int i = 0; i < max; ++i) {
-            QDomElement e = missingSources.at(i).toElement();
+            QDomElement e = m_missingSources.at(i).toElement();
             QString realPath = EffectsList::property(e, QStringLiteral("kdenlive:originalurl"));
             QString id = e.attribute(QStringLiteral("id"));
             // Tell Kdenlive the source is missing
@@ -560,14 +746,95 @@ void DocumentChecker::slotSearchClips()
     int ix = 0;
     bool fixed = false;
     m_ui.recursiveSearch->setChecked(true);
-    //TODO: make non modal
+
+    // Sizes of the files that can be matched by hash
+    QSet<qint64> matchSizes;
     QTreeWidgetItem *child = m_ui.treeWidget->topLevelItem(ix);
-    QDir searchDir(newpath);
+    while (child) {
+        int status = child->data(0, statusRole).toInt();
+        if (status == SOURCEMISSING) {
+            for (int j = 0; j < child->childCount(); ++j) {
+                QTreeWidgetItem *subchild = child->child(j);
+                if (!subchild->data(0, sizeRole).toString().isEmpty() && !subchild->data(0, hashRole).toString().isEmpty()) {
+                    matchSizes << subchild->data(0, sizeRole).toLongLong();
+                }
+            }
+        } else if (status == CLIPMISSING && (ClipType) child->data(0, clipTypeRole).toInt() != SlideShow) {
+            if (!child->data(0, sizeRole).toString().isEmpty() && !child->data(0, hashRole).toString().isEmpty()) {
+                matchSizes << child->data(0, sizeRole).toLongLong();
+            }
+        }
+        ix++;
+        child = m_ui.treeWidget->topLevelItem(ix);
+    }
+
+    // Walk the folder once in a worker thread
+    QProgressDialog progress(i18n("Scanning folders"), i18n("Cancel"), 0, 0, m_dialog);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(500);
+    QAtomicInt cancel(0);
+    QAtomicInt fileCount(0);
+    SearchIndex index;
+    QEventLoop loop;
+    connect(&progress, &QProgressDialog::canceled, &loop, [&cancel]() {
+        cancel.store(1);
+    });
+    QTimer refreshTimer;
+    refreshTimer.setInterval(200);
+    connect(&refreshTimer, &QTimer::timeout, &progress, [&progress, &fileCount]() {
+        progress.setLabelText(i18np("Scanning folders, %1 file found", "Scanning folders, %1 files found", fileCount.load()));
+    });
+    QFutureWatcher<void> walkWatcher;
+    connect(&walkWatcher, &QFutureWatcherBase::finished, &loop, &QEventLoop::quit);
+    walkWatcher.setFuture(QtConcurrent::run(indexFolder, QDir(newpath), &index, &fileCount, &cancel));
+    refreshTimer.start();
+    if (!walkWatcher.isFinished()) {
+        loop.exec();
+    }
+    refreshTimer.stop();
+
+    // Hash the files whose size matches a missing clip, concurrently
+    QStringList candidates;
+    for (qint64 size : matchSizes) {
+        const QVector<int> files = index.bySize.value(size);
+        for (int fileIndex : files) {
+            candidates << index.paths.at(fileIndex);
+        }
+    }
+    if (!cancel.load() && !candidates.isEmpty()) {
+        progress.setLabelText(i18np("Comparing %1 file", "Comparing %1 files", candidates.count()));
+        progress.setRange(0, candidates.count());
+        QFutureWatcher<QString> hashWatcher;
+        connect(&hashWatcher, &QFutureWatcherBase::progressValueChanged, &progress, &QProgressDialog::setValue);
+        connect(&hashWatcher, &QFutureWatcherBase::finished, &loop, &QEventLoop::quit);
+        connect(&progress, &QProgressDialog::canceled, &hashWatcher, &QFutureWatcherBase::cancel);
+        hashWatcher.setFuture(QtConcurrent::mapped(candidates, fileHash));
+        if (!hashWatcher.isFinished()) {
+            loop.exec();
+        }
+        if (hashWatcher.isCanceled()) {
+            cancel.store(1);
+        } else {
+            for (int i = 0; i < candidates.count(); ++i) {
+                index.hashes.insert(candidates.at(i), hashWatcher.resultAt(i));
+            }
+        }
+    }
+    progress.reset();
+    if (cancel.load()) {
+        m_ui.recursiveSearch->setChecked(false);
+        m_ui.recursiveSearch->setEnabled(true);
+        return;
+    }
+
+    // Resolve all missing items from the index
+    ix = 0;
+    child = m_ui.treeWidget->topLevelItem(ix);
     while (child) {
         if (child->data(0, statusRole).toInt() == SOURCEMISSING) {
             for (int j = 0; j < child->childCount(); ++j) {
                 QTreeWidgetItem *subchild = child->child(j);
-                QString clipPath = searchFileRecursively(searchDir, subchild->data(0, sizeRole).toString(), subchild->data(0, hashRole).toString(), subchild->text(1));
+                QString clipPath = index.findFile(subchild->data(0, sizeRole).toString(), subchild->data(0, hashRole).toString(), subchild->text(1));
                 if (!clipPath.isEmpty()) {
                     fixed = true;
                     subchild->setText(1, clipPath);
@@ -581,10 +848,11 @@ void DocumentChecker::slotSearchClips()
             QString clipPath;
             if (type != SlideShow) {
                 // Slideshows cannot be found with hash / size
-                clipPath = searchFileRecursively(searchDir, child->data(0, sizeRole).toString(), child->data(0, hashRole).toString(), child->text(1));
+                clipPath = index.findFile(child->data(0, sizeRole).toString(), child->data(0, hashRole).toString(), child->text(1));
             }
             if (clipPath.isEmpty()) {
-                clipPath = searchPathRecursively(searchDir, QUrl::fromLocalFile(child->text(1)).fileName(), type);
+                const QString fileName = QUrl::fromLocalFile(child->text(1)).fileName();
+                clipPath = type == SlideShow ? index.findSequence(fileName) : index.findName(fileName);
                 perfectMatch = false;
             }
             if (!clipPath.isEmpty()) {
@@ -594,7 +862,7 @@ void DocumentChecker::slotSearchClips()
                 child->setData(0, statusRole, CLIPOK);
             }
         } else if (child->data(0, statusRole).toInt() == LUMAMISSING) {
-            QString fileName = searchLuma(searchDir, child->data(0, idRole).toString());
+            QString fileName = searchLuma(index, child->data(0, idRole).toString());
             if (!fileName.isEmpty()) {
                 fixed = true;
                 child->setText(1, fileName);
@@ -604,7 +872,7 @@ void DocumentChecker::slotSearchClips()
         } else if (child->data(0, typeRole).toInt() == TITLE_IMAGE_ELEMENT && child->data(0, statusRole).toInt() == CLIPPLACEHOLDER) {
             // Search missing title images
             QString missingFileName = QUrl::fromLocalFile(child->text(1)).fileName();
-            QString newPath = searchPathRecursively(searchDir, missingFileName);
+            QString newPath = index.findName(missingFileName);
             if (!newPath.isEmpty()) {
                 // File found
                 fixed = true;
@@ -625,7 +893,7 @@ void DocumentChecker::slotSearchClips()
     checkStatus();
 }
 
-QString DocumentChecker::searchLuma(const QDir &dir, const QString &file) const
+QString DocumentChecker::searchLuma(const SearchIndex &index, const QString &file) const
 {
     QDir searchPath(KdenliveSettings::mltpath());
     QString fname = QUrl::fromLocalFile(file).fileName();
@@ -655,85 +923,7 @@ QString DocumentChecker::searchLuma(const QDir &dir, const QString &file) const
         return res;
     }
     // Try in user's chosen folder
-    return searchPathRecursively(dir, fname);
-}
-
-QString DocumentChecker::searchPathRecursively(const QDir &dir, const QString &fileName, ClipType type) const
-{
-    QString foundFileName;
-    QStringList filters;
-    if (type == SlideShow) {
-        if (fileName.contains(QLatin1Char('%'))) {
-            filters << fileName.section(QLatin1Char('%'), 0, -2) + QLatin1Char('*');
-        } else {
-            return QString();
-        }
-    } else {
-        filters << fileName;
-    }
-    QDir searchDir(dir);
-    searchDir.setNameFilters(filters);
-    QStringList filesAndDirs = searchDir.entryList(QDir::Files | QDir::Readable);
-    if (!filesAndDirs.isEmpty()) {
-        // File Found
-        if (type == SlideShow) {
-            return searchDir.absoluteFilePath(fileName);
-        }
-        return searchDir.absoluteFilePath(filesAndDirs.at(0));
-    }
-    searchDir.setNameFilters(QStringList());
-    filesAndDirs = searchDir.entryList(QDir::Dirs | QDir::Readable | QDir::Executable | QDir::NoDotAndDotDot);
-    for (int i = 0; i < filesAndDirs.size() && foundFileName.isEmpty(); ++i) {
-        foundFileName = searchPathRecursively(searchDir.absoluteFilePath(filesAndDirs.at(i)), fileName, type);
-        if (!foundFileName.isEmpty()) {
-            break;
-        }
-    }
-    return foundFileName;
-}
-
-QString DocumentChecker::searchFileRecursively(const QDir &dir, const QString &matchSize, const QString &matchHash, const QString &fileName) const
-{
-    if (matchSize.isEmpty() && matchHash.isEmpty()) {
-        return searchPathRecursively(dir, QUrl::fromLocalFile(fileName).fileName());
-    }
-    QString foundFileName;
-    QByteArray fileData;
-    QByteArray fileHash;
-    QStringList filesAndDirs = dir.entryList(QDir::Files | QDir::Readable);
-    for (int i = 0; i < filesAndDirs.size() && foundFileName.isEmpty(); ++i) {
-        QFile file(dir.absoluteFilePath(filesAndDirs.at(i)));
-        if (QString::number(file.size()) == matchSize) {
-            if (file.open(QIODevice::ReadOnly)) {
-                /*
-                * 1 MB = 1 second per 450 files (or faster)
-                * 10 MB = 9 seconds per 450 files (or faster)
-                */
-                if (file.size() > 1000000 * 2) {
-                    fileData = file.read(1000000);
-                    if (file.seek(file.size() - 1000000)) {
-                        fileData.append(file.readAll());
-                    }
-                } else {
-                    fileData = file.readAll();
-                }
-                file.close();
-                fileHash = QCryptographicHash::hash(fileData, QCryptographicHash::Md5);
-                if (QString::fromLatin1(fileHash.toHex()) == matchHash) {
-                    return file.fileName();
-                }
-            }
-        }
-        ////qCDebug(KDENLIVE_LOG) << filesAndDirs.at(i) << file.size() << fileHash.toHex();
-    }
-    filesAndDirs = dir.entryList(QDir::Dirs | QDir::Readable | QDir::Executable | QDir::NoDotAndDotDot);
-    for (int i = 0; i < filesAndDirs.size() && foundFileName.isEmpty(); ++i) {
-        foundFileName = searchFileRecursively(dir.absoluteFilePath(filesAndDirs.at(i)), matchSize, matchHash, fileName);
-        if (!foundFileName.isEmpty()) {
-            break;
-        }
-    }
-    return foundFileName;
+    return index.findName(fname);
 }
 
 void DocumentChecker::slotEditItem(QTreeWidgetItem *item, int)
@@ -1091,7 +1281,7 @@ void DocumentChecker::checkMissingImagesAndFonts(const QStringList &images, cons
         if (m_safeImages.contains(img)) {
             continue;
         }
-        if (!QFile::exists(img)) {
+        if (!fileExists(img)) {
             QDomElement e = doc.createElement(QStringLiteral("missingtitle"));
             e.setAttribute(QStringLiteral("type"), TITLE_IMAGE_ELEMENT);
             e.setAttribute(QStringLiteral("resource"), img);
@@ -26,13 +26,25 @@
 #include <QDir>
 #include <QUrl>
 #include <QDomElement>
+#include <QSet>
+
+struct SearchIndex;
+
+/** @brief Existence of the files used by a project, looked up by DocumentLoader in a worker thread */
+struct ProjectFiles
+{
+    /** @brief Files whose existence was checked */
+    QSet<QString> checked;
+    /** @brief Checked files that exist */
+    QSet<QString> existing;
+};
 
 class DocumentChecker: public QObject
 {
     Q_OBJECT
 
 public:
-    explicit DocumentChecker(const QUrl &url, const QDomDocument &doc);
+    explicit DocumentChecker(const QUrl &url, const QDomDocument &doc, const ProjectFiles &files = ProjectFiles());
     ~DocumentChecker();
     /**
      * @brief checks for problems with the clips in the project
@@ -42,6 +54,8 @@ public:
      * @return
      */
     bool hasErrorInClips();
+    /** @brief Returns the files used by the clips and transitions of @param doc, without modifying it so that it can run in a worker thread. */
+    static QStringList usedFiles(const QUrl &url, const QDomDocument &doc);
 
 private slots:
     void acceptDialog();
@@ -51,7 +65,7 @@ private slots:
     void slotDeleteSelected();
     QString getProperty(const QDomElement &effect, const QString &name);
     void setProperty(const QDomElement &effect, const QString &name, const QString &value);
-    QString searchLuma(const QDir &dir, const QString &file) const;
+    QString searchLuma(const SearchIndex &index, const QString &file) const;
     /** @brief Check if images and fonts in this clip exists, returns a list of images that do exist so we don't check twice. */
     void checkMissingImagesAndFonts(const QStringList &images, const QStringList &fonts, const QString &id, const QString &baseClip);
     void slotCheckButtons();
@@ -62,8 +76,6 @@ private:
     Ui::MissingClips_UI m_ui;
     QDialog *m_dialog;
     QPair <QString, QString>m_rootReplacement;
-    QString searchPathRecursively(const QDir &dir, const QString &fileName, ClipType type = Unknown) const;
-    QString searchFileRecursively(const QDir &dir, const QString &matchSize, const QString &matchHash, const QString &fileName) const;
     void checkStatus();
     QMap<QString, QString> m_missingTitleImages;
     QMap<QString, QString> m_missingTitleFonts;
@@ -76,6 +88,18 @@ private:
     void fixClipItem(QTreeWidgetItem *child, const QDomNodeList &producers, const QDomNodeList &trans);
     void fixSourceClipItem(QTreeWidgetItem *child, const QDomNodeList &producers);
     void fixProxyClip(const QString &id, const QString &oldUrl, const QString &newUrl, const QDomNodeList &producers);
+    /** @brief Looks for missing files without any user interaction, returns true if problems were found. */
+    bool scanClips();
+    /** @brief Returns true if @param path exists, using the files looked up by DocumentLoader if it checked this path. */
+    bool fileExists(const QString &path) const;
+    ProjectFiles m_files;
+    /** @brief Project root, with a trailing separator */
+    QString m_root;
+    QStringList m_missingLumas;
+    /** @brief Clips whose proxy is missing */
+    QList<QDomElement> m_missingProxies;
+    /** @brief Clips who have a working proxy but no source clip */
+    QList<QDomElement> m_missingSources;
 };
 
 #endif
@@ -0,0 +1,144 @@
+/*
+Copyright (C) 2018  Jean-Baptiste Mardelle <jb@kdenlive.org>
+This file is part of Kdenlive. See www.kdenlive.org.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "documentloader.h"
+#include "documentvalidator.h"
+
+#include <klocalizedstring.h>
+
+#include <QFile>
+#include <QDomImplementation>
+#include <QtConcurrent>
+
+DocumentLoader::DocumentLoader(const QUrl &url, QObject *parent) : QObject(parent)
+    , m_url(url)
+    , m_status(ReadError)
+    , m_errorLine(0)
+    , m_errorColumn(0)
+    , m_usesMovit(false)
+{
+    connect(&m_watcher, &QFutureWatcherBase::finished, this, &DocumentLoader::finished);
+}
+
+DocumentLoader::~DocumentLoader()
+{
+    m_watcher.waitForFinished();
+}
+
+void DocumentLoader::start()
+{
+    // Global parser setting, only changed from the GUI thread
+    QDomImplementation::setInvalidDataPolicy(QDomImplementation::DropInvalidChars);
+    m_watcher.setFuture(QtConcurrent::run(this, &DocumentLoader::load));
+}
+
+void DocumentLoader::load()
+{
+    QFile file(m_url.toLocalFile());
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        m_status = ReadError;
+        return;
+    }
+    // Read by blocks to report progress, the project may be on a slow drive
+    const qint64 size = qMax(file.size(), (qint64) 1);
+    QByteArray data;
+    data.reserve(size);
+    emit progress(i18n("Loading project"), 0);
+    while (!file.atEnd()) {
+        const QByteArray block = file.read(1048576);
+        if (block.isEmpty()) {
+            break;
+        }
+        data.append(block);
+        emit progress(i18n("Loading project"), qMin(100, (int)(100 * data.size() / size)));
+    }
+    file.close();
+    m_usesMovit = data.contains("movit.");
+
+    emit progress(i18n("Parsing project"), -1);
+    if (!m_document.setContent(data, false, &m_errorMessage, &m_errorLine, &m_errorColumn)) {
+        m_status = ParseError;
+        return;
+    }
+    data.clear();
+    if (!DocumentValidator(m_document, m_url).isProject()) {
+        m_status = NotProject;
+        return;
+    }
+    lookupFiles();
+    m_status = Loaded;
+}
+
+void DocumentLoader::lookupFiles()
+{
+    emit progress(i18n("Check missing clips"), 0);
+    const QStringList paths = DocumentChecker::usedFiles(m_url, m_document);
+    // Checking files can be slow on network shares, check them in parallel
+    const int blockSize = qMax(50, paths.count() / 20);
+    for (int i = 0; i < paths.count(); i += blockSize) {
+        const QStringList existing = QtConcurrent::blockingFiltered(paths.mid(i, blockSize), [](const QString &path) {
+            return QFile::exists(path);
+        });
+        m_files.existing.unite(existing.toSet());
+        emit progress(i18n("Check missing clips"), 100 * qMin(i + blockSize, paths.count()) / paths.count());
+    }
+    m_files.checked = paths.toSet();
+}
+
+QUrl DocumentLoader::url() const
+{
+    return m_url;
+}
+
+DocumentLoader::Status DocumentLoader::status() const
+{
+    return m_status;
+}
+
+QDomDocument DocumentLoader::document() const
+{
+    return m_document;
+}
+
+QString DocumentLoader::errorMessage() const
+{
+    return m_errorMessage;
+}
+
+int DocumentLoader::errorLine() const
+{
+    return m_errorLine;
+}
+
+int DocumentLoader::errorColumn() const
+{
+    return m_errorColumn;
+}
+
+bool DocumentLoader::usesMovit() const
+{
+    return m_usesMovit;
+}
+
+ProjectFiles DocumentLoader::files() const
+{
+    return m_files;
+}
@@ -0,0 +1,82 @@
+/*
+Copyright (C) 2018  Jean-Baptiste Mardelle <jb@kdenlive.org>
+This file is part of Kdenlive. See www.kdenlive.org.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DOCUMENTLOADER_H
+#define DOCUMENTLOADER_H
+
+#include "documentchecker.h"
+
+#include <QObject>
+#include <QUrl>
+#include <QDomDocument>
+#include <QFutureWatcher>
+
+/**
+ * @class DocumentLoader
+ * @brief Reads, parses and checks a project file in a worker thread.
+ * Nothing that needs the GUI thread or the user is done here: the result is handed to KdenliveDoc,
+ * which upgrades the document and reports problems once finished() was emitted.
+ */
+class DocumentLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Status { ReadError, ParseError, NotProject, Loaded };
+    explicit DocumentLoader(const QUrl &url, QObject *parent = nullptr);
+    ~DocumentLoader();
+    /** @brief Start loading in a worker thread, finished() is emitted in the GUI thread when done. */
+    void start();
+    QUrl url() const;
+    Status status() const;
+    /** @brief The parsed document, empty on ReadError and ParseError. */
+    QDomDocument document() const;
+    /** @brief The parser error message and position on ParseError. */
+    QString errorMessage() const;
+    int errorLine() const;
+    int errorColumn() const;
+    /** @brief True if the project uses Movit (GPU) effects. */
+    bool usesMovit() const;
+    /** @brief Existence of the files used by the project, for DocumentChecker. */
+    ProjectFiles files() const;
+
+private:
+    QUrl m_url;
+    Status m_status;
+    QDomDocument m_document;
+    QString m_errorMessage;
+    int m_errorLine;
+    int m_errorColumn;
+    bool m_usesMovit;
+    ProjectFiles m_files;
+    QFutureWatcher<void> m_watcher;
+    /** @brief Runs in the worker thread. */
+    void load();
+    /** @brief Checks the existence of the files used by the project, by blocks to report progress. */
+    void lookupFiles();
+
+signals:
+    /** @brief Emitted from the worker thread, @param percent is -1 for steps without measurable progress. */
+    void progress(const QString &message, int percent);
+    void finished();
+};
+
+#endif
@@ -19,6 +19,7 @@
 
 #include "kdenlivedoc.h"
 #include "documentchecker.h"
+#include "documentloader.h"
 #include "documentvalidator.h"
 #include "mltcontroller/clipcontroller.h"
 #include "mltcontroller/producerqueue.h"
@@ -32,6 +33,7 @@
 #include "effectslist/initeffects.h"
 #include "dialogs/profilesdialog.h"
 #include "titler/titlewidget.h"
+#include "titler/titlecache.h"
 #include "project/notesplugin.h"
 #include "project/dialogs/noteswidget.h"
 #include "core.h"
@@ -53,7 +55,6 @@
 #include <QFile>
 #include "kdenlive_debug.h"
 #include <QFileDialog>
-#include <QDomImplementation>
 #include <QUndoGroup>
 #include <QTimer>
 #include <QUndoStack>
@@ -82,10 +83,10 @@ void DocUndoStack::push(QUndoCommand *cmd)
 
 const double DOCUMENTVERSION = 0.96;
 
-KdenliveDoc::KdenliveDoc(const QUrl &url, const QString &projectFolder, QUndoGroup *undoGroup, const QString &profileName, const QMap<QString, QString> &properties, const QMap<QString, QString> &metadata, const QPoint &tracks, Render *render, NotesPlugin *notes, bool *openBackup, MainWindow *parent) :
+KdenliveDoc::KdenliveDoc(const DocumentLoader *loader, const QString &projectFolder, QUndoGroup *undoGroup, const QString &profileName, const QMap<QString, QString> &properties, const QMap<QString, QString> &metadata, const QPoint &tracks, Render *render, NotesPlugin *notes, bool *openBackup, MainWindow *parent) :
     QObject(parent),
     m_autosave(nullptr),
-    m_url(url),
+    m_url(loader ? loader->url() : QUrl()),
     m_width(0),
     m_height(0),
     m_render(render),
@@ -158,9 +159,8 @@ KdenliveDoc::KdenliveDoc(const QUrl &url, const QString &projectFolder, QUndoGro
         initEffects::parseEffectFiles(pCore->getMltRepository(), QString::fromLatin1(setlocale(LC_NUMERIC, nullptr)));
     }
     *openBackup = false;
-    if (url.isValid()) {
-        QFile file(url.toLocalFile());
-        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    if (loader) {
+        if (loader->status() == DocumentLoader::ReadError) {
             // The file cannot be opened
             if (KMessageBox::warningContinueCancel(parent, i18n("Cannot open the project file,\nDo you want to open a backup file?"), i18n("Error opening file"), KGuiItem(i18n("Open Backup"))) == KMessageBox::Continue) {
                 *openBackup = true;
@@ -168,12 +168,12 @@ KdenliveDoc::KdenliveDoc(const QUrl &url, const QString &projectFolder, QUndoGro
             //KMessageBox::error(parent, KIO::NetAccess::lastErrorString());
         } else {
             qCDebug(KDENLIVE_LOG) << " // / processing file open";
-            QString errorMsg;
-            int line;
-            int col;
-            QDomImplementation::setInvalidDataPolicy(QDomImplementation::DropInvalidChars);
-            success = m_document.setContent(&file, false, &errorMsg, &line, &col);
-            file.close();
+            // The file was read, parsed and its clips looked up in a worker thread
+            QString errorMsg = loader->errorMessage();
+            int line = loader->errorLine();
+            int col = loader->errorColumn();
+            m_document = loader->document();
+            success = loader->status() != DocumentLoader::ParseError;
 
             if (!success) {
                 // It is corrupted
@@ -182,6 +182,7 @@ KdenliveDoc::KdenliveDoc(const QUrl &url, const QString &projectFolder, QUndoGro
                     *openBackup = true;
                 } else if (answer == KMessageBox::No) {
                     // Try to recover broken file produced by Kdenlive 0.9.4
+                    QFile file(m_url.toLocalFile());
                     if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
                         int correction = 0;
                         QString playlist = QString::fromUtf8(file.readAll());
@@ -214,10 +215,8 @@ KdenliveDoc::KdenliveDoc(const QUrl &url, const QString &projectFolder, QUndoGro
                 }
             } else {
                 qCDebug(KDENLIVE_LOG) << " // / processing file open: validate";
-                parent->slotGotProgressInfo(i18n("Validating"), 100);
-                qApp->processEvents();
-                DocumentValidator validator(m_document, url);
-                success = validator.isProject();
+                DocumentValidator validator(m_document, m_url);
+                success = loader->status() != DocumentLoader::NotProject;
                 if (!success) {
                     // It is not a project file
                     parent->slotGotProgressInfo(i18n("File %1 is not a Kdenlive project file", m_url.toLocalFile()), 100);
@@ -231,14 +230,13 @@ KdenliveDoc::KdenliveDoc(const QUrl &url, const QString &projectFolder, QUndoGro
                      */
                     // TODO: backup the document or alert the user?
                     success = validator.validate(DOCUMENTVERSION);
-                    if (success && !KdenliveSettings::gpu_accel()) {
+                    if (success && !KdenliveSettings::gpu_accel() && loader->usesMovit()) {
                         success = validator.checkMovit();
                     }
                     if (success) { // Let the validator handle error messages
                         qCDebug(KDENLIVE_LOG) << " // / processing file validate ok";
-                        parent->slotGotProgressInfo(i18n("Check missing clips"), 100);
-                        qApp->processEvents();
-                        DocumentChecker d(m_url, m_document);
+                        // Files were looked up by the loader, only document fixes and font checks are done here
+                        DocumentChecker d(m_url, m_document, loader->files());
                         success = !d.hasErrorInClips();
                         if (success) {
                             loadDocumentProperties();
@@ -319,7 +317,7 @@ int KdenliveDoc::setSceneList()
     //m_render->resetProfile(m_profile);
     pCore->bin()->isLoading = true;
     pCore->producerQueue()->abortOperations();
-    if (m_render->setSceneList(m_document.toString(), m_documentProperties.value(QStringLiteral("position")).toInt()) == -1) {
+    if (m_render->setSceneList(m_document, m_documentProperties.value(QStringLiteral("position")).toInt()) == -1) {
         // INVALID MLT Consumer, something is wrong
         return -1;
     }
@@ -623,6 +621,25 @@ QDomDocument KdenliveDoc::xmlSceneList(const QString &scene)
             }
         }
     }
+    // Automatic track transitions are restricted to the clips while editing, store them always active
+    QDomNodeList transitions = mlt.elementsByTagName(QStringLiteral("transition"));
+    for (int i = transitions.count() - 1; i >= 0; --i) {
+        QDomElement transition = transitions.at(i).toElement();
+        if (EffectsList::property(transition, QStringLiteral("internal_added")) != QLatin1String("237")) {
+            continue;
+        }
+        if (EffectsList::property(transition, QStringLiteral("kdenlive:content_segment")) == QLatin1String("1")) {
+            transition.parentNode().removeChild(transition);
+            continue;
+        }
+        transition.removeAttribute(QStringLiteral("in"));
+        transition.removeAttribute(QStringLiteral("out"));
+        EffectsList::setProperty(transition, QStringLiteral("always_active"), QStringLiteral("1"));
+        if (EffectsList::property(transition, QStringLiteral("empty_disable")) == QLatin1String("1")) {
+            EffectsList::removeProperty(transition, QStringLiteral("empty_disable"));
+            EffectsList::removeProperty(transition, QStringLiteral("disable"));
+        }
+    }
     QDomNodeList pls = mlt.elementsByTagName(QStringLiteral("playlist"));
     QDomElement mainPlaylist;
     for (int i = 0; i < pls.count(); ++i) {
@@ -1756,6 +1773,7 @@ void KdenliveDoc::saveMltPlaylist(const QString &fileName)
 
 void KdenliveDoc::initCacheDirs()
 {
+    TitleCache::setCacheFolder(QString());
     bool ok = false;
     QString kdenliveCacheDir;
     QString documentId = QDir::cleanPath(getDocumentProperty(QStringLiteral("documentid")));
@@ -1774,6 +1792,8 @@ void KdenliveDoc::initCacheDirs()
     dir.mkdir(QStringLiteral("preview"));
     dir.mkdir(QStringLiteral("audiothumbs"));
     dir.mkdir(QStringLiteral("videothumbs"));
+    dir.mkdir(QStringLiteral("titles"));
+    TitleCache::setCacheFolder(dir.absoluteFilePath(QStringLiteral("titles")));
     QDir cacheDir(kdenliveCacheDir);
     cacheDir.mkdir(QStringLiteral("proxy"));
 }
@@ -1814,6 +1834,9 @@ QDir KdenliveDoc::getCacheDir(CacheType type, bool *ok) const
     case CacheThumbs:
         basePath.append(QStringLiteral("/videothumbs"));
         break;
+    case CacheTitles:
+        basePath.append(QStringLiteral("/titles"));
+        break;
     default:
         break;
     }
@@ -50,6 +50,7 @@ class TrackInfo;
 class NotesPlugin;
 class ProjectClip;
 class ClipController;
+class DocumentLoader;
 
 class QTextEdit;
 class QUndoGroup;
@@ -75,8 +76,8 @@ class KdenliveDoc: public QObject
 {
     Q_OBJECT
 public:
-
-    KdenliveDoc(const QUrl &url, const QString &projectFolder, QUndoGroup *undoGroup, const QString &profileName, const QMap<QString, QString> &properties, const QMap<QString, QString> &metadata, const QPoint &tracks, Render *render, NotesPlugin *notes, bool *openBackup, MainWindow *parent = nullptr);
+    /** @brief Creates a new project, or the one read by @param loader once it finished. */
+    KdenliveDoc(const DocumentLoader *loader, const QString &projectFolder, QUndoGroup *undoGroup, const QString &profileName, const QMap<QString, QString> &properties, const QMap<QString, QString> &metadata, const QPoint &tracks, Render *render, NotesPlugin *notes, bool *openBackup, MainWindow *parent = nullptr);
     ~KdenliveDoc();
     QDomNodeList producersList();
     double fps() const;
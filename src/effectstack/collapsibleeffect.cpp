@@ -50,6 +50,8 @@ CollapsibleEffect::CollapsibleEffect(const QDomElement &effect, const QDomElemen
     m_paramWidget(nullptr),
     m_effect(effect),
     m_itemInfo(info),
+    m_metaInfo(metaInfo),
+    m_syncPos(0),
     m_original_effect(original_effect),
     m_isMovable(true),
     m_animation(nullptr),
@@ -170,18 +172,6 @@ CollapsibleEffect::CollapsibleEffect(const QDomElement &effect, const QDomElemen
     connect(buttonDown, &QAbstractButton::clicked, this, &CollapsibleEffect::slotEffectDown);
     connect(buttonDel, &QAbstractButton::clicked, this, &CollapsibleEffect::slotDeleteEffect);
 
-    Q_FOREACH (QSpinBox *sp, findChildren<QSpinBox *>()) {
-        sp->installEventFilter(this);
-        sp->setFocusPolicy(Qt::StrongFocus);
-    }
-    Q_FOREACH (KComboBox *cb, findChildren<KComboBox *>()) {
-        cb->installEventFilter(this);
-        cb->setFocusPolicy(Qt::StrongFocus);
-    }
-    Q_FOREACH (QProgressBar *cb, findChildren<QProgressBar *>()) {
-        cb->installEventFilter(this);
-        cb->setFocusPolicy(Qt::StrongFocus);
-    }
     m_animation = new QTimeLine(200, this); //duration matches to match kmessagewidget
     connect(m_animation, &QTimeLine::valueChanged, this, &CollapsibleEffect::setWidgetHeight);
     connect(m_animation, &QTimeLine::stateChanged, this, [this](QTimeLine::State state) {
@@ -202,7 +192,25 @@ CollapsibleEffect::~CollapsibleEffect()
 
 void CollapsibleEffect::setWidgetHeight(qreal value)
 {
-    widgetFrame->setFixedHeight(m_paramWidget->contentHeight() * value);
+    if (m_paramWidget) {
+        widgetFrame->setFixedHeight(m_paramWidget->contentHeight() * value);
+    }
+}
+
+void CollapsibleEffect::installWheelFilter()
+{
+    Q_FOREACH (QSpinBox *sp, widgetFrame->findChildren<QSpinBox *>()) {
+        sp->installEventFilter(this);
+        sp->setFocusPolicy(Qt::StrongFocus);
+    }
+    Q_FOREACH (KComboBox *cb, widgetFrame->findChildren<KComboBox *>()) {
+        cb->installEventFilter(this);
+        cb->setFocusPolicy(Qt::StrongFocus);
+    }
+    Q_FOREACH (QProgressBar *cb, widgetFrame->findChildren<QProgressBar *>()) {
+        cb->installEventFilter(this);
+        cb->setFocusPolicy(Qt::StrongFocus);
+    }
 }
 
 void CollapsibleEffect::slotCreateGroup()
@@ -285,10 +293,8 @@ QDomElement CollapsibleEffect::effectForSave() const
 {
     QDomElement effect = m_effect.cloneNode().toElement();
     effect.removeAttribute(QStringLiteral("kdenlive_ix"));
-    if (m_paramWidget) {
-        int in = m_paramWidget->range().x();
-        EffectsController::offsetKeyframes(in, effect);
-    }
+    int in = m_paramWidget ? m_paramWidget->range().x() : m_itemInfo.cropStart.frames(KdenliveSettings::project_fps());
+    EffectsController::offsetKeyframes(in, effect);
     return effect;
 }
 
@@ -306,6 +312,10 @@ void CollapsibleEffect::setActive(bool activate)
 {
     decoframe->setProperty("active", activate);
     decoframe->setStyleSheet(decoframe->styleSheet());
+    if (activate) {
+        // The active effect may need a monitor scene, which is handled by its parameter widgets
+        createParamWidget();
+    }
     if (m_paramWidget) {
         m_paramWidget->connectMonitor(activate);
     }
@@ -390,10 +400,8 @@ void CollapsibleEffect::slotSaveEffect()
     effect.removeAttribute(QStringLiteral("kdenlive_ix"));
     effect.setAttribute(QStringLiteral("id"), name);
     effect.setAttribute(QStringLiteral("type"), QStringLiteral("custom"));
-    if (m_paramWidget) {
-        int in = m_paramWidget->range().x();
-        EffectsController::offsetKeyframes(in, effect);
-    }
+    int in = m_paramWidget ? m_paramWidget->range().x() : m_itemInfo.cropStart.frames(KdenliveSettings::project_fps());
+    EffectsController::offsetKeyframes(in, effect);
     QDomElement effectname = effect.firstChildElement(QStringLiteral("name"));
     effect.removeChild(effectname);
     effectname = doc.createElement(QStringLiteral("name"));
@@ -421,6 +429,9 @@ void CollapsibleEffect::slotResetEffect()
 void CollapsibleEffect::slotSwitch()
 {
     bool expand = !widgetFrame->isVisible();
+    if (expand) {
+        createParamWidget();
+    }
     widgetFrame->setVisible(true);
     slotShow(expand);
     m_animation->setDirection(expand ? QTimeLine::Forward : QTimeLine::Backward);
@@ -531,12 +542,14 @@ void CollapsibleEffect::setupWidget(const ItemInfo &info, EffectMetaInfo *metaIn
     }
     delete m_paramWidget;
     m_paramWidget = nullptr;
+    m_itemInfo = info;
+    m_metaInfo = metaInfo;
 
     if (m_effect.attribute(QStringLiteral("tag")) == QLatin1String("region")) {
         m_regionEffect = true;
         QDomNodeList effects =  m_effect.elementsByTagName(QStringLiteral("effect"));
         QDomNodeList origin_effects =  m_original_effect.elementsByTagName(QStringLiteral("effect"));
-        m_paramWidget = new ParameterContainer(m_effect, info, metaInfo, widgetFrame);
+        createParamWidget();
         QWidget *container = new QWidget(widgetFrame);
         QVBoxLayout *vbox = static_cast<QVBoxLayout *>(widgetFrame->layout());
         vbox->addWidget(container);
@@ -553,22 +566,36 @@ void CollapsibleEffect::setupWidget(const ItemInfo &info, EffectMetaInfo *metaIn
             vbox->addWidget(coll);
             //p = new ParameterContainer(effects.at(i).toElement(), info, isEffect, container);
         }
+        installWheelFilter();
     } else {
-        m_paramWidget = new ParameterContainer(m_effect, info, metaInfo, widgetFrame);
-        connect(m_paramWidget, &ParameterContainer::disableCurrentFilter, this, &CollapsibleEffect::slotDisableEffect);
-        connect(m_paramWidget, &ParameterContainer::importKeyframes, this, &CollapsibleEffect::importKeyframes);
         if (m_effect.firstChildElement(QStringLiteral("parameter")).isNull()) {
             // Effect has no parameter, don't allow expand
             collapseButton->setEnabled(false);
             collapseButton->setVisible(false);
             widgetFrame->setVisible(false);
         }
+        if (!m_info.isCollapsed || isActive()) {
+            // Parameters of collapsed effects are only built when expanded
+            createParamWidget();
+        }
     }
     if (collapseButton->isEnabled() && m_info.isCollapsed) {
         widgetFrame->setVisible(false);
         collapseButton->setArrowType(Qt::RightArrow);
 
     }
+}
+
+void CollapsibleEffect::createParamWidget()
+{
+    if (m_paramWidget || m_effect.isNull()) {
+        return;
+    }
+    m_paramWidget = new ParameterContainer(m_effect, m_itemInfo, m_metaInfo, widgetFrame);
+    if (!m_regionEffect) {
+        connect(m_paramWidget, &ParameterContainer::disableCurrentFilter, this, &CollapsibleEffect::slotDisableEffect);
+        connect(m_paramWidget, &ParameterContainer::importKeyframes, this, &CollapsibleEffect::importKeyframes);
+    }
     connect(m_paramWidget, &ParameterContainer::parameterChanged, this, &CollapsibleEffect::parameterChanged);
 
     connect(m_paramWidget, &ParameterContainer::startFilterJob, this, &CollapsibleEffect::startFilterJob);
@@ -577,6 +604,33 @@ void CollapsibleEffect::setupWidget(const ItemInfo &info, EffectMetaInfo *metaIn
     connect(m_paramWidget, &ParameterContainer::checkMonitorPosition, this, &CollapsibleEffect::checkMonitorPosition);
     connect(m_paramWidget, &ParameterContainer::seekTimeline, this, &CollapsibleEffect::seekTimeline);
     connect(m_paramWidget, &ParameterContainer::importClipKeyframes, this, &CollapsibleEffect::prepareImportClipKeyframes);
+    if (!m_regionEffect) {
+        installWheelFilter();
+    }
+    emit syncEffectsPos(m_syncPos);
+}
+
+void CollapsibleEffect::reload(const QDomElement &effect, const QDomElement &original_effect, const ItemInfo &info, EffectMetaInfo *metaInfo, bool canMoveUp, bool lastEffect)
+{
+    m_animation->stop();
+    m_original_effect = original_effect;
+    m_effect = effect;
+    m_info.fromString(effect.attribute(QStringLiteral("kdenlive_info")));
+    buttonUp->setEnabled(canMoveUp);
+    buttonDown->setEnabled(!lastEffect);
+    bool disable = m_effect.attribute(QStringLiteral("disable")) == QLatin1String("1");
+    title->setEnabled(!disable);
+    m_enabledButton->setActive(disable);
+    // Release the height fixed by the collapse animation
+    widgetFrame->setMinimumHeight(0);
+    widgetFrame->setMaximumHeight(QWIDGETSIZE_MAX);
+    if (collapseButton->isEnabled()) {
+        widgetFrame->setVisible(!m_info.isCollapsed);
+        collapseButton->setArrowType(m_info.isCollapsed ? Qt::RightArrow : Qt::DownArrow);
+    }
+    // Activation is set again by the effect stack once the panel is reloaded
+    decoframe->setProperty("active", false);
+    setupWidget(info, metaInfo);
 }
 
 void CollapsibleEffect::slotDisableEffect(bool disable)
@@ -594,7 +648,9 @@ bool CollapsibleEffect::isGroup() const
 
 void CollapsibleEffect::updateTimecodeFormat()
 {
-    m_paramWidget->updateTimecodeFormat();
+    if (m_paramWidget) {
+        m_paramWidget->updateTimecodeFormat();
+    }
     if (!m_subParamWidgets.isEmpty()) {
         // we have a group
         for (int i = 0; i < m_subParamWidgets.count(); ++i) {
@@ -611,6 +667,7 @@ void CollapsibleEffect::slotUpdateRegionEffectParams(const QDomElement &/*old*/,
 
 void CollapsibleEffect::slotSyncEffectsPos(int pos)
 {
+    m_syncPos = pos;
     emit syncEffectsPos(pos);
 }
 
@@ -620,7 +677,7 @@ void CollapsibleEffect::dragEnterEvent(QDragEnterEvent *event)
         frame->setProperty("target", true);
         frame->setStyleSheet(frame->styleSheet());
         event->acceptProposedAction();
-    } else if (m_paramWidget->doesAcceptDrops() && event->mimeData()->hasFormat(QStringLiteral("kdenlive/geometry")) && event->source()->objectName() != QStringLiteral("ParameterContainer")) {
+    } else if (m_paramWidget && m_paramWidget->doesAcceptDrops() && event->mimeData()->hasFormat(QStringLiteral("kdenlive/geometry")) && event->source()->objectName() != QStringLiteral("ParameterContainer")) {
         event->setDropAction(Qt::CopyAction);
         event->setAccepted(true);
     } else {
@@ -737,12 +794,20 @@ MonitorSceneType CollapsibleEffect::needsMonitorEffectScene() const
 
 void CollapsibleEffect::setRange(int inPoint, int outPoint)
 {
-    m_paramWidget->setRange(inPoint, outPoint);
+    if (m_paramWidget) {
+        m_paramWidget->setRange(inPoint, outPoint);
+    } else {
+        m_itemInfo.cropStart = GenTime(inPoint, KdenliveSettings::project_fps());
+        m_itemInfo.cropDuration = GenTime(outPoint - inPoint + 1, KdenliveSettings::project_fps());
+    }
 }
 
 void CollapsibleEffect::setKeyframes(const QString &tag, const QString &keyframes)
 {
-    m_paramWidget->setKeyframes(tag, keyframes);
+    createParamWidget();
+    if (m_paramWidget) {
+        m_paramWidget->setKeyframes(tag, keyframes);
+    }
 }
 
 bool CollapsibleEffect::isMovable() const
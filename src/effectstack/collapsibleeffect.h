@@ -85,6 +85,8 @@ public:
     void setActiveKeyframe(int kf);
     /** @brief Returns true if effect can be moved (false for speed effect). */
     bool isMovable() const;
+    /** @brief Reuse this panel to display another effect with the same id, for example when selecting another clip. */
+    void reload(const QDomElement &effect, const QDomElement &original_effect, const ItemInfo &info, EffectMetaInfo *metaInfo, bool canMoveUp, bool lastEffect);
 
 public slots:
     void slotSyncEffectsPos(int pos);
@@ -116,6 +118,9 @@ private:
     QList<CollapsibleEffect *> m_subParamWidgets;
     QDomElement m_effect;
     ItemInfo m_itemInfo;
+    EffectMetaInfo *m_metaInfo;
+    /** @brief Last synced position, passed to the parameter widgets when they are created. */
+    int m_syncPos;
     QDomElement m_original_effect;
     QList<QDomElement> m_subEffects;
     QMenu *m_menu;
@@ -132,6 +137,10 @@ private:
     QPixmap m_iconPix;
     /** @brief Check if collapsed state changed and inform MLT. */
     void updateCollapsedState();
+    /** @brief Build the parameter widgets, which are deferred until the effect is expanded or activated. */
+    void createParamWidget();
+    /** @brief Install event filter on the parameter widgets so that scrolling does not change their value. */
+    void installWheelFilter();
 
 protected:
     void mouseDoubleClickEvent(QMouseEvent *event) Q_DECL_OVERRIDE;
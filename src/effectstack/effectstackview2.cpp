@@ -39,6 +39,7 @@
 #include <KColorUtils>
 
 #include <QScrollBar>
+#include <QElapsedTimer>
 #include <QDrag>
 #include <QMimeData>
 
@@ -296,13 +297,18 @@ void EffectStackView2::slotTrackItemSelected(int ix, const TrackInfo &info, Moni
 
 void EffectStackView2::setupListView()
 {
+    // Selection to panel latency, reported below
+    QElapsedTimer timer;
+    timer.start();
     blockSignals(true);
     m_scrollTimer.stop();
     m_monitorSceneWanted = MonitorSceneDefault;
     m_draggedEffect = nullptr;
     m_draggedGroup = nullptr;
     disconnect(m_effectMetaInfo.monitor, &Monitor::renderPosition, this, &EffectStackView2::slotRenderPos);
-    QWidget *view = m_effect->container->takeWidget();
+    // When the new stack has the same effects, for example when selecting clips with the same effects, reuse the panels
+    bool recycle = canRecycleEffects();
+    QWidget *view = recycle ? nullptr : m_effect->container->takeWidget();
     if (view) {
         /*QList<CollapsibleEffect *> allChildren = view->findChildren<CollapsibleEffect *>();
         qCDebug(KDENLIVE_LOG)<<" * * *FOUND CHLD: "<<allChildren.count();
@@ -314,18 +320,25 @@ void EffectStackView2::setupListView()
         view->setHidden(true);
         view->deleteLater();
     }
-    m_effects.clear();
+    if (!recycle) {
+        m_effects.clear();
+    }
     m_groupIndex = 0;
     blockSignals(false);
-    view = new QWidget(this);
-    QPalette p = qApp->palette();
-    p.setBrush(QPalette::Window, QBrush(Qt::transparent));
-    view->setPalette(p);
-    m_effect->container->setWidget(view);
+    QVBoxLayout *vbox1 = nullptr;
+    if (recycle) {
+        view = m_effect->container->widget();
+    } else {
+        view = new QWidget(this);
+        QPalette p = qApp->palette();
+        p.setBrush(QPalette::Window, QBrush(Qt::transparent));
+        view->setPalette(p);
+        m_effect->container->setWidget(view);
 
-    QVBoxLayout *vbox1 = new QVBoxLayout(view);
-    vbox1->setContentsMargins(0, 0, 0, 0);
-    vbox1->setSpacing(0);
+        vbox1 = new QVBoxLayout(view);
+        vbox1->setContentsMargins(0, 0, 0, 0);
+        vbox1->setSpacing(0);
+    }
 
     int effectsCount = m_currentEffectList.count();
     m_effect->effectCompare->setEnabled(effectsCount > 0);
@@ -400,8 +413,16 @@ void EffectStackView2::setupListView()
         if (i == 0 || m_currentEffectList.at(i - 1).attribute(QStringLiteral("id")) == QLatin1String("speed")) {
             canMoveUp = false;
         }
-        CollapsibleEffect *currentEffect = new CollapsibleEffect(d, m_currentEffectList.at(i), info, &m_effectMetaInfo, canMoveUp, i == effectsCount - 1, view);
+        CollapsibleEffect *currentEffect;
+        if (recycle) {
+            currentEffect = m_effects.at(i);
+            currentEffect->reload(d, m_currentEffectList.at(i), info, &m_effectMetaInfo, canMoveUp, i == effectsCount - 1);
+        } else {
+            currentEffect = new CollapsibleEffect(d, m_currentEffectList.at(i), info, &m_effectMetaInfo, canMoveUp, i == effectsCount - 1, view);
+        }
         isSelected = currentEffect->effectIndex() == activeEffectIndex();
+        // Activating the effect builds its parameter widgets, which define the monitor scene
+        currentEffect->setActive(isSelected);
         if (isSelected) {
             m_monitorSceneWanted = currentEffect->needsMonitorEffectScene();
             selectedCollapsibleEffect = currentEffect;
@@ -410,7 +431,9 @@ void EffectStackView2::setupListView()
         }
         int position = (m_effectMetaInfo.monitor->position() - (m_status == TIMELINE_CLIP ? m_clipref->startPos() : GenTime())).frames(KdenliveSettings::project_fps());
         currentEffect->slotSyncEffectsPos(position);
-        currentEffect->setActive(isSelected);
+        if (recycle) {
+            continue;
+        }
         m_effects.append(currentEffect);
         if (group) {
             group->addGroupEffect(currentEffect);
@@ -435,11 +458,40 @@ void EffectStackView2::setupListView()
         connect(m_effectMetaInfo.monitor, &Monitor::renderPosition, this, &EffectStackView2::slotRenderPos);
     }
 
-    vbox1->addStretch(10);
+    if (vbox1) {
+        vbox1->addStretch(10);
+    }
     slotUpdateCheckAllButton();
 
     // Wait a little bit for the new layout to be ready, then check if we have a scrollbar
     m_scrollTimer.start();
+    qCDebug(KDENLIVE_LOG) << "Effect stack with" << effectsCount << (recycle ? "recycled" : "new") << "effects displayed in" << timer.elapsed() << "ms";
+}
+
+bool EffectStackView2::canRecycleEffects() const
+{
+    if (m_effects.isEmpty() || m_effects.count() != m_currentEffectList.count() || !m_effect->container->widget()) {
+        return false;
+    }
+    if (!m_effect->container->widget()->findChildren<CollapsibleGroup *>().isEmpty()) {
+        return false;
+    }
+    for (int i = 0; i < m_effects.count(); ++i) {
+        const QDomElement effect = m_currentEffectList.at(i);
+        if (effect.isNull() || effect.attribute(QStringLiteral("tag")) == QLatin1String("region")) {
+            return false;
+        }
+        EffectInfo effectInfo;
+        effectInfo.fromString(effect.attribute(QStringLiteral("kdenlive_info")));
+        if (effectInfo.groupIndex >= 0) {
+            return false;
+        }
+        const QDomElement current = m_effects.at(i)->effect();
+        if (current.attribute(QStringLiteral("id")) != effect.attribute(QStringLiteral("id")) || current.attribute(QStringLiteral("tag")) != effect.attribute(QStringLiteral("tag"))) {
+            return false;
+        }
+    }
+    return true;
 }
 
 int EffectStackView2::activeEffectIndex() const
@@ -145,6 +145,8 @@ private:
 
     /** @brief Sets the list of effects according to the clip's effect list. */
     void setupListView();
+    /** @brief Returns true if the displayed effect panels can be reused for the current effect list (same effects, no group or region). */
+    bool canRecycleEffects() const;
 
     /** @brief Build the drag info and start it. */
     void startDrag();
@@ -26,24 +26,25 @@
 
 FFTTools::FFTTools() :
     m_fftCfgs(),
-    m_windowFunctions()
+    m_windowFunctions(),
+    m_data(),
+    m_freqData()
 {
 }
 FFTTools::~FFTTools()
 {
-    QHash<QString, kiss_fftr_cfg>::iterator i;
+    QHash<int, kiss_fftr_cfg>::iterator i;
     for (i = m_fftCfgs.begin(); i != m_fftCfgs.end(); ++i) {
         free(*i);
     }
 }
 
-const QString FFTTools::windowSignature(const WindowType windowType, const int size, const float param)
+int FFTTools::windowKey(const WindowType windowType, const int size, const float param)
 {
-    return QStringLiteral("s%1_t%2_p%3").arg(size).arg(windowType).arg(param, 0, 'f', 3);
-}
-const QString FFTTools::cfgSignature(const int size)
-{
-    return QStringLiteral("s%1").arg(size);
+    Q_ASSERT(size < (1 << 19));
+    // 10 bits for the parameter (0..1000), 2 bits for the window type, the rest for the size
+    const int p = qBound(0, qRound(param * 1000), 1023);
+    return (size << 12) | ((int)windowType << 10) | p;
 }
 
 // http://cplusplus.syntaxerrors.info/index.php?title=Cannot_declare_member_function_%E2%80%98static_int_Foo::bar%28%29%E2%80%99_to_have_static_linkage
@@ -124,64 +125,57 @@ void FFTTools::fftNormalized(const audioShortVector &audioFrame, const uint chan
         return;
     }
 
-    const QString cfgSig = cfgSignature(windowSize);
-    const QString winSig = windowSignature(windowType, windowSize, param);
-
     // Get the kiss_fft configuration from the config cache
     // or build a new configuration if the requested one is not available.
-    kiss_fftr_cfg myCfg;
-    if (m_fftCfgs.contains(cfgSig)) {
-#ifdef DEBUG_FFTTOOLS
-        qCDebug(KDENLIVE_LOG) << "Re-using FFT configuration with size " << windowSize;
-#endif
-        myCfg = m_fftCfgs.value(cfgSig);
-    } else {
+    kiss_fftr_cfg myCfg = m_fftCfgs.value((int)windowSize, nullptr);
+    if (myCfg == nullptr) {
 #ifdef DEBUG_FFTTOOLS
         qCDebug(KDENLIVE_LOG) << "Creating FFT configuration with size " << windowSize;
 #endif
         myCfg = kiss_fftr_alloc(windowSize, false, nullptr, nullptr);
-        m_fftCfgs.insert(cfgSig, myCfg);
+        m_fftCfgs.insert((int)windowSize, myCfg);
     }
 
     // Get the window function from the cache
     // (except for a rectangular window; nothing to do there).
-    QVector<float> window;
+    const float *window = nullptr;
     float windowScaleFactor = 1;
     if (windowType != FFTTools::Window_Rect) {
-
-        if (m_windowFunctions.contains(winSig)) {
+        const int winKey = windowKey(windowType, windowSize, param);
+        QHash<int, QVector<float> >::const_iterator it = m_windowFunctions.constFind(winKey);
+        if (it == m_windowFunctions.constEnd()) {
 #ifdef DEBUG_FFTTOOLS
-            qCDebug(KDENLIVE_LOG) << "Re-using window function with signature " << winSig;
+            qCDebug(KDENLIVE_LOG) << "Building new window function with key " << winKey;
 #endif
-            window = m_windowFunctions.value(winSig);
-        } else {
-#ifdef DEBUG_FFTTOOLS
-            qCDebug(KDENLIVE_LOG) << "Building new window function with signature " << winSig;
-#endif
-            window = FFTTools::window(windowType, windowSize, 0);
-            m_windowFunctions.insert(winSig, window);
+            it = m_windowFunctions.insert(winKey, FFTTools::window(windowType, windowSize, param));
         }
+        window = it.value().constData();
         windowScaleFactor = 1.0 / window[windowSize];
     }
 
     // Prepare frequency space vector. The resulting FFT vector is only half as long.
-    kiss_fft_cpx freqData[windowSize / 2];
-    float data[windowSize];
+    if ((uint)m_data.size() < windowSize) {
+        m_data.resize(windowSize);
+        m_freqData.resize(windowSize / 2 + 1);
+    }
+    float *data = m_data.data();
+    kiss_fft_cpx *freqData = m_freqData.data();
 
     // Copy the first channel's audio into a vector for the FFT display;
     // Fill the data vector indices that cannot be covered with sample data with 0
     if (numSamples < windowSize) {
-        std::fill(&data[numSamples], &data[windowSize - 1], 0);
+        std::fill(data + numSamples, data + windowSize, 0.f);
     }
     // Normalize signals to [0,1] to get correct dB values later on
-    for (uint i = 0; i < numSamples && i < windowSize; ++i) {
-        // Performance note: Benchmarking has shown that using the if/else inside the loop
-        // does not do noticeable worse than keeping it outside (perhaps the branch predictor
-        // is good enough), so it remains in there for better readability.
-        if (windowType != FFTTools::Window_Rect) {
-            data[i] = (float) audioFrame.data()[i * numChannels + channel] / 32767.0f * window[i];
-        } else {
-            data[i] = (float) audioFrame.data()[i * numChannels + channel] / 32767.0f;
+    const qint16 *samples = audioFrame.constData() + channel;
+    const uint count = qMin(numSamples, windowSize);
+    if (window != nullptr) {
+        for (uint i = 0; i < count; ++i) {
+            data[i] = (float) samples[i * numChannels] / 32767.0f * window[i];
+        }
+    } else {
+        for (uint i = 0; i < count; ++i) {
+            data[i] = (float) samples[i * numChannels] / 32767.0f;
         }
     }
 
@@ -189,11 +183,12 @@ void FFTTools::fftNormalized(const audioShortVector &audioFrame, const uint chan
     kiss_fftr(myCfg, data, freqData);
 
     // Logarithmic scale: 20 * log ( 2 * magnitude / N ) with magnitude = sqrt(r² + i²)
-    // with N = FFT size (after FFT, 1/2 window size)
+    // with N = FFT size (after FFT, 1/2 window size), computed as 10 * log(r² + i²) - 20 * log(N)
+    const float scale2 = windowScaleFactor * windowScaleFactor;
+    const float norm = 20.0f * log10f((float)windowSize / 2.0f);
     for (uint i = 0; i < windowSize / 2; ++i) {
-        // Logarithmic scale: 20 * log ( 2 * magnitude / N ) with magnitude = sqrt(r² + i²)
-        // with N = FFT size (after FFT, 1/2 window size)
-        freqSpectrum[i] = 20 * log(pow(pow(fabs(freqData[i].r * windowScaleFactor), 2) + pow(fabs(freqData[i].i * windowScaleFactor), 2), .5) / ((float)windowSize / 2.0f)) / log(10);;
+        const float power = (freqData[i].r * freqData[i].r + freqData[i].i * freqData[i].i) * scale2;
+        freqSpectrum[i] = 10.0f * log10f(power) - norm;
     }
 
 #ifdef DEBUG_FFTTOOLS
@@ -226,19 +221,24 @@ void FFTTools::fftNormalized(const audioShortVector &audioFrame, const uint chan
 }
 
 const QVector<float> FFTTools::interpolatePeakPreserving(const QVector<float> &in, const uint targetSize, uint left, uint right, float fill)
+{
+    QVector<float> out(targetSize);
+    interpolatePeakPreserving(in.constData(), in.size(), out.data(), targetSize, left, right, fill);
+    return out;
+}
+
+void FFTTools::interpolatePeakPreserving(const float *in, const uint inSize, float *out, const uint targetSize, uint left, uint right, float fill)
 {
 #ifdef DEBUG_FFTTOOLS
     QTime start = QTime::currentTime();
 #endif
 
     if (right == 0) {
-        right = in.size() - 1;
+        right = inSize - 1;
     }
     Q_ASSERT(targetSize > 0);
     Q_ASSERT(left < right);
 
-    QVector<float> out(targetSize);
-
     float x;
     uint xi;
     uint i;
@@ -254,14 +254,14 @@ const QVector<float> FFTTools::interpolatePeakPreserving(const QVector<float> &i
             x = ((float) i) / (targetSize - 1) * (right - left) + left;
             xi = (int) floor(x);
 
-            if (x > in.size() - 1) {
+            if (x > inSize - 1) {
                 // This may happen if right > in.size()-1; Fill the rest of the vector
                 // with the default value now.
                 break;
             }
 
             // Use linear interpolation in order to get smoother display
-            if (xi == 0 || xi == (uint) in.size() - 1) {
+            if (xi == 0 || xi == inSize - 1) {
                 // ... except if we are at the left or right border of the input sigal.
                 // Special case here since we consider previous and future values as well for
                 // the actual interpolation (not possible here).
@@ -297,7 +297,7 @@ const QVector<float> FFTTools::interpolatePeakPreserving(const QVector<float> &i
 
             out[i] = fill;
 
-            for (; src < xi && src < (uint) in.size(); ++src) {
+            for (; src < xi && src < inSize; ++src) {
                 if (out[i] < in[src]) {
                     out[i] = in[src];
                 }
@@ -313,10 +313,8 @@ const QVector<float> FFTTools::interpolatePeakPreserving(const QVector<float> &i
     }
 
 #ifdef DEBUG_FFTTOOLS
-    qCDebug(KDENLIVE_LOG) << "Interpolated " << targetSize << " nodes from " << in.size() << " input points in " << start.elapsed() << " ms";
+    qCDebug(KDENLIVE_LOG) << "Interpolated " << targetSize << " nodes from " << inSize << " input points in " << start.elapsed() << " ms";
 #endif
-
-    return out;
 }
 
 #ifdef DEBUG_FFTTOOLS
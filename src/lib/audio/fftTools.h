@@ -39,11 +39,9 @@ public:
     */
     static const QVector<float> window(const WindowType windowType, const int size, const float param = 0);
 
-    static const QString windowSignature(const WindowType windowType, const int size, const float param = 0);
-
-    /** Returns a signature for a kiss_fft configuration
-        used as a hash in the cache */
-    static const QString cfgSignature(const int size);
+    /** Returns the key of a window function in the cache.
+        The size must be smaller than 2^19, the parameter is stored with a precision of 1/1000. */
+    static int windowKey(const WindowType windowType, const int size, const float param = 0);
 
     /** Calculates the Fourier Tranformation of the input audio frame.
         The resulting values will be given in relative dezibel: The maximum power is 0 dB, lower powers have
@@ -72,10 +70,15 @@ public:
                             will be used for filling the missing information.
         */
     static const QVector<float> interpolatePeakPreserving(const QVector<float> &in, const uint targetSize, uint left = 0, uint right = 0, float fill = 0.0);
+    /** Same as above, working on a raw array of @param inSize values (e.g. a row of a spectrum history buffer).
+        The result is written to @param out which must hold @param targetSize values. */
+    static void interpolatePeakPreserving(const float *in, const uint inSize, float *out, const uint targetSize, uint left = 0, uint right = 0, float fill = 0.0);
 
 private:
-    QHash<QString, kiss_fftr_cfg> m_fftCfgs; // FFT cfg cache
-    QHash<QString, QVector<float> > m_windowFunctions; // Window function cache
+    QHash<int, kiss_fftr_cfg> m_fftCfgs; // FFT cfg cache, keyed by window size
+    QHash<int, QVector<float> > m_windowFunctions; // Window function cache, keyed by windowKey()
+    QVector<float> m_data; // FFT input buffer
+    QVector<kiss_fft_cpx> m_freqData; // FFT output buffer
 
 };
 
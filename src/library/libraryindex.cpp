@@ -0,0 +1,185 @@
+/***************************************************************************
+ *   Copyright (C) 2018 by Jean-Baptiste Mardelle (jb@kdenlive.org)        *
+ *   This file is part of Kdenlive. See www.kdenlive.org.                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation; either version 2 of        *
+ *   the License or (at your option) version 3 or any later version        *
+ *   accepted by the membership of KDE e.V. (or its successor approved     *
+ *   by the membership of KDE e.V.), which shall act as a proxy            *
+ *   defined in Section 14 of version 3 of the license.                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "libraryindex.h"
+#include "kdenlive_debug.h"
+
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QPixmap>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+
+// Increase when the stored data changes, older indexes are then rebuilt
+static const int indexVersion = 1;
+
+LibraryIndex::LibraryIndex() :
+    m_modified(false)
+{
+}
+
+void LibraryIndex::load(const QString &folder)
+{
+    m_entries.clear();
+    m_modified = false;
+    m_libraryFolder = QDir::cleanPath(folder);
+    const QString key = QString::fromLatin1(QCryptographicHash::hash(m_libraryFolder.toUtf8(), QCryptographicHash::Md5).toHex());
+    m_cacheFolder = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/library/") + key;
+    QFile file(m_cacheFolder + QStringLiteral("/index.json"));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    const QJsonObject index = QJsonDocument::fromJson(file.readAll()).object();
+    if (index.value(QStringLiteral("version")).toInt() != indexVersion) {
+        return;
+    }
+    const QJsonObject items = index.value(QStringLiteral("items")).toObject();
+    for (auto i = items.constBegin(); i != items.constEnd(); ++i) {
+        const QJsonObject item = i.value().toObject();
+        Entry entry;
+        entry.mtime = (qint64) item.value(QStringLiteral("mtime")).toDouble();
+        entry.size = (qint64) item.value(QStringLiteral("size")).toDouble();
+        entry.type = item.value(QStringLiteral("type")).toInt();
+        entry.time = item.value(QStringLiteral("time")).toString();
+        entry.icon = item.value(QStringLiteral("icon")).toString();
+        entry.hasThumb = item.value(QStringLiteral("thumb")).toBool();
+        m_entries.insert(m_libraryFolder + QLatin1Char('/') + i.key(), entry);
+    }
+}
+
+void LibraryIndex::save()
+{
+    if (!m_modified || m_cacheFolder.isEmpty()) {
+        return;
+    }
+    QJsonObject items;
+    for (auto i = m_entries.constBegin(); i != m_entries.constEnd(); ++i) {
+        QJsonObject item;
+        item.insert(QStringLiteral("mtime"), (double) i.value().mtime);
+        item.insert(QStringLiteral("size"), (double) i.value().size);
+        item.insert(QStringLiteral("type"), i.value().type);
+        item.insert(QStringLiteral("time"), i.value().time);
+        item.insert(QStringLiteral("icon"), i.value().icon);
+        item.insert(QStringLiteral("thumb"), i.value().hasThumb);
+        items.insert(relativePath(i.key()), item);
+    }
+    QJsonObject index;
+    index.insert(QStringLiteral("version"), indexVersion);
+    index.insert(QStringLiteral("items"), items);
+    QDir().mkpath(m_cacheFolder);
+    QSaveFile file(m_cacheFolder + QStringLiteral("/index.json"));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCDebug(KDENLIVE_LOG) << "Cannot write library index" << file.fileName();
+        return;
+    }
+    file.write(QJsonDocument(index).toJson(QJsonDocument::Compact));
+    if (file.commit()) {
+        m_modified = false;
+    }
+}
+
+const QMap<QString, LibraryIndex::Entry> &LibraryIndex::entries() const
+{
+    return m_entries;
+}
+
+bool LibraryIndex::contains(const QString &path) const
+{
+    return m_entries.contains(path);
+}
+
+bool LibraryIndex::isUpToDate(const QString &path, qint64 mtime) const
+{
+    auto i = m_entries.constFind(path);
+    return i != m_entries.constEnd() && i.value().mtime == mtime;
+}
+
+void LibraryIndex::insert(const QString &path, const Entry &entry)
+{
+    auto i = m_entries.find(path);
+    if (i != m_entries.end() && i.value().hasThumb && !entry.hasThumb) {
+        // File changed, its thumbnail will be created again
+        QFile::remove(thumbnailPath(path));
+    }
+    m_entries.insert(path, entry);
+    m_modified = true;
+}
+
+void LibraryIndex::remove(const QString &path)
+{
+    auto i = m_entries.find(path);
+    if (i != m_entries.end()) {
+        if (i.value().hasThumb) {
+            QFile::remove(thumbnailPath(path));
+        }
+        m_entries.erase(i);
+        m_modified = true;
+    }
+    // Folder content
+    const QString prefix = path + QLatin1Char('/');
+    i = m_entries.lowerBound(prefix);
+    while (i != m_entries.end() && i.key().startsWith(prefix)) {
+        if (i.value().hasThumb) {
+            QFile::remove(thumbnailPath(i.key()));
+        }
+        i = m_entries.erase(i);
+        m_modified = true;
+    }
+}
+
+QStringList LibraryIndex::children(const QString &folder) const
+{
+    QStringList result;
+    const QString prefix = folder + QLatin1Char('/');
+    for (auto i = m_entries.lowerBound(prefix); i != m_entries.constEnd() && i.key().startsWith(prefix); ++i) {
+        if (i.key().indexOf(QLatin1Char('/'), prefix.length()) == -1) {
+            result << i.key();
+        }
+    }
+    return result;
+}
+
+QString LibraryIndex::thumbnailPath(const QString &path) const
+{
+    const QString key = QString::fromLatin1(QCryptographicHash::hash(relativePath(path).toUtf8(), QCryptographicHash::Md5).toHex());
+    return m_cacheFolder + QStringLiteral("/thumbs/") + key + QStringLiteral(".png");
+}
+
+void LibraryIndex::setThumbnail(const QString &path, const QPixmap &pix)
+{
+    auto i = m_entries.find(path);
+    if (i == m_entries.end()) {
+        return;
+    }
+    QDir().mkpath(m_cacheFolder + QStringLiteral("/thumbs"));
+    if (pix.save(thumbnailPath(path), "PNG")) {
+        i.value().hasThumb = true;
+        m_modified = true;
+    }
+}
+
+QString LibraryIndex::relativePath(const QString &path) const
+{
+    return path.mid(m_libraryFolder.length() + 1);
+}
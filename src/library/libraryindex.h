@@ -0,0 +1,82 @@
+/***************************************************************************
+ *   Copyright (C) 2018 by Jean-Baptiste Mardelle (jb@kdenlive.org)        *
+ *   This file is part of Kdenlive. See www.kdenlive.org.                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation; either version 2 of        *
+ *   the License or (at your option) version 3 or any later version        *
+ *   accepted by the membership of KDE e.V. (or its successor approved     *
+ *   by the membership of KDE e.V.), which shall act as a proxy            *
+ *   defined in Section 14 of version 3 of the license.                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef LIBRARYINDEX_H
+#define LIBRARYINDEX_H
+
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+class QPixmap;
+
+/**
+ * @class LibraryIndex
+ * @brief Persistent index of the library content, with the metadata and thumbnail of each item.
+ *
+ * Entries are keyed by absolute path and store the modification time of the indexed file, so that
+ * the library can be displayed without reading the disk and only changed files are processed again.
+ * The index and thumbnails are stored in the cache folder, separately for each library folder.
+ */
+class LibraryIndex
+{
+public:
+    struct Entry {
+        Entry() : mtime(0), size(0), type(0), hasThumb(false) {}
+        /** @brief Modification time of the file, in milliseconds since epoch. */
+        qint64 mtime;
+        qint64 size;
+        /** @brief Item type (folder, playlist or clip). */
+        int type;
+        /** @brief Modification time as displayed in the library. */
+        QString time;
+        QString icon;
+        bool hasThumb;
+    };
+
+    LibraryIndex();
+    /** @brief Load the index of the library stored in @param folder. */
+    void load(const QString &folder);
+    /** @brief Write the index to disk if it was modified. */
+    void save();
+    /** @brief Returns all entries, sorted by path so that folders come before their content. */
+    const QMap<QString, Entry> &entries() const;
+    bool contains(const QString &path) const;
+    /** @brief Returns true if @param path is indexed with the modification time @param mtime. */
+    bool isUpToDate(const QString &path, qint64 mtime) const;
+    void insert(const QString &path, const Entry &entry);
+    /** @brief Remove @param path and, if it is a folder, all its content. */
+    void remove(const QString &path);
+    /** @brief Returns the paths of the items directly inside @param folder. */
+    QStringList children(const QString &folder) const;
+    /** @brief Returns the path of the stored thumbnail for @param path. */
+    QString thumbnailPath(const QString &path) const;
+    void setThumbnail(const QString &path, const QPixmap &pix);
+
+private:
+    QString m_libraryFolder;
+    QString m_cacheFolder;
+    QMap<QString, Entry> m_entries;
+    bool m_modified;
+    QString relativePath(const QString &path) const;
+};
+
+#endif
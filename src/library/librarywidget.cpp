@@ -34,6 +34,7 @@
 #include <QDropEvent>
 #include <QToolBar>
 #include <QProgressBar>
+#include <QLineEdit>
 
 #include <klocalizedstring.h>
 #include <KMessageBox>
@@ -45,6 +46,24 @@ enum LibraryItem {
     Folder
 };
 
+static LibraryIndex::Entry indexEntry(const KFileItem &fitem)
+{
+    LibraryIndex::Entry entry;
+    entry.mtime = fitem.time(KFileItem::ModificationTime).toMSecsSinceEpoch();
+    entry.size = (qint64) fitem.size();
+    entry.time = fitem.timeString();
+    entry.icon = fitem.iconName();
+    const QString name = fitem.name();
+    if (fitem.isDir()) {
+        entry.type = (int) LibraryItem::Folder;
+    } else if (name.endsWith(QLatin1String(".mlt")) || name.endsWith(QLatin1String(".kdenlive"))) {
+        entry.type = (int) LibraryItem::PlayList;
+    } else {
+        entry.type = (int) LibraryItem::Clip;
+    }
+    return entry;
+}
+
 LibraryTree::LibraryTree(QWidget *parent) : QTreeWidget(parent)
 {
     int size = QFontInfo(font()).pixelSize();
@@ -89,21 +108,6 @@ void LibraryTree::slotUpdateThumb(const QString &path, const QString &iconPath)
     }
 }
 
-void LibraryTree::slotUpdateThumb(const QString &path, const QPixmap &pix)
-{
-    QString name = QUrl::fromLocalFile(path).fileName();
-    QList<QTreeWidgetItem *> list = findItems(name, Qt::MatchExactly | Qt::MatchRecursive);
-    foreach (QTreeWidgetItem *item, list) {
-        if (item->data(0, Qt::UserRole).toString() == path) {
-            // We found our item
-            blockSignals(true);
-            item->setData(0, Qt::DecorationRole, QIcon(pix));
-            blockSignals(false);
-            break;
-        }
-    }
-}
-
 void LibraryTree::mousePressEvent(QMouseEvent *event)
 {
     QTreeWidgetItem *clicked = this->itemAt(event->pos());
@@ -165,6 +169,11 @@ LibraryWidget::LibraryWidget(ProjectManager *manager, QWidget *parent) : QWidget
     , m_previewJob(nullptr)
 {
     QVBoxLayout *lay = new QVBoxLayout(this);
+    m_searchLine = new QLineEdit(this);
+    m_searchLine->setPlaceholderText(i18n("Search..."));
+    m_searchLine->setClearButtonEnabled(true);
+    connect(m_searchLine, &QLineEdit::textChanged, this, &LibraryWidget::slotFilterItems);
+    lay->addWidget(m_searchLine);
     m_libraryTree = new LibraryTree(this);
     m_libraryTree->setColumnCount(1);
     m_libraryTree->setHeaderHidden(true);
@@ -210,20 +219,34 @@ LibraryWidget::LibraryWidget(ProjectManager *manager, QWidget *parent) : QWidget
     m_timer.setSingleShot(true);
     m_timer.setInterval(4000);
     connect(&m_timer, &QTimer::timeout, m_infoWidget, &KMessageWidget::animatedHide);
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setInterval(3000);
+    connect(&m_saveTimer, &QTimer::timeout, this, [this]() {
+        m_index.save();
+    });
     connect(m_libraryTree, &LibraryTree::moveData, this, &LibraryWidget::slotMoveData);
     connect(m_libraryTree, &LibraryTree::importSequence, this, &LibraryWidget::slotSaveSequence);
 
+    m_libraryTree->setSortingEnabled(true);
+    m_libraryTree->sortByColumn(0, Qt::AscendingOrder);
+    // Display the indexed content, the dir lister then only reports changes
+    loadIndex();
+
     m_coreLister = new KCoreDirLister(this);
     m_coreLister->setDelayedMimeTypes(false);
     connect(m_coreLister, SIGNAL(itemsAdded(QUrl, KFileItemList)), this, SLOT(slotItemsAdded(QUrl, KFileItemList)));
     connect(m_coreLister, &KCoreDirLister::itemsDeleted, this, &LibraryWidget::slotItemsDeleted);
-    connect(m_coreLister, SIGNAL(clear()), this, SLOT(slotClearAll()));
+    connect(m_coreLister, &KCoreDirLister::refreshItems, this, &LibraryWidget::slotItemsRefreshed);
+    connect(m_coreLister, SIGNAL(completed(QUrl)), this, SLOT(slotListingCompleted(QUrl)));
     m_coreLister->openUrl(QUrl::fromLocalFile(m_directory.absolutePath()));
-    m_libraryTree->setSortingEnabled(true);
-    m_libraryTree->sortByColumn(0, Qt::AscendingOrder);
     connect(m_libraryTree, &LibraryTree::itemChanged, this, &LibraryWidget::slotItemEdited, Qt::UniqueConnection);
 }
 
+LibraryWidget::~LibraryWidget()
+{
+    m_index.save();
+}
+
 void LibraryWidget::setupActions(const QList<QAction *> &list)
 {
     QList<QAction *> menuList;
@@ -473,8 +496,9 @@ void LibraryWidget::slotUpdateLibraryPath()
 {
     // Library path changed, reload library with updated path
     m_libraryTree->blockSignals(true);
-    m_folders.clear();
-    m_libraryTree->clear();
+    m_saveTimer.stop();
+    m_index.save();
+    clearItems();
     QString defaultPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QStringLiteral("/library");
     if (KdenliveSettings::librarytodefaultfolder() || KdenliveSettings::libraryfolder().isEmpty()) {
         m_directory.setPath(defaultPath);
@@ -506,125 +530,224 @@ void LibraryWidget::slotUpdateLibraryPath()
         showMessage(i18n("Check your settings, Library path is invalid: %1", m_directory.absolutePath()), KMessageWidget::Warning);
         setEnabled(false);
     } else {
+        loadIndex();
         m_coreLister->openUrl(QUrl::fromLocalFile(m_directory.absolutePath()));
         setEnabled(true);
     }
     m_libraryTree->blockSignals(false);
 }
 
+void LibraryWidget::loadIndex()
+{
+    QMutexLocker lock(&m_treeMutex);
+    m_index.load(m_directory.absolutePath());
+    // Avoid sorting the tree on each insertion
+    m_libraryTree->setSortingEnabled(false);
+    const QMap<QString, LibraryIndex::Entry> &entries = m_index.entries();
+    for (auto i = entries.constBegin(); i != entries.constEnd(); ++i) {
+        createItem(i.key(), i.value());
+    }
+    m_libraryTree->setSortingEnabled(true);
+    if (!m_searchLine->text().isEmpty()) {
+        slotFilterItems(m_searchLine->text());
+    }
+}
+
+void LibraryWidget::clearItems()
+{
+    m_items.clear();
+    m_listedItems.clear();
+    m_libraryTree->clear();
+}
+
+QTreeWidgetItem *LibraryWidget::createItem(const QString &path, const LibraryIndex::Entry &entry)
+{
+    QTreeWidgetItem *parent = m_items.value(path.left(path.lastIndexOf(QLatin1Char('/'))));
+    const QString name = path.section(QLatin1Char('/'), -1);
+    QTreeWidgetItem *treeItem;
+    if (parent) {
+        treeItem = new QTreeWidgetItem(parent, QStringList() << name);
+    } else {
+        treeItem = new QTreeWidgetItem(m_libraryTree, QStringList() << name);
+    }
+    treeItem->setData(0, Qt::UserRole, path);
+    treeItem->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled | Qt::ItemIsDragEnabled | Qt::ItemIsDropEnabled | Qt::ItemIsEditable);
+    m_items.insert(path, treeItem);
+    updateItem(treeItem, path, entry);
+    return treeItem;
+}
+
+void LibraryWidget::updateItem(QTreeWidgetItem *item, const QString &path, const LibraryIndex::Entry &entry)
+{
+    item->setData(0, Qt::UserRole + 1, entry.time);
+    item->setData(0, Qt::UserRole + 2, entry.type);
+    if (entry.hasThumb) {
+        item->setData(0, Qt::DecorationRole, QIcon(m_index.thumbnailPath(path)));
+    } else {
+        item->setData(0, Qt::DecorationRole, KoIconUtils::themedIcon(entry.icon));
+    }
+}
+
+void LibraryWidget::removeItem(const QString &path)
+{
+    m_index.remove(path);
+    m_listedItems.remove(path);
+    QTreeWidgetItem *item = m_items.take(path);
+    if (!item) {
+        return;
+    }
+    if (item->childCount() > 0) {
+        // Folder content is deleted with the folder item
+        const QString prefix = path + QLatin1Char('/');
+        auto i = m_items.begin();
+        while (i != m_items.end()) {
+            if (i.key().startsWith(prefix)) {
+                i = m_items.erase(i);
+            } else {
+                ++i;
+            }
+        }
+    }
+    delete item;
+}
+
+void LibraryWidget::processItems(const KFileItemList &list)
+{
+    KFileItemList changed;
+    bool modified = false;
+    foreach (const KFileItem &fitem, list) {
+        const QString path = fitem.url().toLocalFile();
+        QTreeWidgetItem *treeItem = m_items.value(path);
+        if (treeItem && m_index.isUpToDate(path, fitem.time(KFileItem::ModificationTime).toMSecsSinceEpoch())) {
+            // Unchanged since it was indexed
+            continue;
+        }
+        LibraryIndex::Entry entry = indexEntry(fitem);
+        m_index.insert(path, entry);
+        modified = true;
+        if (treeItem) {
+            updateItem(treeItem, path, entry);
+        } else {
+            createItem(path, entry);
+        }
+        if (!fitem.isDir()) {
+            changed << fitem;
+        }
+    }
+    if (!changed.isEmpty()) {
+        QStringList plugins = KIO::PreviewJob::availablePlugins();
+        m_previewJob = KIO::filePreview(changed, QSize(80, 80), &plugins);
+        m_previewJob->setIgnoreMaximumSize();
+        connect(m_previewJob, &KIO::PreviewJob::gotPreview, this, &LibraryWidget::slotGotPreview);
+    }
+    if (modified) {
+        if (!m_searchLine->text().isEmpty()) {
+            slotFilterItems(m_searchLine->text());
+        }
+        m_saveTimer.start();
+    }
+}
+
 void LibraryWidget::slotGotPreview(const KFileItem &item, const QPixmap &pix)
 {
     const QString path = item.url().toLocalFile();
+    m_index.setThumbnail(path, pix);
+    m_saveTimer.start();
+    QTreeWidgetItem *treeItem = m_items.value(path);
+    if (treeItem) {
+        m_libraryTree->blockSignals(true);
+        treeItem->setData(0, Qt::DecorationRole, QIcon(pix));
+        m_libraryTree->blockSignals(false);
+    }
+}
+
+void LibraryWidget::slotItemsDeleted(const KFileItemList &list)
+{
     m_libraryTree->blockSignals(true);
-    m_libraryTree->slotUpdateThumb(path, pix);
+    QMutexLocker lock(&m_treeMutex);
+    foreach (const KFileItem &fitem, list) {
+        removeItem(fitem.url().toLocalFile());
+    }
+    m_saveTimer.start();
     m_libraryTree->blockSignals(false);
 }
 
-void LibraryWidget::slotItemsDeleted(const KFileItemList &list)
+void LibraryWidget::slotItemsAdded(const QUrl &url, const KFileItemList &list)
 {
+    Q_UNUSED(url)
     m_libraryTree->blockSignals(true);
     QMutexLocker lock(&m_treeMutex);
+    processItems(list);
     foreach (const KFileItem &fitem, list) {
-        QUrl fileUrl = fitem.url();
-        QString path;
-        if (fitem.isDir()) {
-            path = fileUrl.toLocalFile();
-        } else {
-            path = fileUrl.adjusted(QUrl::RemoveFilename | QUrl::StripTrailingSlash).toLocalFile();
-        }
-        QTreeWidgetItem *matchingFolder = nullptr;
-        if (path != m_directory.absolutePath()) {
-            foreach (QTreeWidgetItem *folder, m_folders) {
-                if (folder->data(0, Qt::UserRole).toString() == path) {
-                    // Found parent folder
-                    matchingFolder = folder;
-                    break;
-                }
-            }
-        }
+        m_listedItems.insert(fitem.url().toLocalFile());
         if (fitem.isDir()) {
-            if (matchingFolder) {
-                m_folders.removeAll(matchingFolder);
-                // warning, we also need to remove all subfolders since they will be recreated
-                QList<QTreeWidgetItem *> subList;
-                foreach (QTreeWidgetItem *folder, m_folders) {
-                    if (folder->data(0, Qt::UserRole).toString().startsWith(path)) {
-                        subList << folder;
-                    }
-                }
-                foreach (QTreeWidgetItem *sub, subList) {
-                    m_folders.removeAll(sub);
-                }
-                delete matchingFolder;
-            }
-        } else {
-            if (matchingFolder == nullptr) {
-                matchingFolder = m_libraryTree->invisibleRootItem();
-            }
-            for (int i = 0; i < matchingFolder->childCount(); i++) {
-                QTreeWidgetItem *item = matchingFolder->child(i);
-                if (item->data(0, Qt::UserRole).toString() == fileUrl.toLocalFile()) {
-                    // Found deleted item
-                    delete item;
-                    break;
-                }
-            }
+            m_coreLister->openUrl(fitem.url(), KCoreDirLister::Keep);
         }
     }
     m_libraryTree->blockSignals(false);
 }
 
-void LibraryWidget::slotItemsAdded(const QUrl &url, const KFileItemList &list)
+void LibraryWidget::slotItemsRefreshed(const QList<QPair<KFileItem, KFileItem> > &list)
 {
     m_libraryTree->blockSignals(true);
     QMutexLocker lock(&m_treeMutex);
-    foreach (const KFileItem &fitem, list) {
-        QUrl fileUrl = fitem.url();
-        QString name = fileUrl.fileName();
-        QTreeWidgetItem *treeItem;
-        QTreeWidgetItem *parent = nullptr;
-        if (url != QUrl::fromLocalFile(m_directory.absolutePath())) {
-            // not a top level item
-            QString directory = fileUrl.adjusted(QUrl::RemoveFilename | QUrl::StripTrailingSlash).toLocalFile();
-            foreach (QTreeWidgetItem *folder, m_folders) {
-                if (folder->data(0, Qt::UserRole).toString() == directory) {
-                    // Found parent folder
-                    parent = folder;
-                    break;
-                }
+    KFileItemList items;
+    for (const auto &pair : list) {
+        if (pair.first.url() != pair.second.url()) {
+            // Renamed item
+            removeItem(pair.first.url().toLocalFile());
+            m_listedItems.insert(pair.second.url().toLocalFile());
+            if (pair.second.isDir()) {
+                // The folder content was removed with the old item, list it again
+                m_coreLister->openUrl(pair.second.url(), KCoreDirLister::Keep);
             }
         }
-        if (parent) {
-            treeItem = new QTreeWidgetItem(parent, QStringList() << name);
-        } else {
-            treeItem = new QTreeWidgetItem(m_libraryTree, QStringList() << name);
-        }
-        treeItem->setData(0, Qt::UserRole, fileUrl.toLocalFile());
-        treeItem->setData(0, Qt::UserRole + 1, fitem.timeString());
-        if (fitem.isDir()) {
-            treeItem->setData(0, Qt::UserRole + 2, (int) LibraryItem::Folder);
-            m_folders << treeItem;
-            m_coreLister->openUrl(fileUrl, KCoreDirLister::Keep);
-        } else if (name.endsWith(QLatin1String(".mlt")) || name.endsWith(QLatin1String(".kdenlive"))) {
-            treeItem->setData(0, Qt::UserRole + 2, (int) LibraryItem::PlayList);
-        } else {
-            treeItem->setData(0, Qt::UserRole + 2, (int) LibraryItem::Clip);
-        }
-        treeItem->setData(0, Qt::DecorationRole, KoIconUtils::themedIcon(fitem.iconName()));
-        treeItem->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled | Qt::ItemIsDragEnabled | Qt::ItemIsDropEnabled | Qt::ItemIsEditable);
+        items << pair.second;
     }
-    QStringList plugins = KIO::PreviewJob::availablePlugins();
-    m_previewJob = KIO::filePreview(list, QSize(80, 80), &plugins);
-    m_previewJob->setIgnoreMaximumSize();
-    connect(m_previewJob, &KIO::PreviewJob::gotPreview, this, &LibraryWidget::slotGotPreview);
+    processItems(items);
     m_libraryTree->blockSignals(false);
 }
 
-void LibraryWidget::slotClearAll()
+void LibraryWidget::slotListingCompleted(const QUrl &url)
 {
     m_libraryTree->blockSignals(true);
-    m_folders.clear();
-    m_libraryTree->clear();
+    QMutexLocker lock(&m_treeMutex);
+    const QString folder = url.adjusted(QUrl::StripTrailingSlash).toLocalFile();
+    const QStringList indexed = m_index.children(folder);
+    bool removed = false;
+    for (const QString &path : indexed) {
+        if (!m_listedItems.contains(path)) {
+            // Deleted while the library was not watched
+            removeItem(path);
+            removed = true;
+        }
+    }
+    if (removed) {
+        m_saveTimer.start();
+    }
     m_libraryTree->blockSignals(false);
 }
 
+void LibraryWidget::slotFilterItems(const QString &text)
+{
+    for (int i = 0; i < m_libraryTree->topLevelItemCount(); ++i) {
+        filterItem(m_libraryTree->topLevelItem(i), text);
+    }
+}
+
+bool LibraryWidget::filterItem(QTreeWidgetItem *item, const QString &text)
+{
+    bool matches = text.isEmpty() || item->text(0).contains(text, Qt::CaseInsensitive);
+    bool visible = matches;
+    for (int i = 0; i < item->childCount(); ++i) {
+        // Show the whole content of matching folders
+        if (filterItem(item->child(i), matches ? QString() : text)) {
+            visible = true;
+        }
+    }
+    item->setHidden(!visible);
+    if (visible && !matches) {
+        item->setExpanded(true);
+    }
+    return visible;
+}
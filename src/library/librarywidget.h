@@ -29,6 +29,7 @@
 #define LIBRARYWIDGET_H
 
 #include "definitions.h"
+#include "libraryindex.h"
 
 #include <QTreeWidget>
 #include <QDir>
@@ -37,6 +38,8 @@
 #include <QApplication>
 #include <QPainter>
 #include <QMutex>
+#include <QHash>
+#include <QSet>
 
 #include <KMessageWidget>
 #include <KIOCore/KFileItem>
@@ -48,6 +51,7 @@ class ProjectManager;
 class KJob;
 class QProgressBar;
 class QToolBar;
+class QLineEdit;
 
 /**
  * @class BinItemDelegate
@@ -154,7 +158,6 @@ protected:
 
 public slots:
     void slotUpdateThumb(const QString &path, const QString &iconPath);
-    void slotUpdateThumb(const QString &path, const QPixmap &pix);
 
 signals:
     void moveData(const QList<QUrl> &, const QString &);
@@ -167,6 +170,7 @@ class LibraryWidget : public QWidget
 
 public:
     explicit LibraryWidget(ProjectManager *m_manager, QWidget *parent = nullptr);
+    ~LibraryWidget();
     void setupActions(const QList<QAction *> &list);
 
 public slots:
@@ -187,7 +191,11 @@ private slots:
     void slotGotPreview(const KFileItem &item, const QPixmap &pix);
     void slotItemsAdded(const QUrl &url, const KFileItemList &list);
     void slotItemsDeleted(const KFileItemList &list);
-    void slotClearAll();
+    void slotItemsRefreshed(const QList<QPair<KFileItem, KFileItem> > &list);
+    /** @brief A folder was listed, remove indexed items that do not exist anymore. */
+    void slotListingCompleted(const QUrl &url);
+    /** @brief Only show items whose name contains @param text. */
+    void slotFilterItems(const QString &text);
 
 private:
     LibraryTree *m_libraryTree;
@@ -198,12 +206,28 @@ private:
     QTimer m_timer;
     KMessageWidget *m_infoWidget;
     ProjectManager *m_manager;
-    QList<QTreeWidgetItem *> m_folders;
+    QLineEdit *m_searchLine;
+    /** @brief Tree items by absolute path. */
+    QHash<QString, QTreeWidgetItem *> m_items;
+    /** @brief Paths reported by the dir lister since the library was opened. */
+    QSet<QString> m_listedItems;
+    LibraryIndex m_index;
+    QTimer m_saveTimer;
     KIO::PreviewJob *m_previewJob;
     KCoreDirLister *m_coreLister;
     QMutex m_treeMutex;
     QDir m_directory;
     void showMessage(const QString &text, KMessageWidget::MessageType type = KMessageWidget::Warning);
+    /** @brief Load the index of the library folder and display its content. */
+    void loadIndex();
+    void clearItems();
+    QTreeWidgetItem *createItem(const QString &path, const LibraryIndex::Entry &entry);
+    void updateItem(QTreeWidgetItem *item, const QString &path, const LibraryIndex::Entry &entry);
+    /** @brief Remove @param path, and its content if it is a folder, from the index and the tree. */
+    void removeItem(const QString &path);
+    /** @brief Update the index and tree for new or modified files, and create thumbnails if needed. */
+    void processItems(const KFileItemList &list);
+    bool filterItem(QTreeWidgetItem *item, const QString &text);
 
 signals:
     void addProjectClips(const QList<QUrl> &);
@@ -49,6 +49,7 @@
 #include "dialogs/wizard.h"
 #include "project/projectcommands.h"
 #include "titler/titlewidget.h"
+#include "titler/titlecache.h"
 #include "timeline/markerdialog.h"
 #include "timeline/clipitem.h"
 #include "project/cliptranscode.h"
@@ -59,6 +60,7 @@
 #include "hidetitlebars.h"
 #include "mltconnection.h"
 #include "project/projectmanager.h"
+#include "project/cachemanager.h"
 #include "timeline/timelinesearch.h"
 #include <config-kdenlive.h>
 #include "utils/thememanager.h"
@@ -2191,6 +2193,7 @@ void MainWindow::updateConfiguration()
     // Update list of transcoding profiles
     buildDynamicActions();
     loadClipActions();
+    pCore->cacheManager()->checkQuota();
 }
 
 void MainWindow::slotSwitchSplitAudio(bool enable)
@@ -3562,6 +3565,9 @@ void MainWindow::slotPrepareRendering(bool scriptExport, bool zoneOnly, const QS
         }
     }
 
+    // Static titles are rendered from cached images
+    TitleCache::replaceStaticTitles(doc);
+
     QList<QDomDocument> docList;
 
     // check which audio tracks have to be exported
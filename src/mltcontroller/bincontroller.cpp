@@ -19,6 +19,7 @@
 
 #include "bincontroller.h"
 #include "clipcontroller.h"
+#include "lib/audio/audioStreamInfo.h"
 #include "kdenlivesettings.h"
 #include "timeline/clip.h"
 
@@ -464,6 +465,17 @@ const QList<ClipController *> BinController::getControllerList() const
     return m_clipList.values();
 }
 
+int BinController::audioChannels() const
+{
+    int channels = 0;
+    for (ClipController *ctrl : m_clipList) {
+        if (ctrl->audioInfo()) {
+            channels = qMax(channels, ctrl->audioInfo()->channels());
+        }
+    }
+    return channels > 0 ? channels : 2;
+}
+
 const QStringList BinController::getBinIdsByResource(const QFileInfo &url) const
 {
     QStringList controllers;
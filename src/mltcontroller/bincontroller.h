@@ -129,6 +129,8 @@ public:
 
     ClipController *getController(const QString &id);
     const QList<ClipController *> getControllerList() const;
+    /** @brief Returns the highest audio channel count of the bin clips, 2 if no clip has audio. */
+    int audioChannels() const;
     void replaceBinPlaylistClip(const QString &id, Mlt::Producer &producer);
 
     /** @brief Get the list of ids whose clip have the resource indicated by @param url */
@@ -25,11 +25,13 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "definitions.h"
 
 #include <QMutex>
-#include <QFuture>
+#include <QThreadPool>
 
 class ClipController;
 class BinController;
 
+class QLocale;
+
 namespace Mlt
 {
 class Producer;
@@ -56,14 +58,33 @@ public:
     bool isProcessing(const QString &id);
     /** @brief Make sure to close running threads before closing document */
     void abortOperations();
+    /** @brief Move the pending requests for these clips (visible in bin, used in timeline) ahead of the others. */
+    void prioritize(const QStringList &ids);
 
 private:
     QMutex m_infoMutex;
+    /** @brief Serializes the bin updates done by the worker threads. */
+    QMutex m_publishMutex;
     QList<requestClipInfo> m_requestList;
     /** @brief The ids of the clips that are currently being loaded for info query */
     QStringList m_processingClipId;
-    QFuture <void> m_infoThread;
+    /** @brief The ids of the clips currently handled by a worker, a clip is never handled by two workers at once */
+    QStringList m_probingClipId;
+    /** @brief The worker threads building producers */
+    QThreadPool m_probePool;
+    int m_runningWorkers;
+    /** @brief A request that may change the project profile is running, others have to wait */
+    bool m_exclusiveRunning;
     BinController *m_binController;
+    /** @brief Start workers for the pending requests, m_infoMutex must be locked */
+    void startWorkers();
+    /** @brief Index of the next request a worker should process, or -1. m_infoMutex must be locked */
+    int nextRequest() const;
+    /** @brief Returns true if this request must be processed while no other one is running */
+    static bool isExclusive(const requestClipInfo &info);
+    /** @brief Build the producer and thumbnail for a request */
+    void processClip(requestClipInfo info, const QLocale &locale, bool forceThumbScale);
+    void clipProcessed(const QString &id);
     ClipType getTypeForService(const QString &id, const QString &path) const;
     /** @brief Pass xml values to an MLT producer at build time */
     void processProducerProperties(Mlt::Producer *prod, const QDomElement &xml);
@@ -80,7 +101,7 @@ public slots:
     void slotProcessingDone(const QString &id);
 
 private slots:
-    /** @brief Process the clip info requests (in a separate thread). */
+    /** @brief Process the clip info requests (in a worker thread). */
     void processFileProperties();
     /** @brief A clip with multiple video streams was found, ask what to do. */
     void slotMultiStreamProducerFound(const QString &path, const QList<int> &audio_list, const QList<int> &video_list, stringMap data);
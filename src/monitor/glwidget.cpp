@@ -85,6 +85,12 @@ GLWidget::GLWidget(int id, QObject *parent)
     , m_offset(QPoint(0, 0))
     , m_shareContext(nullptr)
     , m_audioWaveDisplayed(false)
+    , m_audioLevelsEnabled(false)
+    , m_audioChannels(2)
+    , m_audioFrequency(48000)
+    , m_previewScale(1)
+    , m_scaleDrops(0)
+    , m_scaleHeadroom(0)
     , m_fbo(nullptr)
 {
     m_texture[0] = m_texture[1] = m_texture[2] = 0;
@@ -101,6 +107,7 @@ GLWidget::GLWidget(int id, QObject *parent)
     m_offscreenSurface.create();
 
     m_monitorProfile = new Mlt::Profile();
+    m_consumerProfile = new Mlt::Profile();
 
     if (KdenliveSettings::gpu_accel()) {
         m_glslManager = new Mlt::Filter(*m_monitorProfile, "glsl.manager");
@@ -138,6 +145,7 @@ GLWidget::~GLWidget()
     delete m_shareContext;
     delete m_shader;
     delete m_monitorProfile;
+    delete m_consumerProfile;
 }
 
 void GLWidget::updateAudioForAnalysis()
@@ -147,6 +155,25 @@ void GLWidget::updateAudioForAnalysis()
     }
 }
 
+void GLWidget::setAudioLevelsEnabled(bool enable)
+{
+    m_audioLevelsEnabled = enable;
+    if (m_frameRenderer) {
+        m_frameRenderer->sendAudioLevels.store(enable ? 1 : 0);
+    }
+}
+
+void GLWidget::setAudioFormat(int channels, int frequency)
+{
+    m_audioChannels = channels;
+    m_audioFrequency = frequency;
+}
+
+bool GLWidget::readAudioLevels(AudioLevels &levels)
+{
+    return m_frameRenderer && m_frameRenderer->audioLevels.read(levels);
+}
+
 void GLWidget::initializeGL()
 {
     if (m_isInitialized || !isVisible() || !openglContext()) return;
@@ -199,6 +226,7 @@ void GLWidget::initializeGL()
     }
     m_frameRenderer = new FrameRenderer(openglContext(), &m_offscreenSurface);
     m_frameRenderer->sendAudioForAnalysis = KdenliveSettings::monitor_audio();
+    m_frameRenderer->sendAudioLevels.store(m_audioLevelsEnabled ? 1 : 0);
     openglContext()->makeCurrent(this);
     //openglContext()->blockSignals(false);
     connect(m_frameRenderer, &FrameRenderer::frameDisplayed, this, &GLWidget::frameDisplayed, Qt::QueuedConnection);
@@ -237,8 +265,9 @@ void GLWidget::resizeGL(int width, int height)
     x = (width - w) / 2;
     y = (height - h) / 2;
     m_rect.setRect(x, y, w, h);
-    double scalex = (double) m_rect.width() / m_monitorProfile->width() * m_zoom;
-    double scaley = (double) m_rect.width() / ((double) m_monitorProfile->height() * m_monitorProfile->dar() / m_monitorProfile->width()) / m_monitorProfile->width() * m_zoom;
+    const QSize size = profileSize();
+    double scalex = (double) m_rect.width() / size.width() * m_zoom;
+    double scaley = (double) m_rect.width() / ((double) size.height() * m_monitorProfile->dar() / size.width()) / size.width() * m_zoom;
     QPoint center = m_rect.center();
     QQuickItem *rootQml = rootObject();
     if (rootQml) {
@@ -482,8 +511,8 @@ void GLWidget::paintGL()
 
     if (m_sendFrame && m_analyseSem.tryAcquire(1)) {
         // Render RGB frame for analysis
-        int fullWidth = m_monitorProfile->width();
-        int fullHeight = m_monitorProfile->height();
+        int fullWidth = profileSize().width();
+        int fullHeight = profileSize().height();
         if (!m_fbo || m_fbo->size() != QSize(fullWidth, fullHeight)) {
             delete m_fbo;
             QOpenGLFramebufferObjectFormat fmt;
@@ -781,6 +810,69 @@ void GLWidget::resetDrops()
     }
 }
 
+void GLWidget::updatePreviewScale()
+{
+    if (!m_consumer || !KdenliveSettings::monitor_autoscale()) {
+        return;
+    }
+    if (!m_scaleTimer.isValid()) {
+        m_scaleTimer.start();
+        m_scaleDrops = droppedFrames();
+        return;
+    }
+    if (!m_scaleTimer.hasExpired(1000)) {
+        return;
+    }
+    // The drop counter is also reset by the monitor fps display
+    int drops = droppedFrames();
+    int dropped = drops >= m_scaleDrops ? drops - m_scaleDrops : drops;
+    m_scaleDrops = drops;
+    m_scaleTimer.start();
+    if (dropped > 1) {
+        m_scaleHeadroom = 0;
+        if (m_previewScale < 4) {
+            setPreviewScale(m_previewScale * 2);
+        }
+    } else if (dropped == 0 && m_previewScale > 1 && ++m_scaleHeadroom >= 5) {
+        // Go back up only after a few seconds without drops to avoid oscillating
+        m_scaleHeadroom = 0;
+        setPreviewScale(m_previewScale / 2);
+    }
+}
+
+void GLWidget::resetPreviewScale()
+{
+    m_scaleTimer.invalidate();
+    m_scaleHeadroom = 0;
+    if (m_previewScale == 1) {
+        return;
+    }
+    setPreviewScale(1);
+    if (m_consumer) {
+        // Render the current frame again at full resolution
+        m_consumer->set("refresh", 1);
+    }
+}
+
+void GLWidget::setPreviewScale(int scale)
+{
+    if (!m_consumer || scale == m_previewScale) {
+        return;
+    }
+    m_previewScale = scale;
+    // The consumer applies its size to its private profile only, so producers process smaller images
+    // while the project profile (used for transitions, saving and rendering) keeps its real size.
+    // Frames are uploaded at their own size and stretched to the display rect.
+    int width = m_monitorProfile->width() / scale;
+    int height = m_monitorProfile->height() / scale;
+    width -= width % 2;
+    height -= height % 2;
+    qCDebug(KDENLIVE_LOG) << "Monitor" << m_id << "preview scale 1 /" << scale << width << "x" << height;
+    m_consumer->set("width", width);
+    m_consumer->set("height", height);
+    m_consumer->purge();
+}
+
 void GLWidget::createAudioOverlay(bool isAudio)
 {
     if (!m_consumer) {
@@ -959,11 +1051,12 @@ int GLWidget::reconfigure(Mlt::Profile *profile)
             delete m_consumer;
             m_consumer = nullptr;
         }
+        updateConsumerProfile();
         // Force rtaudio backend for movit, because with SDL it crashes on stop/start
         //QString audioBackend = m_glslManager == nullptr ? KdenliveSettings::audiobackend() : QStringLiteral("rtaudio");
         QString audioBackend = KdenliveSettings::audiobackend();
         if (m_consumer == nullptr || serviceName.isEmpty() || serviceName != audioBackend) {
-            m_consumer = new Mlt::FilteredConsumer(*m_monitorProfile, audioBackend.toLatin1().constData());
+            m_consumer = new Mlt::FilteredConsumer(*m_consumerProfile, audioBackend.toLatin1().constData());
             if (m_consumer->is_valid()) {
                 serviceName = audioBackend;
                 setProperty("mlt_service", serviceName);
@@ -977,7 +1070,7 @@ int GLWidget::reconfigure(Mlt::Profile *profile)
                         // Already tested
                         continue;
                     }
-                    m_consumer = new Mlt::FilteredConsumer(*m_monitorProfile, bk.toLatin1().constData());
+                    m_consumer = new Mlt::FilteredConsumer(*m_consumerProfile, bk.toLatin1().constData());
                     if (m_consumer->is_valid()) {
                         if (audioBackend == KdenliveSettings::sdlAudioBackend()) {
                             // switch sdl audio backend
@@ -1057,6 +1150,8 @@ int GLWidget::reconfigure(Mlt::Profile *profile)
         /*if (!m_monitorProfile->progressive())
             m_consumer->set("progressive", property("progressive").toBool());*/
         m_consumer->set("volume", (double)volume / 100);
+        m_consumer->set("channels", m_audioChannels);
+        m_consumer->set("frequency", m_audioFrequency);
         //m_consumer->set("progressive", 1);
         m_consumer->set("rescale", KdenliveSettings::mltinterpolation().toUtf8().constData());
         m_consumer->set("deinterlace_method", KdenliveSettings::mltdeinterlacer().toUtf8().constData());
@@ -1082,7 +1177,7 @@ float GLWidget::zoom() const
 
 float GLWidget::scale() const
 {
-    return (double) m_rect.width() / m_monitorProfile->width() * m_zoom;
+    return (double) m_rect.width() / profileSize().width() * m_zoom;
 }
 
 Mlt::Profile *GLWidget::profile()
@@ -1106,6 +1201,7 @@ void GLWidget::resetProfile(const MltVideoProfile &profile)
     m_monitorProfile->set_sample_aspect(profile.sample_aspect_num, profile.sample_aspect_den);
     m_monitorProfile->set_display_aspect(profile.display_aspect_num, profile.display_aspect_den);
     m_monitorProfile->set_explicit(true);
+    updateConsumerProfile();
     reconfigure();
     refreshSceneLayout();
 }
@@ -1121,11 +1217,31 @@ void GLWidget::reloadProfile(Mlt::Profile &profile)
     m_monitorProfile->set_sample_aspect(profile.sample_aspect_num(), profile.sample_aspect_den());
     m_monitorProfile->set_display_aspect(profile.display_aspect_num(), profile.display_aspect_den());
     m_monitorProfile->set_explicit(true);
+    updateConsumerProfile();
     // The profile display aspect ratio may have changed.
     resizeGL(width(), height());
     refreshSceneLayout();
 }
 
+void GLWidget::updateConsumerProfile()
+{
+    m_previewScale = 1;
+    free(m_consumerProfile->get_profile()->description);
+    m_consumerProfile->get_profile()->description = m_monitorProfile->description() ? strdup(m_monitorProfile->description()) : nullptr;
+    m_consumerProfile->set_colorspace(m_monitorProfile->colorspace());
+    m_consumerProfile->set_frame_rate(m_monitorProfile->frame_rate_num(), m_monitorProfile->frame_rate_den());
+    m_consumerProfile->set_height(m_monitorProfile->height());
+    m_consumerProfile->set_width(m_monitorProfile->width());
+    m_consumerProfile->set_progressive(m_monitorProfile->progressive());
+    m_consumerProfile->set_sample_aspect(m_monitorProfile->sample_aspect_num(), m_monitorProfile->sample_aspect_den());
+    m_consumerProfile->set_display_aspect(m_monitorProfile->display_aspect_num(), m_monitorProfile->display_aspect_den());
+    m_consumerProfile->set_explicit(true);
+    if (m_consumer) {
+        m_consumer->set("width", m_monitorProfile->width());
+        m_consumer->set("height", m_monitorProfile->height());
+    }
+}
+
 QSize GLWidget::profileSize() const
 {
     return QSize(m_monitorProfile->width(), m_monitorProfile->height());
@@ -1138,8 +1254,9 @@ QRect GLWidget::displayRect() const
 
 QPoint GLWidget::offset() const
 {
-    return QPoint(m_offset.x() - (m_monitorProfile->width()  * m_zoom -  width()) / 2,
-                  m_offset.y() - (m_monitorProfile->height() * m_zoom - height()) / 2);
+    const QSize size = profileSize();
+    return QPoint(m_offset.x() - (size.width()  * m_zoom -  width()) / 2,
+                  m_offset.y() - (size.height() * m_zoom - height()) / 2);
 }
 
 void GLWidget::setZoom(float zoom)
@@ -1317,6 +1434,7 @@ FrameRenderer::FrameRenderer(QOpenGLContext *shareContext, QSurface *surface)
     , m_surface(surface)
     , m_gl32(nullptr)
     , sendAudioForAnalysis(false)
+    , sendAudioLevels(0)
 {
     Q_ASSERT(shareContext);
     m_renderTexture[0] = m_renderTexture[1] = m_renderTexture[2] = 0;
@@ -1341,6 +1459,9 @@ FrameRenderer::~FrameRenderer()
 
 void FrameRenderer::showFrame(Mlt::Frame frame)
 {
+    if (sendAudioLevels.load()) {
+        audioLevels.publish(frame);
+    }
     int width = 0;
     int height = 0;
     mlt_image_format format = mlt_image_yuv420p;
@@ -1371,6 +1492,9 @@ void FrameRenderer::showFrame(Mlt::Frame frame)
 
 void FrameRenderer::showGLFrame(Mlt::Frame frame)
 {
+    if (sendAudioLevels.load()) {
+        audioLevels.publish(frame);
+    }
     if (m_context && m_context->isValid()) {
         int width = 0;
         int height = 0;
@@ -1416,6 +1540,9 @@ void FrameRenderer::showGLFrame(Mlt::Frame frame)
 
 void FrameRenderer::showGLNoSyncFrame(Mlt::Frame frame)
 {
+    if (sendAudioLevels.load()) {
+        audioLevels.publish(frame);
+    }
     if (m_context && m_context->isValid()) {
         int width = 0;
         int height = 0;
@@ -1511,7 +1638,8 @@ void GLWidget::refreshSceneLayout()
     if (!rootObject()) {
         return;
     }
-    rootObject()->setProperty("profile", QPoint(m_monitorProfile->width(), m_monitorProfile->height()));
-    rootObject()->setProperty("scalex", (double) m_rect.width() / m_monitorProfile->width() * m_zoom);
-    rootObject()->setProperty("scaley", (double) m_rect.width() / (((double) m_monitorProfile->height() * m_monitorProfile->dar() / m_monitorProfile->width())) / m_monitorProfile->width() * m_zoom);
+    const QSize size = profileSize();
+    rootObject()->setProperty("profile", QPoint(size.width(), size.height()));
+    rootObject()->setProperty("scalex", (double) m_rect.width() / size.width() * m_zoom);
+    rootObject()->setProperty("scaley", (double) m_rect.width() / (((double) size.height() * m_monitorProfile->dar() / size.width())) / size.width() * m_zoom);
 }
@@ -29,8 +29,11 @@
 #include <QMutex>
 #include <QThread>
 #include <QRect>
+#include <QElapsedTimer>
+#include <QAtomicInt>
 
 #include "scopes/sharedframe.h"
+#include "scopes/audiolevels.h"
 #include "definitions.h"
 
 class QOpenGLFunctions_3_2_Core;
@@ -73,6 +76,13 @@ public:
         return m_rect.width();
     }
     void updateAudioForAnalysis();
+    /** @brief Enable the computation of audio levels for the meter in the frame rendering thread. */
+    void setAudioLevelsEnabled(bool enable);
+    /** @brief Get the levels of the last displayed frame, returns false if there are no new levels. */
+    bool readAudioLevels(AudioLevels &levels);
+    /** @brief Request audio with @param channels and @param frequency from the producer, so that it is played and metered without downmixing.
+     *  Applied when the next producer is set. */
+    void setAudioFormat(int channels, int frequency);
     int displayHeight() const
     {
         return m_rect.height();
@@ -113,6 +123,10 @@ public:
     void setAudioThumb(int channels = 0, const QVariantList &audioCache = QList<QVariant>());
     int droppedFrames() const;
     void resetDrops();
+    /** @brief Lower the preview resolution when frames are dropped during playback, raise it again when there is headroom. */
+    void updatePreviewScale();
+    /** @brief Go back to a full resolution preview, so that a paused frame is pixel-exact. */
+    void resetPreviewScale();
 
 protected:
     void mouseReleaseEvent(QMouseEvent *event) Q_DECL_OVERRIDE;
@@ -171,6 +185,8 @@ private:
     Mlt::Event *m_threadJoinEvent;
     Mlt::Event *m_displayEvent;
     Mlt::Profile *m_monitorProfile;
+    /** @brief Copy of the monitor profile used by the consumer, resized when the preview is scaled. */
+    Mlt::Profile *m_consumerProfile;
     FrameRenderer *m_frameRenderer;
     int m_projectionLocation;
     int m_modelViewLocation;
@@ -187,6 +203,18 @@ private:
     QOffscreenSurface m_offscreenSurface;
     QOpenGLContext *m_shareContext;
     bool m_audioWaveDisplayed;
+    bool m_audioLevelsEnabled;
+    int m_audioChannels;
+    int m_audioFrequency;
+    /** @brief Divider of the profile size used for processing (1, 2 or 4). */
+    int m_previewScale;
+    QElapsedTimer m_scaleTimer;
+    int m_scaleDrops;
+    /** @brief Number of seconds played without dropped frames at the current scale. */
+    int m_scaleHeadroom;
+    void setPreviewScale(int scale);
+    /** @brief Copy the monitor profile to the consumer profile, resetting the preview scale. */
+    void updateConsumerProfile();
     static void on_frame_show(mlt_consumer, void *self, mlt_frame frame);
     static void on_gl_frame_show(mlt_consumer, void *self, mlt_frame frame_ptr);
     static void on_gl_nosync_frame_show(mlt_consumer, void *self, mlt_frame frame_ptr);
@@ -266,6 +294,9 @@ public:
     GLuint m_displayTexture[3];
     QOpenGLFunctions_3_2_Core *m_gl32;
     bool sendAudioForAnalysis;
+    /** @brief Set from the GUI thread, read in the rendering thread. */
+    QAtomicInt sendAudioLevels;
+    AudioLevelsChannel audioLevels;
 };
 
 #endif
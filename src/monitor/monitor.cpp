@@ -335,14 +335,9 @@ Monitor::Monitor(Kdenlive::MonitorId id, MonitorManager *manager, QWidget *paren
     int tm = 0;
     int bm = 0;
     m_toolbar->getContentsMargins(nullptr, &tm, nullptr, &bm);
-    m_audioMeterWidget = new MonitorAudioLevel(m_glMonitor->profile(), m_toolbar->height() - tm - bm, this);
+    m_audioMeterWidget = new MonitorAudioLevel(m_toolbar->height() - tm - bm, this);
     m_toolbar->addWidget(m_audioMeterWidget);
-    if (!m_audioMeterWidget->isValid) {
-        KdenliveSettings::setMonitoraudio(0x01);
-        m_audioMeterWidget->setVisibility(false);
-    } else {
-        m_audioMeterWidget->setVisibility((KdenliveSettings::monitoraudio() & m_id) != 0);
-    }
+    m_audioMeterWidget->setVisibility((KdenliveSettings::monitoraudio() & m_id) != 0);
 
     connect(m_timePos, SIGNAL(timeCodeEditingFinished()), this, SLOT(slotSeek()));
     layout->addWidget(m_toolbar);
@@ -508,6 +503,10 @@ void Monitor::setupMenu(QMenu *goMenu, QMenu *overlayMenu, QAction *playZone, QA
     switchAudioMonitor->setCheckable(true);
     switchAudioMonitor->setChecked(KdenliveSettings::monitoraudio() & m_id);
     m_configMenu->addAction(overlayAudio);
+    QAction *autoScale = m_configMenu->addAction(i18n("Automatic Preview Scaling"));
+    autoScale->setCheckable(true);
+    autoScale->setChecked(KdenliveSettings::monitor_autoscale());
+    connect(autoScale, &QAction::toggled, this, &Monitor::slotSwitchAutoScale);
     m_configMenu->addAction(m_zoomVisibilityAction);
     m_contextMenu->addAction(m_zoomVisibilityAction);
     // For some reason, the frame in QAbstracSpinBox (base class of TimeCodeDisplay) needs to be displayed once, then hidden
@@ -1419,18 +1418,19 @@ void Monitor::slotOpenClip(ClipController *controller, int in, int out)
         if (m_playAction->isActive()) {
             m_playAction->setActive(false);
         }
+        // Play and meter the clip audio in its own format
+        AudioStreamInfo *audioInfo = controller->audioInfo();
+        m_glMonitor->setAudioFormat(audioInfo && audioInfo->channels() > 0 ? audioInfo->channels() : 2, audioInfo && audioInfo->samplingRate() > 0 ? audioInfo->samplingRate() : 48000);
         render->setProducer(m_controller->masterProducer(), in, isActive());
         if (out > -1) {
             m_ruler->setZone(in, out);
             setClipZone(QPoint(in, out));
         }
-        m_audioMeterWidget->audioChannels = controller->audioInfo() ? controller->audioInfo()->channels() : 0;
         emit requestAudioThumb(controller->clipId());
         //hasEffects =  controller->hasEffects();
     } else {
         render->setProducer(nullptr, -1, isActive());
         m_glMonitor->setAudioThumb();
-        m_audioMeterWidget->audioChannels = 0;
     }
     checkOverlay();
 }
@@ -1514,6 +1514,14 @@ void Monitor::switchDropFrames(bool drop)
     render->setDropFrames(drop);
 }
 
+void Monitor::slotSwitchAutoScale(bool enable)
+{
+    KdenliveSettings::setMonitor_autoscale(enable);
+    if (!enable) {
+        m_glMonitor->resetPreviewScale();
+    }
+}
+
 void Monitor::switchMonitorInfo(int code)
 {
     int currentOverlay;
@@ -1735,6 +1743,10 @@ void Monitor::updateAudioForAnalysis()
 void Monitor::onFrameDisplayed(const SharedFrame &frame)
 {
     m_monitorManager->frameDisplayed(frame);
+    AudioLevels levels;
+    if (m_glMonitor->readAudioLevels(levels)) {
+        m_audioMeterWidget->setAudioLevels(levels);
+    }
     int position = frame.get_position();
     seekCursor(position);
     if (!render->checkFrameNumber(position)) {
@@ -2145,17 +2157,17 @@ void Monitor::prepareAudioThumb(int channels, QVariantList &audioCache)
 
 void Monitor::slotUpdateQmlTimecode(const QString &tc)
 {
+    if (render->isPlaying()) {
+        m_glMonitor->updatePreviewScale();
+    } else {
+        m_glMonitor->resetPreviewScale();
+    }
     checkDrops(m_glMonitor->droppedFrames());
     m_glMonitor->rootObject()->setProperty("timecode", tc);
 }
 
 void Monitor::slotSwitchAudioMonitor()
 {
-    if (!m_audioMeterWidget->isValid) {
-        KdenliveSettings::setMonitoraudio(0x01);
-        m_audioMeterWidget->setVisibility(false);
-        return;
-    }
     int currentOverlay = KdenliveSettings::monitoraudio();
     currentOverlay ^= m_id;
     KdenliveSettings::setMonitoraudio(currentOverlay);
@@ -2169,11 +2181,8 @@ void Monitor::slotSwitchAudioMonitor()
 void Monitor::displayAudioMonitor(bool isActive)
 {
     bool enable = isActive && (KdenliveSettings::monitoraudio() & m_id);
-    if (enable) {
-        connect(m_monitorManager, &MonitorManager::frameDisplayed, m_audioMeterWidget, &ScopeWidget::onNewFrame, Qt::UniqueConnection);
-    } else {
-        disconnect(m_monitorManager, &MonitorManager::frameDisplayed, m_audioMeterWidget, &ScopeWidget::onNewFrame);
-    }
+    // Levels are computed in the frame rendering thread and read when the frame is displayed
+    m_glMonitor->setAudioLevelsEnabled(enable);
     m_audioMeterWidget->setVisibility((KdenliveSettings::monitoraudio() & m_id) != 0);
 }
 
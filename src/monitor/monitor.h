@@ -327,6 +327,8 @@ public slots:
     void slotGetCurrentImage(bool request);
     /** @brief Enable/disable display of monitor's audio levels widget */
     void slotSwitchAudioMonitor();
+    /** @brief Enable or disable the automatic preview scaling during playback. */
+    void slotSwitchAutoScale(bool enable);
 
 signals:
     void renderPosition(int);
@@ -26,11 +26,13 @@
 #include "capture/managecapturesdialog.h"
 #include "dialogs/profilesdialog.h"
 #include "utils/KoIconUtils.h"
+#include "kdenlive_debug.h"
 
 #include <KMessageBox>
 #include "klocalizedstring.h"
 
 #include <QComboBox>
+#include <QLabel>
 #include <QToolBar>
 #include <QDesktopWidget>
 #include <QStandardPaths>
@@ -43,6 +45,12 @@ RecManager::RecManager(Monitor *parent) :
     , m_captureProcess(nullptr)
     , m_recToolbar(new QToolBar(parent))
     , m_screenCombo(nullptr)
+    , m_previousProcess(nullptr)
+    , m_pendingProcess(nullptr)
+    , m_pendingFrames(0)
+    , m_fallback(false)
+    , m_lateReports(0)
+    , m_startFrames(0)
 {
     m_playAction = m_recToolbar->addAction(KoIconUtils::themedIcon(QStringLiteral("media-playback-start")), i18n("Preview"));
     m_playAction->setCheckable(true);
@@ -73,6 +81,9 @@ RecManager::RecManager(Monitor *parent) :
         // Update screen grab monitor choice in case we changed from fullscreen
         m_screenCombo->setEnabled(KdenliveSettings::grab_capture_type() == 0);
     }
+    m_healthLabel = new QLabel(parent);
+    m_healthLabel->setToolTip(i18n("Captured frames, dropped or duplicated frames and frames missing compared to the elapsed recording time"));
+    m_recToolbar->addWidget(m_healthLabel);
     QWidget *spacer = new QWidget(parent);
     spacer->setSizePolicy(QSizePolicy::MinimumExpanding, QSizePolicy::Preferred);
     m_recToolbar->addWidget(spacer);
@@ -212,6 +223,7 @@ void RecManager::slotRecord(bool record)
         if (!m_captureProcess) {
             return;
         }
+        discardPendingCapture();
         m_captureProcess->terminate();
         QTimer::singleShot(1500, m_captureProcess, &QProcess::kill);
         return;
@@ -220,8 +232,19 @@ void RecManager::slotRecord(bool record)
         return;
     }
     m_recError.clear();
+    m_fallback = false;
+    startScreenGrab(false);
+}
+
+// Video encoding options of the screen grab profile, replaced when using the fallback codec
+static const QStringList videoCodecOptions = QStringList() << QStringLiteral("-vcodec") << QStringLiteral("-c:v") << QStringLiteral("-codec:v")
+                                                           << QStringLiteral("-crf") << QStringLiteral("-preset") << QStringLiteral("-tune")
+                                                           << QStringLiteral("-profile:v") << QStringLiteral("-b:v") << QStringLiteral("-pix_fmt")
+                                                           << QStringLiteral("-x264opts") << QStringLiteral("-x264-params");
 
-    QString extension = KdenliveSettings::grab_extension();
+bool RecManager::startScreenGrab(bool fallback)
+{
+    QString extension = fallback ? QStringLiteral("mkv") : KdenliveSettings::grab_extension();
     QDir captureFolder;
     if (KdenliveSettings::capturetoprojectfolder()) {
         captureFolder = QDir(m_monitor->projectFolder());
@@ -235,12 +258,14 @@ void RecManager::slotRecord(bool record)
         m_recAction->blockSignals(true);
         m_recAction->setChecked(false);
         m_recAction->blockSignals(false);
-        return;
+        return false;
     }
 
-    m_captureProcess = new QProcess;
-    connect(m_captureProcess, &QProcess::stateChanged, this, &RecManager::slotProcessStatus);
-    connect(m_captureProcess, &QProcess::readyReadStandardError, this, &RecManager::slotReadProcessInfo);
+    // The process only becomes the current capture once started, a failed fallback keeps the running capture
+    QProcess *process = new QProcess;
+    connect(process, &QProcess::stateChanged, this, &RecManager::slotProcessStatus);
+    connect(process, &QProcess::readyReadStandardError, this, &RecManager::slotReadProcessInfo);
+    connect(process, &QProcess::readyReadStandardOutput, this, &RecManager::slotReadProgress);
 
     QString path = captureFolder.absoluteFilePath("capture0000." + extension);
     int i = 1;
@@ -249,7 +274,6 @@ void RecManager::slotRecord(bool record)
         path = captureFolder.absoluteFilePath("capture" + num + QLatin1Char('.') + extension);
         ++i;
     }
-    m_captureFile = QUrl::fromLocalFile(path);
     QString captureSize;
     int screen = -1;
     if (m_screenCombo) {
@@ -258,6 +282,8 @@ void RecManager::slotRecord(bool record)
     }
     QRect screenSize = QApplication::desktop()->screenGeometry(screen);
     QStringList captureArgs;
+    // Machine readable progress reports on stdout, the statistics are still written to stderr for the log
+    captureArgs << QStringLiteral("-progress") << QStringLiteral("pipe:1");
     captureArgs << QStringLiteral("-f") << QStringLiteral("x11grab");
     if (KdenliveSettings::grab_follow_mouse()) {
         captureArgs << QStringLiteral("-follow_mouse") << QStringLiteral("centered");
@@ -281,25 +307,169 @@ void RecManager::slotRecord(bool record)
         captureSize.append(QStringLiteral("+nomouse"));
     }
     captureArgs << QStringLiteral("-i") << captureSize;
+    QStringList parameters;
     if (!KdenliveSettings::grab_parameters().simplified().isEmpty()) {
-        captureArgs << KdenliveSettings::grab_parameters().simplified().split(QLatin1Char(' '));
+        parameters = KdenliveSettings::grab_parameters().simplified().split(QLatin1Char(' '));
+    }
+    if (fallback) {
+        // Keep the audio and input parameters, replace the video encoding
+        for (int j = 0; j < parameters.count(); j++) {
+            if (videoCodecOptions.contains(parameters.at(j))) {
+                parameters.removeAt(j);
+                if (j < parameters.count()) {
+                    parameters.removeAt(j);
+                }
+                j--;
+            }
+        }
+        parameters << KdenliveSettings::grab_fallback_parameters().simplified().split(QLatin1Char(' '), QString::SkipEmptyParts);
     }
+    captureArgs << parameters;
     captureArgs << path;
 
-    m_captureProcess->start(KdenliveSettings::ffmpegpath(), captureArgs);
-    if (!m_captureProcess->waitForStarted()) {
+    process->start(KdenliveSettings::ffmpegpath(), captureArgs);
+    if (!process->waitForStarted()) {
         // Problem launching capture app
         emit warningMessage(i18n("Failed to start the capture application:\n%1", KdenliveSettings::ffmpegpath()));
-        //delete m_captureProcess;
+        if (!fallback) {
+            m_recAction->blockSignals(true);
+            m_recAction->setChecked(false);
+            m_recAction->blockSignals(false);
+        }
+        return false;
+    }
+    if (fallback) {
+        m_pendingProcess = process;
+        m_pendingFile = QUrl::fromLocalFile(path);
+        m_pendingFrames = 0;
+        return true;
+    }
+    m_captureProcess = process;
+    m_captureFile = QUrl::fromLocalFile(path);
+    m_progress.clear();
+    m_lateReports = 0;
+    m_startFrames = -1;
+    m_healthLabel->clear();
+    return true;
+}
+
+void RecManager::slotReadProgress()
+{
+    QProcess *process = qobject_cast<QProcess *>(sender());
+    if (!process) {
+        return;
+    }
+    while (process->canReadLine()) {
+        const QString line = QString::fromUtf8(process->readLine()).trimmed();
+        const QString key = line.section(QLatin1Char('='), 0, 0);
+        if (process == m_pendingProcess) {
+            if (key == QLatin1String("frame")) {
+                m_pendingFrames = line.section(QLatin1Char('='), 1).toInt();
+            } else if (key == QLatin1String("progress") && m_pendingFrames > 0) {
+                switchToPendingCapture();
+            }
+            continue;
+        }
+        if (process != m_captureProcess) {
+            // Previous process finishing its file, ignore
+            continue;
+        }
+        m_progress.insert(key, line.section(QLatin1Char('='), 1));
+        if (key == QLatin1String("progress")) {
+            // End of a progress report
+            checkCaptureHealth();
+        }
+    }
+}
+
+void RecManager::checkCaptureHealth()
+{
+    int frames = m_progress.value(QStringLiteral("frame")).toInt();
+    int dropped = m_progress.value(QStringLiteral("drop_frames")).toInt();
+    int duplicated = m_progress.value(QStringLiteral("dup_frames")).toInt();
+    // Frames really grabbed from the screen, duplicates fill the frames that could not be grabbed in time
+    int captured = frames + dropped - duplicated;
+    if (m_startFrames < 0) {
+        // First report, count the expected frames from here to ignore the startup delay
+        m_startFrames = captured;
+        m_captureTimer.start();
+    }
+    int expected = m_startFrames + m_captureTimer.elapsed() * KdenliveSettings::grab_fps() / 1000;
+    // Frames behind the elapsed time, not the encoder queue which ffmpeg does not report
+    int lag = qMax(0, expected - captured);
+    m_healthLabel->setText(i18n("%1 frames, %2 dropped, %3 behind", captured, dropped + duplicated, lag));
+    if (m_fallback || !KdenliveSettings::grab_fallback()) {
+        return;
+    }
+    // More than 2 seconds late in 4 consecutive reports: the encoder cannot keep up
+    if (lag > 2 * KdenliveSettings::grab_fps()) {
+        m_lateReports++;
+    } else {
+        m_lateReports = 0;
+    }
+    if (m_lateReports < 4 || m_previousProcess || m_pendingProcess) {
+        return;
     }
+    qCDebug(KDENLIVE_LOG) << "Screen grab is" << lag << "frames late, switching to fallback codec";
+    // The current capture continues until the new one grabs frames, so that no frame is lost.
+    // If the new capture fails, the current one is kept.
+    m_fallback = true;
+    startScreenGrab(true);
+}
+
+void RecManager::discardPendingCapture()
+{
+    if (!m_pendingProcess) {
+        return;
+    }
+    // The fallback capture did not grab anything yet
+    QProcess *pending = m_pendingProcess;
+    m_pendingProcess = nullptr;
+    pending->kill();
+    QFile::remove(m_pendingFile.toLocalFile());
+}
+
+void RecManager::switchToPendingCapture()
+{
+    m_previousProcess = m_captureProcess;
+    m_previousFile = m_captureFile;
+    m_captureProcess = m_pendingProcess;
+    m_captureFile = m_pendingFile;
+    m_pendingProcess = nullptr;
+    m_progress.clear();
+    m_lateReports = 0;
+    m_startFrames = -1;
+    m_healthLabel->clear();
+    m_previousProcess->terminate();
+    QTimer::singleShot(1500, m_previousProcess, &QProcess::kill);
+    emit warningMessage(i18n("The encoder is too slow, recording continues in %1 with a faster codec", m_captureFile.fileName()));
 }
 
 void RecManager::slotProcessStatus(QProcess::ProcessState status)
 {
+    QProcess *process = qobject_cast<QProcess *>(sender());
+    if (status == QProcess::NotRunning && process && process != m_captureProcess) {
+        if (process == m_previousProcess) {
+            // Capture replaced by the fallback codec is finished, add it to project
+            int code = process->exitCode();
+            if (process->exitStatus() == QProcess::NormalExit && (code == 0 || code == 255)) {
+                emit addClipToProject(m_previousFile);
+            }
+            m_previousProcess = nullptr;
+        } else if (process == m_pendingProcess) {
+            // Fallback capture failed before grabbing a frame, continue with the current one
+            m_pendingProcess = nullptr;
+            QFile::remove(m_pendingFile.toLocalFile());
+            emit warningMessage(i18n("Cannot switch to a faster codec, recording continues in %1", m_captureFile.fileName()), -1, QList<QAction *>() << m_showLogAction);
+        }
+        process->deleteLater();
+        return;
+    }
     if (status == QProcess::NotRunning) {
         m_recAction->setEnabled(true);
         m_recAction->setChecked(false);
         m_device_selector->setEnabled(true);
+        discardPendingCapture();
         if (m_captureProcess) {
             if (m_captureProcess->exitStatus() == QProcess::CrashExit) {
                 emit warningMessage(i18n("Capture crashed, please check your parameters"), -1, QList<QAction *>() << m_showLogAction);
@@ -322,7 +492,11 @@ void RecManager::slotProcessStatus(QProcess::ProcessState status)
 
 void RecManager::slotReadProcessInfo()
 {
-    QString data = m_captureProcess->readAllStandardError().simplified();
+    QProcess *process = qobject_cast<QProcess *>(sender());
+    if (!process) {
+        return;
+    }
+    QString data = process->readAllStandardError().simplified();
     m_recError.append(data + QLatin1Char('\n'));
 }
 
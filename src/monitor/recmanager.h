@@ -32,12 +32,15 @@
 
 #include <QUrl>
 #include <QProcess>
+#include <QElapsedTimer>
+#include <QMap>
 
 class Monitor;
 class QAction;
 class QToolBar;
 class QComboBox;
 class QCheckBox;
+class QLabel;
 
 namespace Mlt
 {
@@ -80,13 +83,42 @@ private:
     QComboBox *m_device_selector;
     QCheckBox *m_recVideo;
     QCheckBox *m_recAudio;
+    /** @brief Displays the screen grab health: captured and dropped frames, lag behind the elapsed time */
+    QLabel *m_healthLabel;
+    /** @brief Screen grab process finishing its file after we switched to the fallback codec */
+    QProcess *m_previousProcess;
+    QUrl m_previousFile;
+    /** @brief Fallback screen grab that did not grab a frame yet, the current capture is only stopped once it does */
+    QProcess *m_pendingProcess;
+    QUrl m_pendingFile;
+    /** @brief Last frame count reported by m_pendingProcess */
+    int m_pendingFrames;
+    /** @brief True if the current screen grab uses the fallback codec */
+    bool m_fallback;
+    /** @brief Number of consecutive progress reports where the encoder was late */
+    int m_lateReports;
+    /** @brief Frames reported when m_captureTimer was started, used to compute the lag behind the elapsed time */
+    int m_startFrames;
+    QElapsedTimer m_captureTimer;
+    /** @brief Last values received from the ffmpeg progress output */
+    QMap<QString, QString> m_progress;
     Mlt::Producer *createV4lProducer();
+    /** @brief Start the screen grab process, using the fallback codec if @param fallback is true */
+    bool startScreenGrab(bool fallback);
+    /** @brief Update the health display and switch to the fallback codec if needed */
+    void checkCaptureHealth();
+    /** @brief The fallback capture grabs frames, make it the current capture and stop the previous one */
+    void switchToPendingCapture();
+    /** @brief Stop the fallback capture if it did not grab a frame yet */
+    void discardPendingCapture();
 
 private slots:
     void slotRecord(bool record);
     void slotPreview(bool record);
     void slotProcessStatus(QProcess::ProcessState status);
     void slotReadProcessInfo();
+    /** @brief Read the progress reports written by ffmpeg on its standard output */
+    void slotReadProgress();
     void showRecConfig();
     void slotVideoDeviceChanged(int ix = -1);
     void slotShowLog();
@@ -267,10 +267,13 @@ void AudioGraphWidget::paintEvent(QPaintEvent *pe)
 
 AudioGraphSpectrum::AudioGraphSpectrum(MonitorManager *manager, QWidget *parent) : ScopeWidget(parent)
     , m_manager(manager)
+    , m_binWidth(0.)
 {
     QVBoxLayout *lay = new QVBoxLayout(this);
     m_graphWidget = new AudioGraphWidget(this);
     lay->addWidget(m_graphWidget);
+    // Spectrums are computed in the refresh thread, the queued connection delivers them in order to the GUI thread
+    connect(this, &AudioGraphSpectrum::spectrumReady, m_graphWidget, &AudioGraphWidget::showAudio);
 
     /*m_equalizer = new EqualizerWidget(this);
     lay->addWidget(m_equalizer);
@@ -327,48 +330,48 @@ void AudioGraphSpectrum::refreshPixmap()
 
 void AudioGraphSpectrum::refreshScope(const QSize & /*size*/, bool /*full*/)
 {
+    // Only analyse the most recent frame, older ones are stale by the time we get here
     SharedFrame sFrame;
     while (m_queue.count() > 0) {
-        sFrame = m_queue.pop();
-        if (sFrame.is_valid() && sFrame.get_audio_samples() > 0) {
-            mlt_audio_format format = mlt_audio_s16;
-            int channels = sFrame.get_audio_channels();
-            int frequency = sFrame.get_audio_frequency();
-            int samples = sFrame.get_audio_samples();
-            Mlt::Frame mFrame = sFrame.clone(true, false, false);
-            m_filter->process(mFrame);
-            mFrame.get_audio(format, frequency, channels, samples);
-            if (samples == 0 || format == 0) {
-                // There was an error processing audio from frame
-                continue;
-            }
-            processSpectrum();
+        SharedFrame next = m_queue.pop();
+        if (next.is_valid() && next.get_audio_samples() > 0) {
+            sFrame = next;
         }
     }
+    if (!sFrame.is_valid()) {
+        return;
+    }
+    // Request float audio, which is what the fft filter works on, to avoid a useless conversion
+    mlt_audio_format format = mlt_audio_float;
+    int channels = sFrame.get_audio_channels();
+    int frequency = sFrame.get_audio_frequency();
+    int samples = sFrame.get_audio_samples();
+    Mlt::Frame mFrame = sFrame.clone(true, false, false);
+    m_filter->process(mFrame);
+    mFrame.get_audio(format, frequency, channels, samples);
+    if (samples == 0 || format == 0) {
+        // There was an error processing audio from frame
+        return;
+    }
+    processSpectrum();
 }
 
-void AudioGraphSpectrum::processSpectrum()
+void AudioGraphSpectrum::buildBandTable(int binCount, double binWidth)
 {
-    QVector<double> bands(AUDIBLE_BAND_COUNT);
-    float *bins = (float *)m_filter->get_data("bins");
-    int bin_count = m_filter->get_int("bin_count");
-    double bin_width = m_filter->get_double("bin_width");
-
+    // Align bin frequencies with band frequencies once, so that each refresh
+    // only has to do a table lookup per bin.
+    m_binToBand.fill(-1, binCount);
+    m_binWidth = binWidth;
     int band = 0;
     bool firstBandFound = false;
-    for (int bin = 0; bin < bin_count; bin++) {
-        // Loop through all the FFT bins and align bin frequencies with
-        // band frequencies.
-        double F = bin_width * (double)bin;
-
+    for (int bin = 0; bin < binCount; bin++) {
+        double F = binWidth * (double)bin;
         if (!firstBandFound) {
             // Skip bins that come before the first band.
             if (BAND_TAB[band + FIRST_AUDIBLE_BAND_INDEX].low > F) {
                 continue;
-            } else {
-                firstBandFound = true;
-                bands[band] = bins[bin];
             }
+            firstBandFound = true;
         } else if (BAND_TAB[band + FIRST_AUDIBLE_BAND_INDEX].high < F) {
             // This bin is outside of this band - move to the next band.
             band++;
@@ -376,22 +379,41 @@ void AudioGraphSpectrum::processSpectrum()
                 // Skip bins that come after the last band.
                 break;
             }
-            bands[band] = bins[bin];
-        } else if (bands[band] < bins[bin]) {
-            // Pick the highest bin level within this band to represent the
-            // whole band.
+        }
+        m_binToBand[bin] = band;
+    }
+}
+
+void AudioGraphSpectrum::processSpectrum()
+{
+    QVector<double> bands(AUDIBLE_BAND_COUNT, 0.);
+    float *bins = (float *)m_filter->get_data("bins");
+    int bin_count = m_filter->get_int("bin_count");
+    double bin_width = m_filter->get_double("bin_width");
+    if (bins == nullptr || bin_count <= 0) {
+        return;
+    }
+    if (bin_count != m_binToBand.size() || !qFuzzyCompare(bin_width, m_binWidth)) {
+        buildBandTable(bin_count, bin_width);
+    }
+
+    // Pick the highest bin level within each band to represent the whole band.
+    const int *table = m_binToBand.constData();
+    for (int bin = 0; bin < bin_count; bin++) {
+        int band = table[bin];
+        if (band >= 0 && bands[band] < bins[bin]) {
             bands[band] = bins[bin];
         }
     }
 
     // At this point, bands contains the magnitude of the signal for each
     // band. Convert to dB.
-    for (band = 0; band < bands.size(); band++) {
+    for (int band = 0; band < bands.size(); band++) {
         double mag = bands[band];
         double dB = mag > 0.0 ? levelToDB(mag) : -100.0;
         bands[band] = dB;
     }
 
     // Update the audio signal widget
-    QMetaObject::invokeMethod(m_graphWidget, "showAudio", Qt::QueuedConnection, Q_ARG(const QVector<double> &, bands));
+    emit spectrumReady(bands);
 }
@@ -87,6 +87,10 @@ private:
     Mlt::Filter *m_filter;
     AudioGraphWidget *m_graphWidget;
     //EqualizerWidget *m_equalizer;
+    /** @brief For each FFT bin, index of the audible band it belongs to or -1. Only accessed from the refresh thread */
+    QVector<int> m_binToBand;
+    double m_binWidth;
+    void buildBandTable(int binCount, double binWidth);
     void processSpectrum();
     void refreshScope(const QSize &size, bool full) Q_DECL_OVERRIDE;
 
@@ -95,6 +99,10 @@ public slots:
 
 private slots:
     void activate(bool enable);
+
+signals:
+    /** @brief Emitted from the refresh thread when a spectrum is ready for display */
+    void spectrumReady(const QVector<double> &bands);
 };
 
 #endif
@@ -0,0 +1,104 @@
+/*
+Copyright (C) 2018  Jean-Baptiste Mardelle <jb@kdenlive.org>
+This file is part of Kdenlive. See www.kdenlive.org.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "audiolevels.h"
+
+#include <mlt++/MltFrame.h>
+#include <math.h>
+#include <stdint.h>
+
+template <typename T>
+static void channelLevels(const T *data, int stride, int samples, double scale, float &peak, float &rms)
+{
+    double max = 0;
+    double sum = 0;
+    for (int s = 0; s < samples; ++s, data += stride) {
+        double value = *data * scale;
+        max = qMax(max, fabs(value));
+        sum += value * value;
+    }
+    peak = qMin(1.0, max);
+    rms = qMin(1.0, sqrt(sum / samples));
+}
+
+bool AudioLevels::compute(Mlt::Frame &frame)
+{
+    channels = 0;
+    if (!frame.is_valid() || frame.get_int("test_audio") != 0) {
+        return false;
+    }
+    // Only look at the audio the consumer already fetched, so that nothing is converted or resampled
+    int size = 0;
+    const void *data = frame.get_data("audio", size);
+    int frameChannels = frame.get_int("audio_channels");
+    int samples = frame.get_int("audio_samples");
+    if (!data || frameChannels <= 0 || samples <= 0) {
+        return false;
+    }
+    channels = qMin((int) MaxChannels, frameChannels);
+    const int format = frame.get_int("audio_format");
+    for (int c = 0; c < channels; ++c) {
+        switch (format) {
+        case mlt_audio_s16:
+            channelLevels((const int16_t *) data + c, frameChannels, samples, 1.0 / 32768, peak[c], rms[c]);
+            break;
+        case mlt_audio_s32le:
+            channelLevels((const int32_t *) data + c, frameChannels, samples, 1.0 / 2147483648.0, peak[c], rms[c]);
+            break;
+        case mlt_audio_f32le:
+            channelLevels((const float *) data + c, frameChannels, samples, 1.0, peak[c], rms[c]);
+            break;
+        case mlt_audio_float:
+            // Planar, each channel is a contiguous block of samples
+            channelLevels((const float *) data + c * samples, 1, samples, 1.0, peak[c], rms[c]);
+            break;
+        default:
+            channels = 0;
+            return false;
+        }
+    }
+    return true;
+}
+
+AudioLevelsChannel::AudioLevelsChannel()
+    : m_back(0)
+    , m_front(2)
+    , m_middle(1)
+{
+}
+
+void AudioLevelsChannel::publish(Mlt::Frame &frame)
+{
+    if (!m_slots[m_back].compute(frame)) {
+        return;
+    }
+    m_back = m_middle.fetchAndStoreOrdered(m_back | Dirty) & IndexMask;
+}
+
+bool AudioLevelsChannel::read(AudioLevels &levels)
+{
+    if ((m_middle.loadAcquire() & Dirty) == 0) {
+        return false;
+    }
+    m_front = m_middle.fetchAndStoreOrdered(m_front) & IndexMask;
+    levels = m_slots[m_front];
+    return true;
+}
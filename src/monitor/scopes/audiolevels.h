@@ -0,0 +1,77 @@
+/*
+Copyright (C) 2018  Jean-Baptiste Mardelle <jb@kdenlive.org>
+This file is part of Kdenlive. See www.kdenlive.org.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef AUDIOLEVELS_H
+#define AUDIOLEVELS_H
+
+#include <QAtomicInt>
+
+namespace Mlt
+{
+class Frame;
+}
+
+/**
+ * @class AudioLevels
+ * @brief Peak and RMS levels of each audio channel of a frame, on a linear 0..1 scale.
+ *
+ * The levels are computed over all the samples of the frame, in the format delivered by the consumer.
+ * GLWidget::setAudioFormat() makes the consumer request the channel count of the clip or project,
+ * so surround audio is not downmixed before metering. The struct has a fixed size and can be copied
+ * between threads without allocation.
+ */
+struct AudioLevels
+{
+    enum { MaxChannels = 32 };
+    AudioLevels() : channels(0) {}
+    /** @brief Compute the levels of the audio already fetched by @param frame, returns false if it has none. */
+    bool compute(Mlt::Frame &frame);
+    int channels;
+    float peak[MaxChannels];
+    float rms[MaxChannels];
+};
+
+/**
+ * @class AudioLevelsChannel
+ * @brief Lock-free triple buffer passing the latest AudioLevels from one writer thread to one reader thread.
+ *
+ * The writer fills the back slot and swaps it with the middle one, the reader swaps the middle slot
+ * with the front one when it was updated. Older levels are dropped if the reader is late.
+ */
+class AudioLevelsChannel
+{
+public:
+    AudioLevelsChannel();
+    /** @brief Compute the levels of @param frame and publish them. Writer thread only. */
+    void publish(Mlt::Frame &frame);
+    /** @brief Copy the latest levels in @param levels, returns false if nothing was published since the last read. Reader thread only. */
+    bool read(AudioLevels &levels);
+
+private:
+    AudioLevels m_slots[3];
+    int m_back;
+    int m_front;
+    /** @brief Index of the middle slot, with the Dirty flag set when it holds unread levels. */
+    QAtomicInt m_middle;
+    enum { Dirty = 4, IndexMask = 3 };
+};
+
+#endif
@@ -20,8 +20,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "monitoraudiolevel.h"
-
-#include "mlt++/Mlt.h"
+#include "audiolevels.h"
 
 #include <math.h>
 
@@ -39,64 +38,23 @@ static inline double levelToDB(double dB)
     return 100 * (1.0 - log10(dB) * log_factor);
 }
 
-MonitorAudioLevel::MonitorAudioLevel(Mlt::Profile *profile, int height, QWidget *parent) : ScopeWidget(parent)
-    , audioChannels(2)
+MonitorAudioLevel::MonitorAudioLevel(int height, QWidget *parent) : QWidget(parent)
     , m_height(height)
     , m_channelHeight(height / 2)
     , m_channelDistance(2)
     , m_channelFillHeight(m_channelHeight)
 {
     setSizePolicy(QSizePolicy::MinimumExpanding, QSizePolicy::Preferred);
-    m_filter = new Mlt::Filter(*profile, "audiolevel");
-    if (!m_filter->is_valid()) {
-        isValid = false;
-        return;
-    }
-    m_filter->set("iec_scale", 0);
-    isValid = true;
 }
 
 MonitorAudioLevel::~MonitorAudioLevel()
 {
-    delete m_filter;
-}
-
-void MonitorAudioLevel::refreshScope(const QSize & /*size*/, bool /*full*/)
-{
-    SharedFrame sFrame;
-    while (m_queue.count() > 0) {
-        sFrame = m_queue.pop();
-        if (sFrame.is_valid() && sFrame.get_audio_samples() > 0) {
-            mlt_audio_format format = mlt_audio_s16;
-            int channels = sFrame.get_audio_channels();
-            int frequency = sFrame.get_audio_frequency();
-            int samples = sFrame.get_audio_samples();
-            Mlt::Frame mFrame = sFrame.clone(true, false, false);
-            m_filter->process(mFrame);
-            mFrame.get_audio(format, frequency, channels, samples);
-            if (samples == 0) {
-                // There was an error processing audio from frame
-                continue;
-            }
-            QVector<int> levels;
-            for (int i = 0; i < audioChannels; i++) {
-                QString s = QStringLiteral("meta.media.audio_level.%1").arg(i);
-                double audioLevel = mFrame.get_double(s.toLatin1().constData());
-                if (audioLevel == 0.0) {
-                    levels << -100;
-                } else {
-                    levels << (int) levelToDB(audioLevel);
-                }
-            }
-            QMetaObject::invokeMethod(this, "setAudioValues", Qt::QueuedConnection, Q_ARG(const QVector<int> &, levels));
-        }
-    }
 }
 
 void MonitorAudioLevel::resizeEvent(QResizeEvent *event)
 {
     drawBackground(m_peaks.size());
-    ScopeWidget::resizeEvent(event);
+    QWidget::resizeEvent(event);
 }
 
 void MonitorAudioLevel::refreshPixmap()
@@ -193,19 +151,20 @@ void MonitorAudioLevel::drawBackground(int channels)
     p.end();
 }
 
-// cppcheck-suppress unusedFunction
-void MonitorAudioLevel::setAudioValues(const QVector<int> &values)
+void MonitorAudioLevel::setAudioLevels(const AudioLevels &levels)
 {
-    m_values = values;
-    if (m_peaks.size() != m_values.size()) {
-        m_peaks = values;
-        drawBackground(values.size());
-    } else {
-        for (int i = 0; i < m_values.size(); i++) {
-            m_peaks[i] --;
-            if (m_values.at(i) > m_peaks.at(i)) {
-                m_peaks[i] = m_values.at(i);
-            }
+    if (m_values.size() != levels.channels) {
+        m_values.resize(levels.channels);
+        m_rms.resize(levels.channels);
+        m_peaks.fill(-100, levels.channels);
+        drawBackground(levels.channels);
+    }
+    for (int i = 0; i < levels.channels; i++) {
+        m_values[i] = levels.peak[i] == 0 ? -100 : (int) levelToDB(levels.peak[i]);
+        m_rms[i] = levels.rms[i] == 0 ? -100 : (int) levelToDB(levels.rms[i]);
+        m_peaks[i] --;
+        if (m_values.at(i) > m_peaks.at(i)) {
+            m_peaks[i] = m_values.at(i);
         }
     }
     update();
@@ -246,6 +205,13 @@ void MonitorAudioLevel::paintEvent(QPaintEvent *pe)
         }
         int val = (50 + m_values.at(i)) / 150.0 * rect.width();
         p.fillRect(val, i * (m_channelHeight + m_channelDistance) + 1, width - val, m_channelFillHeight, palette().dark());
+        // Dim the part between RMS and peak level
+        int rms = qMax(0.0, (50 + m_rms.at(i)) / 150.0 * rect.width());
+        if (rms < val) {
+            p.setOpacity(0.4);
+            p.fillRect(rms, i * (m_channelHeight + m_channelDistance) + 1, val - rms, m_channelFillHeight, palette().dark());
+            p.setOpacity(0.9);
+        }
         p.fillRect((50 + m_peaks.at(i)) / 150.0 * rect.width(), i * (m_channelHeight + m_channelDistance) + 1, 1, m_channelFillHeight, palette().text());
     }
 }
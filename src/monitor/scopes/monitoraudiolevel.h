@@ -22,44 +22,37 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef MONITORAUDIOLEVEL_H
 #define MONITORAUDIOLEVEL_H
 
-#include "scopewidget.h"
 #include <QWidget>
+#include <QPixmap>
+#include <QVector>
 
-namespace Mlt
-{
-class Profile;
-class Filter;
-}
+struct AudioLevels;
 
-class MonitorAudioLevel : public ScopeWidget
+class MonitorAudioLevel : public QWidget
 {
     Q_OBJECT
 public:
-    explicit MonitorAudioLevel(Mlt::Profile *profile, int height, QWidget *parent = nullptr);
+    explicit MonitorAudioLevel(int height, QWidget *parent = nullptr);
     virtual ~MonitorAudioLevel();
     void refreshPixmap();
-    int audioChannels;
-    bool isValid;
     void setVisibility(bool enable);
+    /** @brief Display the peak and RMS @param levels of the last frame. */
+    void setAudioLevels(const AudioLevels &levels);
 
 protected:
     void paintEvent(QPaintEvent *) Q_DECL_OVERRIDE;
     void resizeEvent(QResizeEvent *event) Q_DECL_OVERRIDE;
 
 private:
-    Mlt::Filter *m_filter;
     int m_height;
     QPixmap m_pixmap;
     QVector <int> m_peaks;
     QVector <int> m_values;
+    QVector <int> m_rms;
     int m_channelHeight;
     int m_channelDistance;
     int m_channelFillHeight;
     void drawBackground(int channels = 2);
-    void refreshScope(const QSize &size, bool full) Q_DECL_OVERRIDE;
-
-private slots:
-    void setAudioValues(const QVector <int> &values);
 };
 
 #endif
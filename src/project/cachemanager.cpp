@@ -0,0 +1,491 @@
+/*
+Copyright (C) 2018  Jean-Baptiste Mardelle <jb@kdenlive.org>
+This file is part of Kdenlive. See www.kdenlive.org.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "cachemanager.h"
+#include "core.h"
+#include "bin/bin.h"
+#include "doc/kdenlivedoc.h"
+#include "kdenlivesettings.h"
+#include "kdenlive_debug.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QStandardPaths>
+#include <QtConcurrent>
+
+// Cache folders of a project that can be evicted, proxies are handled file by file
+static const QStringList projectCategories = QStringList() << QStringLiteral("preview") << QStringLiteral("audiothumbs") << QStringLiteral("videothumbs") << QStringLiteral("titles");
+
+static void removeUnits(const QStringList &units)
+{
+    for (const QString &unit : units) {
+        QFileInfo info(unit);
+        if (info.isDir()) {
+            QDir(unit).removeRecursively();
+        } else if (info.exists()) {
+            QFile::remove(unit);
+        }
+    }
+}
+
+static qint64 currentTime()
+{
+    return QDateTime::currentMSecsSinceEpoch() / 1000;
+}
+
+CacheManager::CacheManager(QObject *parent) :
+    QObject(parent)
+    , m_modified(false)
+{
+    m_checkTimer.setSingleShot(true);
+    m_checkTimer.setInterval(5000);
+    connect(&m_checkTimer, &QTimer::timeout, this, &CacheManager::checkQuota);
+    QString systemRoot = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (systemRoot.isEmpty()) {
+        return;
+    }
+    QDir().mkpath(systemRoot);
+    m_indexFile = QDir(systemRoot).absoluteFilePath(QStringLiteral("cacheusage.json"));
+    addRoot(systemRoot);
+    if (QFile::exists(m_indexFile)) {
+        const QStringList outdated = loadIndex();
+        for (const QString &unit : outdated) {
+            refreshLater(unit);
+        }
+    } else {
+        // First run, count existing data once
+        refreshLater(systemRoot);
+    }
+}
+
+CacheManager::~CacheManager()
+{
+    m_jobs.waitForFinished();
+    saveIndex();
+}
+
+void CacheManager::addJob(const QFuture<void> &job)
+{
+    bool running = false;
+    for (const QFuture<void> &future : m_jobs.futures()) {
+        if (!future.isFinished()) {
+            running = true;
+            break;
+        }
+    }
+    if (!running) {
+        m_jobs.clearFutures();
+    }
+    m_jobs.addFuture(job);
+}
+
+bool CacheManager::isInside(const QString &path, const QString &folder)
+{
+    return path == folder || (path.startsWith(folder) && path.at(folder.length()) == QLatin1Char('/'));
+}
+
+bool CacheManager::isProjectProxy(const QString &unit, const QStringList &hashes)
+{
+    QFileInfo info(unit);
+    if (info.dir().dirName() != QLatin1String("proxy")) {
+        return false;
+    }
+    const QString fileName = info.fileName();
+    for (const QString &hash : hashes) {
+        if (fileName.startsWith(hash)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QString CacheManager::unitForPath(const QStringList &roots, const QString &path)
+{
+    for (const QString &root : roots) {
+        if (!isInside(path, root) || path == root) {
+            continue;
+        }
+        const QStringList parts = path.mid(root.length() + 1).split(QLatin1Char('/'), QString::SkipEmptyParts);
+        if (parts.count() < 2) {
+            return QString();
+        }
+        if (parts.at(0) == QLatin1String("proxy")) {
+            return root + QStringLiteral("/proxy/") + parts.at(1);
+        }
+        bool ok = false;
+        parts.at(0).toLongLong(&ok);
+        if (ok && projectCategories.contains(parts.at(1))) {
+            return root + QLatin1Char('/') + parts.at(0) + QLatin1Char('/') + parts.at(1);
+        }
+        return QString();
+    }
+    return QString();
+}
+
+bool CacheManager::addRoot(const QString &root)
+{
+    const QString cleanRoot = QDir::cleanPath(root);
+    QMutexLocker lock(&m_mutex);
+    if (m_roots.contains(cleanRoot)) {
+        return false;
+    }
+    m_roots << cleanRoot;
+    m_modified = true;
+    return true;
+}
+
+void CacheManager::addFile(const QString &path)
+{
+    QFileInfo info(path);
+    if (!info.isFile()) {
+        return;
+    }
+    const QString filePath = QDir::cleanPath(info.absoluteFilePath());
+    QMutexLocker lock(&m_mutex);
+    const QString unit = unitForPath(m_roots, filePath);
+    if (unit.isEmpty()) {
+        return;
+    }
+    CacheEntry &entry = m_entries[unit];
+    qint64 &fileSize = entry.files[filePath.mid(unit.length() + 1)];
+    entry.size += info.size() - fileSize;
+    fileSize = info.size();
+    entry.access = currentTime();
+    m_modified = true;
+    QMetaObject::invokeMethod(this, "scheduleCheck", Qt::QueuedConnection);
+}
+
+void CacheManager::removeFile(const QString &path)
+{
+    const QString filePath = QDir::cleanPath(QFileInfo(path).absoluteFilePath());
+    QMutexLocker lock(&m_mutex);
+    const QString unit = unitForPath(m_roots, filePath);
+    QMap<QString, CacheEntry>::iterator i = m_entries.find(unit);
+    if (unit.isEmpty() || i == m_entries.end()) {
+        return;
+    }
+    QHash<QString, qint64>::iterator file = i.value().files.find(filePath.mid(unit.length() + 1));
+    if (file == i.value().files.end()) {
+        return;
+    }
+    i.value().size -= file.value();
+    i.value().files.erase(file);
+    if (i.value().files.isEmpty()) {
+        m_entries.erase(i);
+    }
+    m_modified = true;
+}
+
+void CacheManager::refreshLater(const QString &path)
+{
+    addJob(QtConcurrent::run(this, &CacheManager::refresh, QDir::cleanPath(path)));
+}
+
+void CacheManager::refresh(const QString &path)
+{
+    QString folder = QDir::cleanPath(path);
+    QStringList roots;
+    m_mutex.lock();
+    roots = m_roots;
+    m_mutex.unlock();
+    const QString unit = unitForPath(roots, folder);
+    if (!unit.isEmpty()) {
+        folder = unit;
+    }
+
+    // Count the data without holding the lock
+    QMap<QString, CacheEntry> found;
+    QFileInfo info(folder);
+    if (info.isFile()) {
+        CacheEntry &entry = found[folder];
+        entry.size = info.size();
+        entry.files.insert(QString(), info.size());
+        entry.access = info.lastModified().toMSecsSinceEpoch() / 1000;
+    } else if (info.isDir()) {
+        QDirIterator it(folder, QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            it.next();
+            const QFileInfo fileInfo = it.fileInfo();
+            const QString filePath = QDir::cleanPath(fileInfo.absoluteFilePath());
+            const QString fileUnit = unitForPath(roots, filePath);
+            if (fileUnit.isEmpty()) {
+                continue;
+            }
+            CacheEntry &entry = found[fileUnit];
+            entry.size += fileInfo.size();
+            entry.files.insert(filePath.mid(fileUnit.length() + 1), fileInfo.size());
+            entry.access = qMax(entry.access, fileInfo.lastModified().toMSecsSinceEpoch() / 1000);
+        }
+    }
+
+    QMutexLocker lock(&m_mutex);
+    QMap<QString, qint64> previousAccess;
+    QMap<QString, CacheEntry>::iterator i = m_entries.lowerBound(folder);
+    while (i != m_entries.end() && i.key().startsWith(folder)) {
+        if (isInside(i.key(), folder)) {
+            previousAccess.insert(i.key(), i.value().access);
+            i = m_entries.erase(i);
+        } else {
+            ++i;
+        }
+    }
+    QMapIterator<QString, CacheEntry> j(found);
+    while (j.hasNext()) {
+        j.next();
+        CacheEntry entry = j.value();
+        entry.access = qMax(entry.access, previousAccess.value(j.key()));
+        m_entries.insert(j.key(), entry);
+    }
+    m_modified = true;
+    QMetaObject::invokeMethod(this, "scheduleCheck", Qt::QueuedConnection);
+}
+
+qint64 CacheManager::usage(const QString &path) const
+{
+    const QString folder = QDir::cleanPath(path);
+    qint64 total = 0;
+    QMutexLocker lock(&m_mutex);
+    QMap<QString, CacheEntry>::const_iterator i = m_entries.lowerBound(folder);
+    for (; i != m_entries.constEnd() && i.key().startsWith(folder); ++i) {
+        if (isInside(i.key(), folder)) {
+            total += i.value().size;
+        }
+    }
+    return total;
+}
+
+QDateTime CacheManager::lastAccess(const QString &path) const
+{
+    const QString folder = QDir::cleanPath(path);
+    qint64 access = 0;
+    QMutexLocker lock(&m_mutex);
+    QMap<QString, CacheEntry>::const_iterator i = m_entries.lowerBound(folder);
+    for (; i != m_entries.constEnd() && i.key().startsWith(folder); ++i) {
+        if (isInside(i.key(), folder)) {
+            access = qMax(access, i.value().access);
+        }
+    }
+    return access > 0 ? QDateTime::fromMSecsSinceEpoch(access * 1000) : QDateTime();
+}
+
+qint64 CacheManager::totalUsage() const
+{
+    qint64 total = 0;
+    QMutexLocker lock(&m_mutex);
+    for (const CacheEntry &entry : m_entries) {
+        total += entry.size;
+    }
+    return total;
+}
+
+void CacheManager::slotProjectOpened(KdenliveDoc *doc)
+{
+    bool ok = false;
+    QDir base = doc->getCacheDir(CacheBase, &ok);
+    if (!ok) {
+        return;
+    }
+    QDir root = doc->getCacheDir(CacheRoot, &ok);
+    if (addRoot(root.absolutePath())) {
+        // Custom project folder, count its data once
+        refreshLater(root.absolutePath());
+    }
+    QMutexLocker lock(&m_mutex);
+    m_currentProject = QDir::cleanPath(base.absolutePath());
+    const qint64 now = currentTime();
+    QMap<QString, CacheEntry>::iterator i = m_entries.lowerBound(m_currentProject);
+    for (; i != m_entries.end() && i.key().startsWith(m_currentProject); ++i) {
+        if (isInside(i.key(), m_currentProject)) {
+            i.value().access = now;
+        }
+    }
+    m_modified = true;
+    lock.unlock();
+    scheduleCheck();
+}
+
+void CacheManager::touchProjectProxies()
+{
+    const QStringList hashes = pCore->bin()->getProxyHashList();
+    if (hashes.isEmpty()) {
+        return;
+    }
+    const qint64 now = currentTime();
+    QMutexLocker lock(&m_mutex);
+    QMap<QString, CacheEntry>::iterator i = m_entries.begin();
+    for (; i != m_entries.end(); ++i) {
+        if (isProjectProxy(i.key(), hashes)) {
+            i.value().access = now;
+            m_modified = true;
+        }
+    }
+}
+
+void CacheManager::slotProjectClosed()
+{
+    touchProjectProxies();
+    m_mutex.lock();
+    const QString closedProject = m_currentProject;
+    m_currentProject.clear();
+    m_mutex.unlock();
+    if (!closedProject.isEmpty()) {
+        // Previews may have been deleted or invalidated during the session, count again
+        refreshLater(closedProject);
+    }
+}
+
+void CacheManager::scheduleCheck()
+{
+    if (!m_checkTimer.isActive()) {
+        m_checkTimer.start();
+    }
+}
+
+void CacheManager::checkQuota()
+{
+    const qint64 quota = static_cast<qint64>(KdenliveSettings::cachequota()) * 1024 * 1024 * 1024;
+    QStringList evicted;
+    qint64 freed = 0;
+    if (quota > 0) {
+        const QStringList hashes = pCore->bin()->getProxyHashList();
+        QMutexLocker lock(&m_mutex);
+        qint64 total = 0;
+        QMultiMap<qint64, QString> candidates;
+        QMapIterator<QString, CacheEntry> i(m_entries);
+        while (i.hasNext()) {
+            i.next();
+            total += i.value().size;
+            if ((!m_currentProject.isEmpty() && isInside(i.key(), m_currentProject)) || isProjectProxy(i.key(), hashes)) {
+                // Data used by the open project
+                continue;
+            }
+            candidates.insert(i.value().access, i.key());
+        }
+        if (total > quota) {
+            // Free some more space than required so that each new preview chunk does not trigger an eviction
+            const qint64 target = quota - quota / 10;
+            QMultiMap<qint64, QString>::const_iterator j = candidates.constBegin();
+            for (; j != candidates.constEnd() && total - freed > target; ++j) {
+                evicted << j.value();
+                freed += m_entries.value(j.value()).size;
+                m_entries.remove(j.value());
+            }
+            m_modified = true;
+        }
+    }
+    if (!evicted.isEmpty()) {
+        qCDebug(KDENLIVE_LOG) << "Cache quota exceeded, deleting" << evicted.count() << "cache items," << freed << "bytes";
+        addJob(QtConcurrent::run(removeUnits, evicted));
+    }
+    addJob(QtConcurrent::run(this, &CacheManager::saveIndex));
+}
+
+QStringList CacheManager::loadIndex()
+{
+    QStringList outdated;
+    QFile file(m_indexFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return outdated;
+    }
+    const QJsonObject index = QJsonDocument::fromJson(file.readAll()).object();
+    file.close();
+    QMutexLocker lock(&m_mutex);
+    const QJsonArray roots = index.value(QStringLiteral("roots")).toArray();
+    for (const QJsonValue &root : roots) {
+        if (!m_roots.contains(root.toString()) && QFileInfo::exists(root.toString())) {
+            m_roots << root.toString();
+        }
+    }
+    const QJsonObject entries = index.value(QStringLiteral("entries")).toObject();
+    for (QJsonObject::const_iterator i = entries.constBegin(); i != entries.constEnd(); ++i) {
+        if (!QFileInfo::exists(i.key())) {
+            // Deleted outside of Kdenlive
+            m_modified = true;
+            continue;
+        }
+        const QJsonObject data = i.value().toObject();
+        CacheEntry entry;
+        entry.access = static_cast<qint64>(data.value(QStringLiteral("access")).toDouble());
+        if (!data.contains(QStringLiteral("files"))) {
+            // Index written before files were tracked, keep the access time and count the unit again
+            m_entries.insert(i.key(), entry);
+            outdated << i.key();
+            continue;
+        }
+        const QJsonObject files = data.value(QStringLiteral("files")).toObject();
+        for (QJsonObject::const_iterator j = files.constBegin(); j != files.constEnd(); ++j) {
+            const qint64 size = static_cast<qint64>(j.value().toDouble());
+            entry.files.insert(j.key(), size);
+            entry.size += size;
+        }
+        m_entries.insert(i.key(), entry);
+    }
+    return outdated;
+}
+
+void CacheManager::saveIndex()
+{
+    QMutexLocker saveLock(&m_saveMutex);
+    // Copy the index so that the entries can be updated while it is written
+    m_mutex.lock();
+    if (!m_modified || m_indexFile.isEmpty()) {
+        m_mutex.unlock();
+        return;
+    }
+    const QMap<QString, CacheEntry> entryCopy = m_entries;
+    const QStringList roots = m_roots;
+    m_modified = false;
+    m_mutex.unlock();
+
+    QJsonObject entries;
+    QMapIterator<QString, CacheEntry> i(entryCopy);
+    while (i.hasNext()) {
+        i.next();
+        QJsonObject files;
+        QHashIterator<QString, qint64> j(i.value().files);
+        while (j.hasNext()) {
+            j.next();
+            files.insert(j.key(), static_cast<double>(j.value()));
+        }
+        QJsonObject data;
+        data.insert(QStringLiteral("access"), static_cast<double>(i.value().access));
+        data.insert(QStringLiteral("files"), files);
+        entries.insert(i.key(), data);
+    }
+    QJsonObject index;
+    index.insert(QStringLiteral("roots"), QJsonArray::fromStringList(roots));
+    index.insert(QStringLiteral("entries"), entries);
+    QSaveFile file(m_indexFile);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(index).toJson(QJsonDocument::Compact));
+        if (file.commit()) {
+            return;
+        }
+    }
+    qCWarning(KDENLIVE_LOG) << "Cannot write cache index" << m_indexFile;
+    QMutexLocker lock(&m_mutex);
+    m_modified = true;
+}
@@ -0,0 +1,120 @@
+/*
+Copyright (C) 2018  Jean-Baptiste Mardelle <jb@kdenlive.org>
+This file is part of Kdenlive. See www.kdenlive.org.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CACHEMANAGER_H
+#define CACHEMANAGER_H
+
+#include <QObject>
+#include <QMap>
+#include <QHash>
+#include <QMutex>
+#include <QStringList>
+#include <QTimer>
+#include <QDateTime>
+#include <QFutureSynchronizer>
+
+class KdenliveDoc;
+
+/**
+ * @class CacheManager
+ * @brief Keeps track of the disk space used by the cache folders of all projects and enforces a global quota.
+ *
+ * Cached data is accounted by unit: the timeline preview, audio thumbnails and video thumbnails folders
+ * of each project, and each file of the shared proxy folder. The size of each file of a unit is updated
+ * when it is written or deleted and stored with the last access time in an index file, so that folders
+ * are only scanned once.
+ * When the quota is exceeded, the least recently used units that do not belong to the open project are deleted.
+ */
+class CacheManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CacheManager(QObject *parent = nullptr);
+    ~CacheManager();
+    /** @brief Account a file written in a cache folder, replacing its previous size if it was rewritten. Can be called from any thread. */
+    void addFile(const QString &path);
+    /** @brief Stop accounting a file deleted from a cache folder. Can be called from any thread. */
+    void removeFile(const QString &path);
+    /** @brief Recount the cache data in @param path, for example after it was deleted by the user. Can be called from any thread. */
+    void refresh(const QString &path);
+    /** @brief Recount the cache data in @param path in a background thread, after files were moved or deleted. */
+    void refreshLater(const QString &path);
+    /** @brief Returns the size of the cache data stored in @param path (a cache folder or file). */
+    qint64 usage(const QString &path) const;
+    /** @brief Returns the last time the cache data in @param path was used. */
+    QDateTime lastAccess(const QString &path) const;
+    /** @brief Returns the size of all tracked cache data. */
+    qint64 totalUsage() const;
+
+public slots:
+    /** @brief The project's cache data is in use and cannot be evicted while it is open. */
+    void slotProjectOpened(KdenliveDoc *doc);
+    /** @brief The current project is closing, its data can be evicted. */
+    void slotProjectClosed();
+    /** @brief Delete the least recently used data if the cache is larger than the configured quota. */
+    void checkQuota();
+
+private:
+    struct CacheEntry {
+        CacheEntry() : size(0), access(0) {}
+        /** @brief Sum of the file sizes. */
+        qint64 size;
+        /** @brief Seconds since epoch. */
+        qint64 access;
+        /** @brief Size of each file, by path relative to the unit (empty for a single file unit). */
+        QHash<QString, qint64> files;
+    };
+    mutable QMutex m_mutex;
+    /** @brief Serializes index writes, which run in a background thread. */
+    QMutex m_saveMutex;
+    /** @brief Cache units by absolute path. */
+    QMap<QString, CacheEntry> m_entries;
+    /** @brief Cache root folders, the system cache folder and custom project folders. */
+    QStringList m_roots;
+    /** @brief Cache folder of the open project, protected from eviction. */
+    QString m_currentProject;
+    QString m_indexFile;
+    QTimer m_checkTimer;
+    bool m_modified;
+    /** @brief Background folder scans and deletions. */
+    QFutureSynchronizer<void> m_jobs;
+    /** @brief Run @param job in the background, it is waited for when closing. */
+    void addJob(const QFuture<void> &job);
+    /** @brief Returns the unit containing @param path, or an empty string if it is not cache data. */
+    static QString unitForPath(const QStringList &roots, const QString &path);
+    /** @brief Returns true if @param path is @param folder or inside it. */
+    static bool isInside(const QString &path, const QString &folder);
+    /** @brief Returns true if @param unit is a proxy file of a clip in @param hashes. */
+    static bool isProjectProxy(const QString &unit, const QStringList &hashes);
+    /** @brief Returns false if @param root was already known. */
+    bool addRoot(const QString &root);
+    /** @brief Returns the units that have no file list and must be counted again. */
+    QStringList loadIndex();
+    void saveIndex();
+    /** @brief Mark the proxies of the current project as used now. */
+    void touchProjectProxies();
+
+private slots:
+    void scheduleCheck();
+};
+
+#endif
@@ -27,12 +27,56 @@
 #include <KMessageBox>
 #include <KGuiItem>
 #include <KTar>
+#include <KZip>
 #include "kdenlive_debug.h"
 #include <kio/directorysizejob.h>
 #include <KMessageWidget>
 
 #include <QTreeWidget>
 #include <QtConcurrent>
+#include <QFutureWatcher>
+#include <QEventLoop>
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QMimeDatabase>
+
+// Files smaller than this are read in parallel before being written to the archive
+static const qint64 SMALL_FILE_SIZE = 4 * 1024 * 1024;
+// Size of the blocks copied from larger files to the archive
+static const qint64 ARCHIVE_BLOCK_SIZE = 1024 * 1024;
+// KZip cannot write ZIP64 entries, sizes and offsets must fit in 32 bits (with some room for the headers)
+static const qint64 ZIP_SIZE_LIMIT = Q_INT64_C(0xFFFFFFFF) - 64 * 1024 * 1024;
+
+static QByteArray readWholeFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+static QString contentHash(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    hash.addData(&file);
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+/** @brief Returns true for text like files (project, titles, LUTs, ...) worth compressing, media files are already compressed */
+static bool isCompressible(const QString &name)
+{
+    static const QStringList suffixes = QStringList() << QStringLiteral("kdenlive") << QStringLiteral("kdenlivetitle") << QStringLiteral("mlt") << QStringLiteral("cube") << QStringLiteral("3dl") << QStringLiteral("dat") << QStringLiteral("pgm");
+    if (suffixes.contains(QFileInfo(name).suffix().toLower())) {
+        return true;
+    }
+    QMimeDatabase db;
+    return db.mimeTypeForFile(name, QMimeDatabase::MatchExtension).inherits(QStringLiteral("text/plain"));
+}
 
 ArchiveWidget::ArchiveWidget(const QString &projectName, const QDomDocument &doc, const QList<ClipController *> &list, const QStringList &luma_list, QWidget *parent) :
     QDialog(parent)
@@ -46,15 +90,19 @@ ArchiveWidget::ArchiveWidget(const QString &projectName, const QDomDocument &doc
     , m_progressTimer(nullptr)
     , m_extractArchive(nullptr)
     , m_missingClips(0)
+    , m_archiveSize(0)
+    , m_archivedBytes(0)
+    , m_archivePercent(0)
 {
     setAttribute(Qt::WA_DeleteOnClose);
     setupUi(this);
     setWindowTitle(i18n("Archive Project"));
     archive_url->setUrl(QUrl::fromLocalFile(QDir::homePath()));
     connect(archive_url, &KUrlRequester::textChanged, this, &ArchiveWidget::slotCheckSpace);
-    connect(this, SIGNAL(archivingFinished(bool)), this, SLOT(slotArchivingFinished(bool)));
+    connect(this, SIGNAL(archivingFinished(bool,QStringList)), this, SLOT(slotArchivingFinished(bool,QStringList)));
     connect(this, SIGNAL(archiveProgress(int)), this, SLOT(slotArchivingProgress(int)));
     connect(proxy_only, &QCheckBox::stateChanged, this, &ArchiveWidget::slotProxyOnly);
+    connect(compressed_archive, &QAbstractButton::toggled, fast_archive, &QWidget::setEnabled);
 
     // Setup categories
     QTreeWidgetItem *videos = new QTreeWidgetItem(files_list, QStringList() << i18n("Video clips"));
@@ -199,6 +247,7 @@ ArchiveWidget::ArchiveWidget(const QString &projectName, const QDomDocument &doc
         m_name = i18n("Untitled");
     }
     compressed_archive->setText(compressed_archive->text() + QStringLiteral(" (") + m_name + QStringLiteral(".tar.gz)"));
+    fast_archive->setText(fast_archive->text() + QStringLiteral(" (") + m_name + QStringLiteral(".zip)"));
     project_files->setText(i18np("%1 file to archive, requires %2", "%1 files to archive, requires %2", total, KIO::convertSize(m_requestedSize)));
     buttonBox->button(QDialogButtonBox::Apply)->setText(i18n("Archive"));
     connect(buttonBox->button(QDialogButtonBox::Apply), &QAbstractButton::clicked, this, &ArchiveWidget::slotStartArchiving);
@@ -218,7 +267,10 @@ ArchiveWidget::ArchiveWidget(const QUrl &url, QWidget *parent):
     m_extractUrl(url),
     m_extractArchive(nullptr),
     m_missingClips(0),
-    m_infoMessage(nullptr)
+    m_infoMessage(nullptr),
+    m_archiveSize(0),
+    m_archivedBytes(0),
+    m_archivePercent(0)
 {
     //setAttribute(Qt::WA_DeleteOnClose);
 
@@ -231,6 +283,7 @@ ArchiveWidget::ArchiveWidget(const QUrl &url, QWidget *parent):
     connect(this, &ArchiveWidget::showMessage, this, &ArchiveWidget::slotDisplayMessage);
 
     compressed_archive->setHidden(true);
+    fast_archive->setHidden(true);
     proxy_only->setHidden(true);
     project_files->setHidden(true);
     files_list->setHidden(true);
@@ -266,7 +319,11 @@ void ArchiveWidget::slotJobResult(bool success, const QString &text)
 void ArchiveWidget::openArchiveForExtraction()
 {
     emit showMessage(QStringLiteral("system-run"), i18n("Opening archive..."));
-    m_extractArchive = new KTar(m_extractUrl.toLocalFile());
+    if (m_extractUrl.fileName().endsWith(QLatin1String(".zip"), Qt::CaseInsensitive)) {
+        m_extractArchive = new KZip(m_extractUrl.toLocalFile());
+    } else {
+        m_extractArchive = new KTar(m_extractUrl.toLocalFile());
+    }
     if (!m_extractArchive->isOpen() && !m_extractArchive->open(QIODevice::ReadOnly)) {
         emit showMessage(QStringLiteral("dialog-close"), i18n("Cannot open archive file:\n %1", m_extractUrl.toLocalFile()));
         groupBox->setEnabled(false);
@@ -525,6 +582,7 @@ bool ArchiveWidget::slotStartArchiving(bool firstPass)
         archive_url->setEnabled(false);
         proxy_only->setEnabled(false);
         compressed_archive->setEnabled(false);
+        fast_archive->setEnabled(false);
     }
     QList<QUrl> files;
     QUrl destUrl;
@@ -672,6 +730,7 @@ void ArchiveWidget::slotArchivingFinished(KJob *job, bool finished)
         archive_url->setEnabled(true);
         proxy_only->setEnabled(true);
         compressed_archive->setEnabled(true);
+        fast_archive->setEnabled(compressed_archive->isChecked());
         for (int i = 0; i < files_list->topLevelItemCount(); ++i) {
             files_list->topLevelItem(i)->setDisabled(false);
             for (int j = 0; j < files_list->topLevelItem(i)->childCount(); ++j) {
@@ -712,6 +771,9 @@ bool ArchiveWidget::processProjectFile()
             }
         }
     }
+    if (isArchive) {
+        removeDuplicateFiles();
+    }
 
     QDomElement mlt = m_doc.documentElement();
     QString root = mlt.attribute(QStringLiteral("root"));
@@ -866,47 +928,186 @@ bool ArchiveWidget::processProjectFile()
     return true;
 }
 
+void ArchiveWidget::removeDuplicateFiles()
+{
+    // Only files sharing their size with another file can be duplicates
+    QMap<qint64, QStringList> sizes;
+    QMapIterator<QString, QString> i(m_filesList);
+    while (i.hasNext()) {
+        i.next();
+        if (i.value().startsWith(QLatin1String("slideshows/"))) {
+            // Slideshow images must stay in their folder
+            continue;
+        }
+        qint64 size = QFileInfo(i.key()).size();
+        if (size > 0) {
+            sizes[size] << i.key();
+        }
+    }
+    QStringList candidates;
+    for (const QStringList &files : sizes) {
+        if (files.count() > 1) {
+            candidates << files;
+        }
+    }
+    if (candidates.isEmpty()) {
+        return;
+    }
+    slotDisplayMessage(QStringLiteral("system-run"), i18n("Checking duplicate files..."));
+    QFutureWatcher<QString> watcher;
+    QEventLoop loop;
+    connect(&watcher, &QFutureWatcherBase::finished, &loop, &QEventLoop::quit);
+    watcher.setFuture(QtConcurrent::mapped(candidates, contentHash));
+    if (!watcher.isFinished()) {
+        loop.exec(QEventLoop::ExcludeUserInputEvents);
+    }
+    QMap<QString, QString> storedFiles;
+    for (int j = 0; j < candidates.count(); ++j) {
+        const QString hash = watcher.resultAt(j);
+        if (hash.isEmpty()) {
+            continue;
+        }
+        const QString path = candidates.at(j);
+        if (!storedFiles.contains(hash)) {
+            storedFiles.insert(hash, m_filesList.value(path));
+            continue;
+        }
+        // Same content is already archived, use it in the project
+        m_filesList.remove(path);
+        QUrl src = QUrl::fromLocalFile(path);
+        if (m_replacementList.contains(src)) {
+            m_replacementList.insert(src, QUrl::fromLocalFile(storedFiles.value(hash)));
+        }
+    }
+    slotDisplayMessage(QStringLiteral("system-run"), i18n("Archiving..."));
+}
+
+bool ArchiveWidget::writeArchiveFile(KArchive *archive, QIODevice *source, const QFileInfo &info, const QString &name, const QString &user, const QString &group)
+{
+    KZip *zip = dynamic_cast<KZip *>(archive);
+    if (zip) {
+        // Media files are already compressed, only spend time on text files
+        zip->setCompression(isCompressible(name) ? KZip::DeflateCompression : KZip::NoCompression);
+    }
+    const qint64 size = source->size();
+    if (!archive->prepareWriting(name, user, group, size, 0100644, info.lastRead(), info.lastModified(), info.created())) {
+        return false;
+    }
+    qint64 written = 0;
+    QByteArray block;
+    while (written < size && !m_abortArchive) {
+        block = source->read(ARCHIVE_BLOCK_SIZE);
+        if (block.isEmpty() || !archive->writeData(block.constData(), block.size())) {
+            break;
+        }
+        written += block.size();
+        m_archivedBytes += block.size();
+        int percent = m_archiveSize > 0 ? static_cast<int>(100 * m_archivedBytes / m_archiveSize) : 0;
+        if (percent != m_archivePercent) {
+            m_archivePercent = percent;
+            emit archiveProgress(percent);
+        }
+    }
+    return archive->finishWriting(written) && written == size;
+}
+
 void ArchiveWidget::createArchive()
 {
-    QString archiveName(archive_url->url().toLocalFile() + QDir::separator() + m_name + QStringLiteral(".tar.gz"));
+    // List files, the project file last
+    QList<QFileInfo> sources;
+    QStringList names;
+    QMapIterator<QString, QString> i(m_filesList);
+    while (i.hasNext()) {
+        i.next();
+        sources << QFileInfo(i.key());
+        names << i.value();
+    }
+    if (m_temp) {
+        sources << QFileInfo(m_temp->fileName());
+        names << m_name + QStringLiteral(".kdenlive");
+    }
+    m_archiveSize = 0;
+    m_archivedBytes = 0;
+    m_archivePercent = 0;
+    for (const QFileInfo &info : sources) {
+        m_archiveSize += info.size();
+    }
+
+    bool fastArchive = fast_archive->isChecked();
+    if (fastArchive && m_archiveSize >= ZIP_SIZE_LIMIT) {
+        // A larger zip file would be corrupted, use the compressed archive
+        fastArchive = false;
+        QMetaObject::invokeMethod(this, "slotDisplayMessage", Qt::QueuedConnection, Q_ARG(QString, QStringLiteral("dialog-information")),
+                                  Q_ARG(QString, i18n("Project is larger than 4 GiB, creating a compressed archive instead of a zip file...")));
+    }
+    QString archiveName(archive_url->url().toLocalFile() + QDir::separator() + m_name + (fastArchive ? QStringLiteral(".zip") : QStringLiteral(".tar.gz")));
     if (QFile::exists(archiveName) && KMessageBox::questionYesNo(this, i18n("File %1 already exists.\nDo you want to overwrite it?", archiveName)) == KMessageBox::No) {
         return;
     }
     QFileInfo dirInfo(archive_url->url().toLocalFile());
     QString user = dirInfo.owner();
     QString group = dirInfo.group();
-    KTar archive(archiveName, QStringLiteral("application/x-gzip"));
-    archive.open(QIODevice::WriteOnly);
+    QScopedPointer<KArchive> archive;
+    if (fastArchive) {
+        archive.reset(new KZip(archiveName));
+    } else {
+        archive.reset(new KTar(archiveName, QStringLiteral("application/x-gzip")));
+    }
+    archive->open(QIODevice::WriteOnly);
 
     // Create folders
     foreach (const QString &path, m_foldersList) {
-        archive.writeDir(path, user, group);
+        archive->writeDir(path, user, group);
     }
 
-    // Add files
+    bool result = true;
+    QStringList skipped;
     int ix = 0;
-    QMapIterator<QString, QString> i(m_filesList);
-    while (i.hasNext()) {
-        i.next();
-        archive.addLocalFile(i.key(), i.value());
-        emit archiveProgress((int) 100 * ix / m_filesList.count());
+    while (ix < sources.count() && result && !m_abortArchive) {
+        // Read the next small files in parallel
+        QStringList batch;
+        while (ix + batch.count() < sources.count() && batch.count() < 64 && sources.at(ix + batch.count()).size() < SMALL_FILE_SIZE) {
+            batch << sources.at(ix + batch.count()).absoluteFilePath();
+        }
+        if (!batch.isEmpty()) {
+            QList<QByteArray> contents = QtConcurrent::blockingMapped<QList<QByteArray> >(batch, readWholeFile);
+            for (int j = 0; j < contents.count() && result; ++j, ++ix) {
+                if (contents.at(j).size() != sources.at(ix).size()) {
+                    qCWarning(KDENLIVE_LOG) << "Cannot read file" << sources.at(ix).absoluteFilePath();
+                    skipped << sources.at(ix).absoluteFilePath();
+                    continue;
+                }
+                QBuffer buffer(&contents[j]);
+                buffer.open(QIODevice::ReadOnly);
+                result = writeArchiveFile(archive.data(), &buffer, sources.at(ix), names.at(ix), user, group);
+            }
+            continue;
+        }
+        QFile file(sources.at(ix).absoluteFilePath());
+        if (file.open(QIODevice::ReadOnly)) {
+            result = writeArchiveFile(archive.data(), &file, sources.at(ix), names.at(ix), user, group);
+        } else {
+            qCWarning(KDENLIVE_LOG) << "Cannot read file" << file.fileName();
+            skipped << file.fileName();
+        }
         ix++;
     }
-
-    // Add project file
-    bool result = false;
-    if (m_temp) {
-        archive.addLocalFile(m_temp->fileName(), m_name + QStringLiteral(".kdenlive"));
-        result = archive.close();
-        delete m_temp;
-        m_temp = nullptr;
+    result = archive->close() && result && m_temp != nullptr && !m_abortArchive;
+    delete m_temp;
+    m_temp = nullptr;
+    if (!result) {
+        QFile::remove(archiveName);
     }
-    emit archivingFinished(result);
+    emit archivingFinished(result, skipped);
 }
 
-void ArchiveWidget::slotArchivingFinished(bool result)
+void ArchiveWidget::slotArchivingFinished(bool result, const QStringList &skipped)
 {
-    if (result) {
+    if (result && !skipped.isEmpty()) {
+        // The archive is usable but incomplete, tell which files are missing
+        slotJobResult(false, i18np("Project was archived, but this file could not be read:\n%2", "Project was archived, but these %1 files could not be read:\n%2", skipped.count(), skipped.join(QLatin1Char('\n'))));
+        buttonBox->button(QDialogButtonBox::Apply)->setEnabled(false);
+    } else if (result) {
         slotJobResult(true, i18n("Project was successfully archived."));
         buttonBox->button(QDialogButtonBox::Apply)->setEnabled(false);
     } else {
@@ -917,6 +1118,7 @@ void ArchiveWidget::slotArchivingFinished(bool result)
     archive_url->setEnabled(true);
     proxy_only->setEnabled(true);
     compressed_archive->setEnabled(true);
+    fast_archive->setEnabled(compressed_archive->isChecked());
     for (int i = 0; i < files_list->topLevelItemCount(); ++i) {
         files_list->topLevelItem(i)->setDisabled(false);
         for (int j = 0; j < files_list->topLevelItem(i)->childCount(); ++j) {
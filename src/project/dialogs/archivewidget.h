@@ -33,6 +33,8 @@
 
 class KJob;
 class KArchive;
+class QFileInfo;
+class QIODevice;
 class ClipController;
 
 /**
@@ -64,7 +66,8 @@ private slots:
     bool closeAccepted();
     void createArchive();
     void slotArchivingProgress(int);
-    void slotArchivingFinished(bool result);
+    /** @brief Reports the archive @param result, and the @param skipped files that could not be read. */
+    void slotArchivingFinished(bool result, const QStringList &skipped);
     void slotStartExtracting();
     void doExtracting();
     void slotExtractingFinished();
@@ -97,6 +100,10 @@ private:
     KArchive *m_extractArchive;
     int m_missingClips;
     KMessageWidget *m_infoMessage;
+    /** @brief Bytes to write in the archive, and bytes already written, used for progress. */
+    qint64 m_archiveSize;
+    qint64 m_archivedBytes;
+    int m_archivePercent;
 
     /** @brief Generate tree widget subitems from a string list of urls. */
     void generateItems(QTreeWidgetItem *parentItem, const QStringList &items);
@@ -104,9 +111,13 @@ private:
     void generateItems(QTreeWidgetItem *parentItem, const QMap<QString, QString> &items);
     /** @brief Replace urls in project file. */
     bool processProjectFile();
+    /** @brief Archive only one copy of the files having the same content, and point the project to it. */
+    void removeDuplicateFiles();
+    /** @brief Write the content of @param source in the archive as @param name, reporting progress in bytes. */
+    bool writeArchiveFile(KArchive *archive, QIODevice *source, const QFileInfo &info, const QString &name, const QString &user, const QString &group);
 
 signals:
-    void archivingFinished(bool);
+    void archivingFinished(bool, const QStringList &);
     void archiveProgress(int);
     void extractingFinished();
     void showMessage(const QString &, const QString &);
@@ -29,6 +29,97 @@
 #include <QFontDatabase>
 #include <QDir>
 #include <QStandardPaths>
+#include <QScrollBar>
+#include <QtConcurrent>
+
+SlideshowModel::SlideshowModel(QObject *parent) :
+    QAbstractListModel(parent),
+    m_precision(0),
+    m_unknownIcon(QIcon::fromTheme(QStringLiteral("unknown")))
+{
+}
+
+void SlideshowModel::setFiles(const QString &folder, const QStringList &names)
+{
+    beginResetModel();
+    m_folder = folder;
+    m_names = names;
+    m_frames.clear();
+    m_thumbnails.clear();
+    endResetModel();
+}
+
+void SlideshowModel::setSequence(const QString &folder, const QString &prefix, const QString &extension, int precision, const QVector<int> &frames)
+{
+    beginResetModel();
+    m_folder = folder;
+    m_names.clear();
+    m_prefix = prefix;
+    m_extension = extension;
+    m_precision = precision;
+    m_frames = frames;
+    m_thumbnails.clear();
+    endResetModel();
+}
+
+void SlideshowModel::clear()
+{
+    beginResetModel();
+    m_names.clear();
+    m_frames.clear();
+    m_thumbnails.clear();
+    endResetModel();
+}
+
+QString SlideshowModel::fileName(int row) const
+{
+    if (m_names.isEmpty()) {
+        return SequenceIndex::fileName(m_prefix, m_frames.at(row), m_precision, m_extension);
+    }
+    return m_names.at(row);
+}
+
+QString SlideshowModel::filePath(int row) const
+{
+    return m_folder + QLatin1Char('/') + fileName(row);
+}
+
+bool SlideshowModel::hasThumbnail(int row) const
+{
+    return m_thumbnails.contains(row);
+}
+
+void SlideshowModel::setThumbnail(int row, const QPixmap &pix)
+{
+    if (row < 0 || row >= rowCount()) {
+        return;
+    }
+    m_thumbnails.insert(row, QIcon(pix));
+    emit dataChanged(index(row), index(row), QVector<int>() << Qt::DecorationRole);
+}
+
+int SlideshowModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_names.isEmpty() ? m_frames.count() : m_names.count();
+}
+
+QVariant SlideshowModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount()) {
+        return QVariant();
+    }
+    switch (role) {
+    case Qt::DisplayRole:
+        return fileName(index.row());
+    case Qt::DecorationRole:
+        return m_thumbnails.value(index.row(), m_unknownIcon);
+    default:
+        return QVariant();
+    }
+}
 
 SlideshowClip::SlideshowClip(const Timecode &tc, QString clipFolder, ProjectClip *clip, QWidget *parent) :
     QDialog(parent),
@@ -47,7 +138,21 @@ SlideshowClip::SlideshowClip(const Timecode &tc, QString clipFolder, ProjectClip
     }
     m_view.folder_url->setMode(KFile::Directory);
     m_view.folder_url->setUrl(QUrl::fromLocalFile(KRecentDirs::dir(QStringLiteral(":KdenliveSlideShowFolder"))));
+    m_model = new SlideshowModel(this);
+    m_view.icon_list->setModel(m_model);
+    // Only lay out and create thumbnails for the visible part of long sequences
+    m_view.icon_list->setUniformItemSizes(true);
     m_view.icon_list->setIconSize(QSize(50, 50));
+    m_thumbTimer.setSingleShot(true);
+    m_thumbTimer.setInterval(200);
+    connect(&m_thumbTimer, &QTimer::timeout, this, &SlideshowClip::slotGenerateThumbs);
+    connect(m_view.icon_list->verticalScrollBar(), &QScrollBar::valueChanged, this, [this]() {
+        m_thumbTimer.start();
+    });
+    connect(m_view.icon_list->verticalScrollBar(), &QScrollBar::rangeChanged, this, [this]() {
+        m_thumbTimer.start();
+    });
+    connect(&m_scanWatcher, &QFutureWatcherBase::finished, this, &SlideshowClip::slotFolderScanned);
     m_view.show_thumbs->setChecked(KdenliveSettings::showslideshowthumbs());
 
     connect(m_view.show_thumbs, &QCheckBox::stateChanged, this, &SlideshowClip::slotEnableThumbs);
@@ -200,11 +305,10 @@ void SlideshowClip::slotEnableThumbs(int state)
         slotGenerateThumbs();
     } else {
         KdenliveSettings::setShowslideshowthumbs(false);
-        if (m_thumbJob) {
-            disconnect(m_thumbJob, &KIO::PreviewJob::gotPreview, this, &SlideshowClip::slotSetPixmap);
-            m_thumbJob->kill();
-            m_thumbJob = nullptr;
-        }
+        m_thumbTimer.stop();
+        delete m_thumbJob;
+        m_thumbJob = nullptr;
+        m_thumbRows.clear();
     }
 
 }
@@ -222,32 +326,44 @@ void SlideshowClip::slotEnableLumaFile(int state)
 
 void SlideshowClip::parseFolder()
 {
-    m_view.icon_list->clear();
+    m_thumbTimer.stop();
+    delete m_thumbJob;
+    m_thumbJob = nullptr;
+    m_thumbRows.clear();
+    m_model->clear();
+    m_count = 0;
+    m_view.buttonBox->button(QDialogButtonBox::Ok)->setEnabled(false);
     bool isMime = m_view.method_mime->isChecked();
     QString path = isMime ? m_view.folder_url->url().toLocalFile() : m_view.pattern_url->url().adjusted(QUrl::RemoveFilename).toLocalFile();
     QDir dir(path);
     if (path.isEmpty() || !dir.exists()) {
-        m_count = 0;
-        m_view.buttonBox->button(QDialogButtonBox::Ok)->setEnabled(false);
+        m_scanFolder.clear();
         m_view.label_info->setText(QString());
         return;
     }
+    // Listing large sequences can be slow, do it in a thread
+    m_scanFolder = QDir::cleanPath(path);
+    m_view.label_info->setText(i18n("Scanning folder..."));
+    m_scanWatcher.setFuture(QtConcurrent::run(&SequenceIndex::scan, m_scanFolder));
+}
 
-    QIcon unknownicon(QStringLiteral("unknown"));
-    QStringList result;
-    QStringList filters;
-    QString filter;
+void SlideshowClip::slotFolderScanned()
+{
+    bool isMime = m_view.method_mime->isChecked();
+    QString path = isMime ? m_view.folder_url->url().toLocalFile() : m_view.pattern_url->url().adjusted(QUrl::RemoveFilename).toLocalFile();
+    if (m_scanFolder.isEmpty() || QDir::cleanPath(path) != m_scanFolder) {
+        // Folder changed during the scan
+        return;
+    }
+    const SequenceIndex::Folder content = m_scanWatcher.result();
+    QVector<int> frames;
     if (isMime) {
         // TODO: improve jpeg image detection with extension like jpeg, requires change in MLT image producers
-        filter = m_view.image_type->itemData(m_view.image_type->currentIndex()).toString();
-        filters << QStringLiteral("*.") + filter;
-        dir.setNameFilters(filters);
-        result = dir.entryList(QDir::Files);
+        QString filter = m_view.image_type->itemData(m_view.image_type->currentIndex()).toString();
+        m_model->setFiles(m_scanFolder, SequenceIndex::files(content, filter));
     } else {
         int offset = 0;
         QString path_pattern = m_view.pattern_url->text();
-        QDir abs_dir = QFileInfo(m_view.pattern_url->text()).absoluteDir();
-        result = abs_dir.entryList(QDir::Files);
         // find pattern
         if (path_pattern.contains(QLatin1Char('?'))) {
             // New MLT syntax
@@ -259,68 +375,83 @@ void SlideshowClip::parseFolder()
             }
             path_pattern = path_pattern.section(QLatin1Char('?'), 0, 0);
         }
-        filter = QFileInfo(path_pattern).fileName();
-        QString ext = filter.section(QLatin1Char('.'), -1);
+        QString filter = QFileInfo(path_pattern).fileName();
+        QString ext = QLatin1Char('.') + filter.section(QLatin1Char('.'), -1);
+        int precision = 0;
         if (filter.contains(QLatin1Char('%'))) {
+            precision = filter.section(QLatin1Char('%'), -1).section(QLatin1Char('d'), 0, 0).toInt();
             filter = filter.section(QLatin1Char('%'), 0, -2);
         } else {
             filter = filter.section(QLatin1Char('.'), 0, -2);
             while (!filter.isEmpty() && filter.at(filter.count() - 1).isDigit()) {
-                filter.remove(filter.count() - 1, 1);
+                filter.chop(1);
+                precision++;
             }
         }
-        // qCDebug(KDENLIVE_LOG) << " / /" << path_pattern << " / " << ext << " / " << filter;
-        QString regexp = QLatin1Char('^') + filter + QStringLiteral("\\d+\\.") + ext + QLatin1Char('$');
-        QRegExp rx(regexp);
-        QStringList entries;
-        int ix;
-        foreach (const QString &p, result) {
-            if (rx.exactMatch(p)) {
-                if (offset > 0) {
-                    // make sure our image is in the range we want (> begin)
-                    ix = p.section(filter, 1).section(QLatin1Char('.'), 0, 0).toInt();
-                    ix = p.section(filter, 1).section('.', 0, 0).toInt();
-                    if (ix < offset) {
-                        continue;
-                    }
-                }
-                entries << p;
-            }
+        frames = SequenceIndex::frames(content, filter, ext, precision);
+        if (offset > 0) {
+            // make sure our images are in the range we want (> begin)
+            frames.erase(frames.begin(), std::lower_bound(frames.begin(), frames.end(), offset));
         }
-        result = entries;
+        m_model->setSequence(m_scanFolder, filter, ext, precision, frames);
     }
-    foreach (const QString &p, result) {
-        QListWidgetItem *item = new QListWidgetItem(unknownicon, p);
-        item->setData(Qt::UserRole, dir.filePath(p));
-        m_view.icon_list->addItem(item);
-    }
-    m_count = m_view.icon_list->count();
+    m_count = m_model->rowCount();
     m_view.buttonBox->button(QDialogButtonBox::Ok)->setEnabled(m_count > 0);
     if (m_count == 0) {
         m_view.label_info->setText(i18n("No image found"));
     } else {
-        m_view.label_info->setText(i18np("1 image found", "%1 images found", m_count));
+        QString info = i18np("1 image found", "%1 images found", m_count);
+        if (!frames.isEmpty()) {
+            info.append(QStringLiteral(", ") + i18n("frames %1 to %2", frames.first(), frames.last()));
+            const QVector<QPair<int, int> > gaps = SequenceIndex::gaps(frames);
+            if (!gaps.isEmpty()) {
+                QStringList missing;
+                for (int i = 0; i < qMin(3, gaps.count()); ++i) {
+                    const QPair<int, int> &gap = gaps.at(i);
+                    missing << (gap.first == gap.second ? QString::number(gap.first) : QStringLiteral("%1-%2").arg(gap.first).arg(gap.second));
+                }
+                if (gaps.count() > 3) {
+                    missing << QStringLiteral("...");
+                }
+                info.append(QLatin1Char('\n') + i18np("1 gap: %2", "%1 gaps: %2", gaps.count(), missing.join(QStringLiteral(", "))));
+            }
+        }
+        m_view.label_info->setText(info);
     }
+    m_view.icon_list->setCurrentIndex(m_model->index(0));
     if (m_view.show_thumbs->isChecked()) {
-        slotGenerateThumbs();
+        m_thumbTimer.start();
     }
-    m_view.icon_list->setCurrentRow(0);
 }
 
 void SlideshowClip::slotGenerateThumbs()
 {
     delete m_thumbJob;
+    m_thumbJob = nullptr;
+    m_thumbRows.clear();
+    if (!m_view.show_thumbs->isChecked() || m_model->rowCount() == 0) {
+        return;
+    }
+    // Only create the thumbnails of the displayed rows
+    const QRect rect = m_view.icon_list->viewport()->rect();
+    QModelIndex first = m_view.icon_list->indexAt(rect.topLeft());
+    QModelIndex last = m_view.icon_list->indexAt(rect.bottomLeft());
+    int firstRow = first.isValid() ? first.row() : 0;
+    int lastRow = last.isValid() ? last.row() : m_model->rowCount() - 1;
+    lastRow = qMin(lastRow, firstRow + 200);
     KFileItemList fileList;
-    for (int i = 0; i < m_view.icon_list->count(); ++i) {
-        QListWidgetItem *item = m_view.icon_list->item(i);
-        if (item) {
-            QString path = item->data(Qt::UserRole).toString();
-            if (!path.isEmpty()) {
-                KFileItem f(QUrl::fromLocalFile(path));
-                f.setDelayedMimeTypes(true);
-                fileList.append(f);
-            }
+    for (int i = firstRow; i <= lastRow; ++i) {
+        if (m_model->hasThumbnail(i)) {
+            continue;
         }
+        QString path = m_model->filePath(i);
+        KFileItem f(QUrl::fromLocalFile(path));
+        f.setDelayedMimeTypes(true);
+        fileList.append(f);
+        m_thumbRows.insert(path, i);
+    }
+    if (fileList.isEmpty()) {
+        return;
     }
     m_thumbJob = new KIO::PreviewJob(fileList, QSize(50, 50));
     m_thumbJob->setScaleType(KIO::PreviewJob::Scaled);
@@ -331,16 +462,9 @@ void SlideshowClip::slotGenerateThumbs()
 
 void SlideshowClip::slotSetPixmap(const KFileItem &fileItem, const QPixmap &pix)
 {
-    for (int i = 0; i < m_view.icon_list->count(); ++i) {
-        QListWidgetItem *item = m_view.icon_list->item(i);
-        if (item) {
-            QString path = item->data(Qt::UserRole).toString();
-            if (path == fileItem.url().toLocalFile()) {
-                item->setIcon(QIcon(pix));
-                item->setData(Qt::UserRole, QString());
-                break;
-            }
-        }
+    int row = m_thumbRows.value(fileItem.url().toLocalFile(), -1);
+    if (row >= 0) {
+        m_model->setThumbnail(row, pix);
     }
 }
 
@@ -381,11 +505,7 @@ QString SlideshowClip::selectedPath(const QUrl &url, bool isMime, QString extens
             folder.append(QDir::separator());
         }
         // Check how many files we have
-        QDir dir(folder);
-        QStringList filters;
-        filters << QStringLiteral("*.") + extension.section(QLatin1Char('.'), -1);
-        dir.setNameFilters(filters);
-        *list = dir.entryList(QDir::Files);
+        *list = SequenceIndex::files(SequenceIndex::scan(folder), extension.section(QLatin1Char('.'), -1));
     } else {
         folder = url.adjusted(QUrl::RemoveFilename).toLocalFile();
         QString filter = url.fileName();
@@ -402,18 +522,18 @@ QString SlideshowClip::selectedPath(const QUrl &url, bool isMime, QString extens
         int precision = fullSize - filter.size();
         int firstFrame = firstFrameData.rightRef(precision).toInt();
 
-        // Check how many files we have
-        QDir dir(folder);
-        QString path;
-        int gap = 0;
-        for (int i = firstFrame; gap < 100; ++i) {
-            path = filter + QString::number(i).rightJustified(precision, QLatin1Char('0'), false) + ext;
-            if (dir.exists(path)) {
-                (*list).append(folder + path);
-                gap = 0;
-            } else {
-                gap++;
+        // Check how many files we have, the sequence ends after 100 missing frames
+        const QVector<int> frames = SequenceIndex::frames(SequenceIndex::scan(folder), filter, ext, precision);
+        int previous = firstFrame - 1;
+        for (int frame : frames) {
+            if (frame < firstFrame) {
+                continue;
+            }
+            if (frame - previous > 100) {
+                break;
             }
+            (*list).append(folder + SequenceIndex::fileName(filter, frame, precision, ext));
+            previous = frame;
         }
         extension = filter + QStringLiteral("%0") + QString::number(precision) + QLatin1Char('d') + ext;
         if (firstFrame > 0) {
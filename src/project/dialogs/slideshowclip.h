@@ -22,12 +22,49 @@
 
 #include "definitions.h"
 #include "timecode.h"
+#include "project/sequenceindex.h"
 #include "ui_slideshowclip_ui.h"
 
+#include <QAbstractListModel>
+#include <QFutureWatcher>
+#include <QTimer>
 #include <KIO/PreviewJob>
 
 class ProjectClip;
 
+/**
+ * @class SlideshowModel
+ * @brief List of the images in a slideshow, file names and thumbnails are only created for displayed rows.
+ */
+class SlideshowModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit SlideshowModel(QObject *parent = nullptr);
+    /** @brief Display the files @param names of @param folder. */
+    void setFiles(const QString &folder, const QStringList &names);
+    /** @brief Display the numbered files of a sequence, @param frames being the sorted frame numbers. */
+    void setSequence(const QString &folder, const QString &prefix, const QString &extension, int precision, const QVector<int> &frames);
+    void clear();
+    QString filePath(int row) const;
+    bool hasThumbnail(int row) const;
+    void setThumbnail(int row, const QPixmap &pix);
+    int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
+    QVariant data(const QModelIndex &index, int role) const Q_DECL_OVERRIDE;
+
+private:
+    QString m_folder;
+    QStringList m_names;
+    QString m_prefix;
+    QString m_extension;
+    int m_precision;
+    QVector<int> m_frames;
+    QHash<int, QIcon> m_thumbnails;
+    QIcon m_unknownIcon;
+    QString fileName(int row) const;
+};
+
 class SlideshowClip : public QDialog
 {
     Q_OBJECT
@@ -57,10 +94,13 @@ public:
 
 private slots:
     void parseFolder();
+    /** @brief The folder content was listed, display the matching images. */
+    void slotFolderScanned();
     void slotEnableLuma(int state);
     void slotEnableThumbs(int state);
     void slotEnableLumaFile(int state);
     void slotUpdateDurationFormat(int ix);
+    /** @brief Create the thumbnails of the displayed images. */
     void slotGenerateThumbs();
     void slotSetPixmap(const KFileItem &fileItem, const QPixmap &pix);
     /** @brief Display correct widget depenging on user choice (MIME type or pattern method). */
@@ -71,6 +111,13 @@ private:
     int m_count;
     Timecode m_timecode;
     KIO::PreviewJob *m_thumbJob;
+    SlideshowModel *m_model;
+    QFutureWatcher<SequenceIndex::Folder> m_scanWatcher;
+    /** @brief The folder being scanned or displayed. */
+    QString m_scanFolder;
+    /** @brief Row of the images in the running thumbnail job, by path. */
+    QHash<QString, int> m_thumbRows;
+    QTimer m_thumbTimer;
 };
 
 #endif
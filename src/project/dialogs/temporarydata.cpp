@@ -21,6 +21,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "temporarydata.h"
 #include "doc/kdenlivedoc.h"
+#include "core.h"
+#include "project/cachemanager.h"
 #include "utils/KoIconUtils.h"
 
 #include <KLocalizedString>
@@ -218,10 +220,11 @@ void TemporaryData::updateDataInfo()
         m_currentPage->setEnabled(false);
         return;
     }
+    // Sizes are tracked by the cache manager, no need to scan the folders
+    CacheManager *cache = pCore->cacheManager();
     preview = m_doc->getCacheDir(CachePreview, &ok);
     if (ok) {
-        KIO::DirectorySizeJob *job = KIO::directorySize(QUrl::fromLocalFile(preview.absolutePath()));
-        connect(job, &KIO::DirectorySizeJob::result, this, &TemporaryData::gotPreviewSize);
+        gotPreviewSize(static_cast<KIO::filesize_t>(cache->usage(preview.absolutePath())));
     }
 
     preview = m_doc->getCacheDir(CacheProxy, &ok);
@@ -237,26 +240,19 @@ void TemporaryData::updateDataInfo()
 
     preview = m_doc->getCacheDir(CacheAudio, &ok);
     if (ok) {
-        KIO::DirectorySizeJob *job = KIO::directorySize(QUrl::fromLocalFile(preview.absolutePath()));
-        connect(job, &KIO::DirectorySizeJob::result, this, &TemporaryData::gotAudioSize);
+        gotAudioSize(static_cast<KIO::filesize_t>(cache->usage(preview.absolutePath())));
     }
     preview = m_doc->getCacheDir(CacheThumbs, &ok);
     if (ok) {
-        KIO::DirectorySizeJob *job = KIO::directorySize(QUrl::fromLocalFile(preview.absolutePath()));
-        connect(job, &KIO::DirectorySizeJob::result, this, &TemporaryData::gotThumbSize);
+        gotThumbSize(static_cast<KIO::filesize_t>(cache->usage(preview.absolutePath())));
     }
     if (m_globalPage) {
         updateGlobalInfo();
     }
 }
 
-void TemporaryData::gotPreviewSize(KJob *job)
+void TemporaryData::gotPreviewSize(KIO::filesize_t total)
 {
-    KIO::DirectorySizeJob *sourceJob = static_cast<KIO::DirectorySizeJob *>(job);
-    KIO::filesize_t total = sourceJob->totalSize();
-    if (sourceJob->totalFiles() == 0) {
-        total = 0;
-    }
     QLayoutItem *button = m_grid->itemAtPosition(0, 4);
     if (button && button->widget()) {
         button->widget()->setEnabled(total > 0);
@@ -279,13 +275,8 @@ void TemporaryData::gotProxySize(KIO::filesize_t total)
     updateTotal();
 }
 
-void TemporaryData::gotAudioSize(KJob *job)
+void TemporaryData::gotAudioSize(KIO::filesize_t total)
 {
-    KIO::DirectorySizeJob *sourceJob = static_cast<KIO::DirectorySizeJob *>(job);
-    KIO::filesize_t total = sourceJob->totalSize();
-    if (sourceJob->totalFiles() == 0) {
-        total = 0;
-    }
     QLayoutItem *button = m_grid->itemAtPosition(2, 4);
     if (button && button->widget()) {
         button->widget()->setEnabled(total > 0);
@@ -296,13 +287,8 @@ void TemporaryData::gotAudioSize(KJob *job)
     updateTotal();
 }
 
-void TemporaryData::gotThumbSize(KJob *job)
+void TemporaryData::gotThumbSize(KIO::filesize_t total)
 {
-    KIO::DirectorySizeJob *sourceJob = static_cast<KIO::DirectorySizeJob *>(job);
-    KIO::filesize_t total = sourceJob->totalSize();
-    if (sourceJob->totalFiles() == 0) {
-        total = 0;
-    }
     QLayoutItem *button = m_grid->itemAtPosition(3, 4);
     if (button && button->widget()) {
         button->widget()->setEnabled(total > 0);
@@ -344,6 +330,7 @@ void TemporaryData::deletePreview()
     if (dir.dirName() == QLatin1String("preview")) {
         dir.removeRecursively();
         dir.mkpath(QStringLiteral("."));
+        pCore->cacheManager()->refresh(dir.absolutePath());
         emit disablePreview();
         updateDataInfo();
     }
@@ -363,6 +350,7 @@ void TemporaryData::deleteProxy()
     }
     foreach (const QString &file, files) {
         dir.remove(file);
+        pCore->cacheManager()->refresh(dir.absoluteFilePath(file));
     }
     emit disableProxies();
     updateDataInfo();
@@ -381,6 +369,7 @@ void TemporaryData::deleteAudio()
     if (dir.dirName() == QLatin1String("audiothumbs")) {
         dir.removeRecursively();
         dir.mkpath(QStringLiteral("."));
+        pCore->cacheManager()->refresh(dir.absolutePath());
         updateDataInfo();
     }
 }
@@ -398,6 +387,7 @@ void TemporaryData::deleteThumbs()
     if (dir.dirName() == QLatin1String("videothumbs")) {
         dir.removeRecursively();
         dir.mkpath(QStringLiteral("."));
+        pCore->cacheManager()->refresh(dir.absolutePath());
         updateDataInfo();
     }
 }
@@ -417,6 +407,7 @@ void TemporaryData::deleteCurrentCacheData()
         emit disableProxies();
         dir.removeRecursively();
         m_doc->initCacheDirs();
+        pCore->cacheManager()->refresh(dir.absolutePath());
         updateDataInfo();
     }
 }
@@ -491,35 +482,23 @@ void TemporaryData::updateGlobalInfo()
         return;
     }
     m_globalDir = preview;
-    m_globalDirectories.clear();
-    m_processingDirectory.clear();
-    m_globalDirectories = m_globalDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
-    m_globalDelete->setEnabled(!m_globalDirectories.isEmpty());
-    processglobalDirectories();
-    m_listWidget->blockSignals(false);
-}
-
-void TemporaryData::processglobalDirectories()
-{
-    if (m_globalDirectories.isEmpty()) {
-        return;
+    const QStringList folders = m_globalDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    m_globalDelete->setEnabled(!folders.isEmpty());
+    for (const QString &folder : folders) {
+        addGlobalFolder(folder);
     }
-    m_processingDirectory = m_globalDirectories.takeFirst();
-    KIO::DirectorySizeJob *job = KIO::directorySize(QUrl::fromLocalFile(m_globalDir.absoluteFilePath(m_processingDirectory)));
-    connect(job, &KIO::DirectorySizeJob::result, this, &TemporaryData::gotFolderSize);
+    m_globalSize->setText(KIO::convertSize(m_totalGlobal));
+    m_listWidget->blockSignals(false);
+    m_listWidget->setCurrentItem(m_listWidget->topLevelItem(0));
 }
 
-void TemporaryData::gotFolderSize(KJob *job)
+void TemporaryData::addGlobalFolder(const QString &folder)
 {
-    KIO::DirectorySizeJob *sourceJob = static_cast<KIO::DirectorySizeJob *>(job);
-    KIO::filesize_t total = sourceJob->totalSize();
-    if (sourceJob->totalFiles() == 0) {
-        total = 0;
-    }
+    QDir dir(m_globalDir.absoluteFilePath(folder));
+    KIO::filesize_t total = static_cast<KIO::filesize_t>(pCore->cacheManager()->usage(dir.absolutePath()));
     m_totalGlobal += total;
     TreeWidgetItem *item = new TreeWidgetItem(m_listWidget);
     // Check last save path for this cache folder
-    QDir dir(m_globalDir.absoluteFilePath(m_processingDirectory));
     QStringList filters;
     filters << QStringLiteral("*.kdenlive");
     QStringList str = dir.entryList(filters, QDir::Files | QDir::Hidden, QDir::Time);
@@ -527,33 +506,31 @@ void TemporaryData::gotFolderSize(KJob *job)
         QString path = QUrl::fromPercentEncoding(str.at(0).toUtf8());
         // Remove leading dot
         path.remove(0, 1);
-        item->setText(0, m_processingDirectory + QStringLiteral(" (%1)").arg(QUrl::fromLocalFile(path).fileName()));
+        item->setText(0, folder + QStringLiteral(" (%1)").arg(QUrl::fromLocalFile(path).fileName()));
         if (QFile::exists(path)) {
             item->setIcon(0, KoIconUtils::themedIcon(QStringLiteral("kdenlive")));
         } else {
             item->setIcon(0, KoIconUtils::themedIcon(QStringLiteral("dialog-close")));
         }
     } else {
-        item->setText(0, m_processingDirectory);
-        if (m_processingDirectory == QLatin1String("proxy")) {
+        item->setText(0, folder);
+        if (folder == QLatin1String("proxy")) {
             item->setIcon(0, KoIconUtils::themedIcon(QStringLiteral("kdenlive-show-video")));
         }
     }
-    item->setData(0, Qt::UserRole, m_processingDirectory);
+    item->setData(0, Qt::UserRole, folder);
     item->setText(1, KIO::convertSize(total));
-    QDateTime date = QFileInfo(dir.absolutePath()).lastModified();
+    // Show when the data was last used, if known
+    QDateTime date = pCore->cacheManager()->lastAccess(dir.absolutePath());
+    if (!date.isValid()) {
+        date = QFileInfo(dir.absolutePath()).lastModified();
+    }
     item->setText(2, date.toString(Qt::SystemLocaleShortDate));
     item->setData(1, Qt::UserRole, total);
     item->setData(2, Qt::UserRole, date);
     m_listWidget->addTopLevelItem(item);
     m_listWidget->resizeColumnToContents(0);
     m_listWidget->resizeColumnToContents(1);
-    if (m_globalDirectories.isEmpty()) {
-        m_globalSize->setText(KIO::convertSize(m_totalGlobal));
-        m_listWidget->setCurrentItem(m_listWidget->topLevelItem(0));
-    } else {
-        processglobalDirectories();
-    }
 }
 
 void TemporaryData::refreshGlobalPie()
@@ -600,6 +577,7 @@ void TemporaryData::deleteSelected()
             // We deleted proxy folder, recreate it
             toRemove.mkpath(QStringLiteral("."));
         }
+        pCore->cacheManager()->refresh(toRemove.absolutePath());
     }
     updateGlobalInfo();
 }
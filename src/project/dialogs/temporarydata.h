@@ -26,7 +26,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QWidget>
 #include <QDir>
-#include <KIO/DirectorySizeJob>
+#include <kio/global.h>
 
 class KdenliveDoc;
 class QPaintEvent;
@@ -110,8 +110,6 @@ private:
     KIO::filesize_t m_totalGlobal;
     QList<KIO::filesize_t> mCurrentSizes;
     QList<KIO::filesize_t> mGlobalSizes;
-    QStringList m_globalDirectories;
-    QString m_processingDirectory;
     QDir m_globalDir;
     QStringList m_proxies;
     QPushButton *m_globalDelete;
@@ -119,14 +117,14 @@ private:
     void updateGlobalInfo();
     void updateTotal();
     void buildGlobalCacheDialog(int minHeight);
-    void processglobalDirectories();
+    /** @brief Add a folder of the global cache to the list, with its size from the cache manager. */
+    void addGlobalFolder(const QString &folder);
 
 private slots:
-    void gotPreviewSize(KJob *job);
+    void gotPreviewSize(KIO::filesize_t total);
     void gotProxySize(KIO::filesize_t total);
-    void gotAudioSize(KJob *job);
-    void gotThumbSize(KJob *job);
-    void gotFolderSize(KJob *job);
+    void gotAudioSize(KIO::filesize_t total);
+    void gotThumbSize(KIO::filesize_t total);
     void refreshGlobalPie();
     void deletePreview();
     void deleteProxy();
@@ -24,6 +24,8 @@
 #include "doc/kdenlivedoc.h"
 #include "bin/projectclip.h"
 #include "bin/bin.h"
+#include "core.h"
+#include "project/cachemanager.h"
 #include <QProcess>
 #include <QTemporaryFile>
 
@@ -162,6 +164,7 @@ void ProxyJob::startJob()
         } else {
             proxy.save(m_dest);
         }
+        pCore->cacheManager()->addFile(m_dest);
         setStatus(JobDone);
         return;
     } else {
@@ -221,6 +224,7 @@ void ProxyJob::startJob()
                 m_errorMessage.append(i18n("Failed to create proxy clip."));
                 setStatus(JobCrashed);
             } else {
+                pCore->cacheManager()->addFile(m_dest);
                 setStatus(JobDone);
             }
         } else if (result == QProcess::CrashExit) {
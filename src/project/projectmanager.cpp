@@ -17,6 +17,7 @@ the Free Software Foundation, either version 3 of the License, or
 #include "kdenlivesettings.h"
 #include "monitor/monitormanager.h"
 #include "doc/kdenlivedoc.h"
+#include "doc/documentloader.h"
 #include "timeline/timeline.h"
 #include "project/dialogs/projectsettings.h"
 #include "timeline/customtrackview.h"
@@ -25,6 +26,7 @@ the Free Software Foundation, either version 3 of the License, or
 #include "effectstack/effectstackview2.h"
 #include "project/dialogs/backupwidget.h"
 #include "project/notesplugin.h"
+#include "project/cachemanager.h"
 #include "utils/KoIconUtils.h"
 
 #include <KActionCollection>
@@ -48,7 +50,8 @@ ProjectManager::ProjectManager(QObject *parent) :
     QObject(parent),
     m_project(nullptr),
     m_trackView(nullptr),
-    m_progressDialog(nullptr)
+    m_progressDialog(nullptr),
+    m_loader(nullptr)
 {
     m_fileRevert = KStandardAction::revert(this, SLOT(slotRevert()), pCore->window()->actionCollection());
     m_fileRevert->setIcon(KoIconUtils::themedIcon(QStringLiteral("document-revert")));
@@ -94,7 +97,14 @@ void ProjectManager::slotLoadOnOpen()
     } else {
         newFile(false);
     }
+    if (m_loader == nullptr) {
+        // Otherwise the clips are added once the project is read
+        loadClipsOnOpen();
+    }
+}
 
+void ProjectManager::loadClipsOnOpen()
+{
     if (!m_loadClipsOnOpen.isEmpty() && m_project) {
         const QStringList list = m_loadClipsOnOpen.split(QLatin1Char(','));
         QList<QUrl> urls;
@@ -192,7 +202,7 @@ void ProjectManager::newFile(bool showProjectSettings, bool force)
     pCore->window()->m_timelineArea->setEnabled(true);
     bool openBackup;
     m_notesPlugin->clear();
-    KdenliveDoc *doc = new KdenliveDoc(QUrl(), projectFolder, pCore->window()->m_commandStack, profileName, documentProperties, documentMetadata, projectTracks, pCore->monitorManager()->projectMonitor()->render, m_notesPlugin, &openBackup, pCore->window());
+    KdenliveDoc *doc = new KdenliveDoc(nullptr, projectFolder, pCore->window()->m_commandStack, profileName, documentProperties, documentMetadata, projectTracks, pCore->monitorManager()->projectMonitor()->render, m_notesPlugin, &openBackup, pCore->window());
     doc->m_autosave = new KAutoSaveFile(startFile, doc);
     bool ok;
     pCore->bin()->setDocument(doc);
@@ -266,6 +276,7 @@ bool ProjectManager::closeCurrentDocument(bool saveChanges, bool quit)
             pCore->window()->m_effectStack->transitionConfig()->slotTransitionItemSelected(nullptr, 0, QPoint(), false);
             delete m_trackView;
             m_trackView = nullptr;
+            pCore->cacheManager()->slotProjectClosed();
             delete m_project;
             m_project = nullptr;
         }
@@ -471,7 +482,7 @@ void ProjectManager::openFile(const QUrl &url)
     QMimeDatabase db;
     // Make sure the url is a Kdenlive project file
     QMimeType mime = db.mimeTypeForUrl(url);
-    if (mime.inherits(QStringLiteral("application/x-compressed-tar"))) {
+    if (mime.inherits(QStringLiteral("application/x-compressed-tar")) || mime.inherits(QStringLiteral("application/zip"))) {
         // Opening a compressed project file, we need to process it
         //qCDebug(KDENLIVE_LOG)<<"Opening archive, processing";
         QPointer<ArchiveWidget> ar = new ArchiveWidget(url);
@@ -509,10 +520,10 @@ void ProjectManager::openFile(const QUrl &url)
     doOpenFile(url, nullptr);
 }
 
-void ProjectManager::doOpenFile(const QUrl &url, KAutoSaveFile *stale)
+void ProjectManager::doOpenFile(const QUrl &url, KAutoSaveFile *stale, const QUrl &backupOf)
 {
     Q_ASSERT(m_project == nullptr);
-    if (!pCore->window()->m_timelineArea->isEnabled()) {
+    if (!pCore->window()->m_timelineArea->isEnabled() || m_loader) {
         return;
     }
     m_fileRevert->setEnabled(true);
@@ -529,10 +540,44 @@ void ProjectManager::doOpenFile(const QUrl &url, KAutoSaveFile *stale)
     m_progressDialog->setCancelButton(nullptr);
     m_progressDialog->setLabelText(i18n("Loading project"));
     m_progressDialog->setMaximum(0);
+    // There is no project until the file is read, only let the window repaint
+    m_progressDialog->setWindowModality(Qt::WindowModal);
     m_progressDialog->show();
+    m_loader = new DocumentLoader(stale ? QUrl::fromLocalFile(stale->fileName()) : url, this);
+    connect(m_loader, &DocumentLoader::progress, this, &ProjectManager::slotLoadingProgress);
+    connect(m_loader, &DocumentLoader::finished, this, [this, url, stale, backupOf]() {
+        DocumentLoader *loader = m_loader;
+        m_loader = nullptr;
+        finishOpenFile(loader, url, stale, backupOf);
+        loader->deleteLater();
+        if (m_loader == nullptr) {
+            // Not opening a backup instead
+            loadClipsOnOpen();
+        }
+    });
+    m_loader->start();
+}
+
+void ProjectManager::slotLoadingProgress(const QString &message, int percent)
+{
+    if (!m_progressDialog) {
+        return;
+    }
+    m_progressDialog->setLabelText(message);
+    // Steps without measurable progress show a busy indicator
+    m_progressDialog->setMaximum(percent < 0 ? 0 : 100);
+    if (percent >= 0) {
+        m_progressDialog->setValue(percent);
+    }
+}
+
+void ProjectManager::finishOpenFile(const DocumentLoader *loader, const QUrl &url, KAutoSaveFile *stale, const QUrl &backupOf)
+{
+    m_progressDialog->setLabelText(i18n("Loading project"));
+    m_progressDialog->setMaximum(0);
     bool openBackup;
     m_notesPlugin->clear();
-    KdenliveDoc *doc = new KdenliveDoc(stale ? QUrl::fromLocalFile(stale->fileName()) : url, QString(), pCore->window()->m_commandStack, KdenliveSettings::default_profile().isEmpty() ? KdenliveSettings::current_profile() : KdenliveSettings::default_profile(), QMap<QString, QString> (), QMap<QString, QString> (), QPoint(KdenliveSettings::videotracks(), KdenliveSettings::audiotracks()), pCore->monitorManager()->projectMonitor()->render, m_notesPlugin, &openBackup, pCore->window());
+    KdenliveDoc *doc = new KdenliveDoc(loader, QString(), pCore->window()->m_commandStack, KdenliveSettings::default_profile().isEmpty() ? KdenliveSettings::current_profile() : KdenliveSettings::default_profile(), QMap<QString, QString> (), QMap<QString, QString> (), QPoint(KdenliveSettings::videotracks(), KdenliveSettings::audiotracks()), pCore->monitorManager()->projectMonitor()->render, m_notesPlugin, &openBackup, pCore->window());
     if (stale == nullptr) {
         const QString projectId = QCryptographicHash::hash(url.fileName().toUtf8(), QCryptographicHash::Md5).toHex();
         QUrl autosaveUrl = QUrl::fromLocalFile(QFileInfo(url.path()).absoluteDir().absoluteFilePath(projectId + QStringLiteral(".kdenlive")));
@@ -594,12 +639,17 @@ void ProjectManager::doOpenFile(const QUrl &url, KAutoSaveFile *stale)
 
     pCore->window()->slotGotProgressInfo(QString(), 100);
     pCore->monitorManager()->projectMonitor()->adjustRulerSize(m_trackView->duration() - 1);
-    if (openBackup) {
-        slotOpenBackup(url);
+    if (backupOf.isValid()) {
+        m_project->setUrl(backupOf);
+        m_project->setModified(true);
+        pCore->window()->setWindowTitle(m_project->description());
     }
     m_lastSave.start();
     delete m_progressDialog;
     m_progressDialog = nullptr;
+    if (openBackup) {
+        slotOpenBackup(url);
+    }
 }
 
 void ProjectManager::slotRevert()
@@ -617,7 +667,7 @@ QString ProjectManager::getMimeType(bool open)
 {
     QString mimetype = i18n("Kdenlive project (*.kdenlive)");
     if (open) {
-        mimetype.append(QStringLiteral(";;") + i18n("Archived project (*.tar.gz)"));
+        mimetype.append(QStringLiteral(";;") + i18n("Archived project (*.tar.gz *.zip)"));
     }
     return mimetype;
 }
@@ -647,12 +697,7 @@ void ProjectManager::slotOpenBackup(const QUrl &url)
         QString requestedBackup = dia->selectedFile();
         m_project->backupLastSavedVersion(projectFile.toLocalFile());
         closeCurrentDocument(false);
-        doOpenFile(QUrl::fromLocalFile(requestedBackup), nullptr);
-        if (m_project) {
-            m_project->setUrl(projectFile);
-            m_project->setModified(true);
-            pCore->window()->setWindowTitle(m_project->description());
-        }
+        doOpenFile(QUrl::fromLocalFile(requestedBackup), nullptr, projectFile);
     }
     delete dia;
 }
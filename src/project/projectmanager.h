@@ -23,6 +23,7 @@ the Free Software Foundation, either version 3 of the License, or
 
 class Project;
 class KdenliveDoc;
+class DocumentLoader;
 class NotesPlugin;
 class QAction;
 class QUrl;
@@ -51,7 +52,9 @@ public:
     /** @brief Store command line args for later opening. */
     void init(const QUrl &projectUrl, const QString &clipList);
 
-    void doOpenFile(const QUrl &url, KAutoSaveFile *stale);
+    /** @brief Start opening a project, its file is read in a worker thread and the document is created once it is done.
+     *  @param backupOf if set, the url of the project whose backup @param url is */
+    void doOpenFile(const QUrl &url, KAutoSaveFile *stale, const QUrl &backupOf = QUrl());
     KRecentFilesAction *recentFilesAction();
     void prepareSave();
     /** @brief Disable all bin effects in current project */
@@ -126,6 +129,8 @@ private slots:
     /** @brief Report progress of folder move operation. */
     void slotMoveProgress(KJob *, unsigned long progress);
     void slotMoveFinished(KJob *job);
+    /** @brief Show the progress of the project being read. */
+    void slotLoadingProgress(const QString &message, int percent);
 
 signals:
     void docOpened(KdenliveDoc *document);
@@ -138,6 +143,10 @@ private:
     QString getMimeType(bool open = true);
     /** @brief checks if autoback files exists, recovers from it if user says yes, returns true if files were recovered. */
     bool checkForBackupFile(const QUrl &url, bool newFile = false);
+    /** @brief Create the document read by @param loader and its timeline. */
+    void finishOpenFile(const DocumentLoader *loader, const QUrl &url, KAutoSaveFile *stale, const QUrl &backupOf);
+    /** @brief Add the clips passed on the command line to the project. */
+    void loadClipsOnOpen();
 
     KdenliveDoc *m_project;
     Timeline *m_trackView;
@@ -151,6 +160,8 @@ private:
     KRecentFilesAction *m_recentFilesAction;
     NotesPlugin *m_notesPlugin;
     QProgressDialog *m_progressDialog;
+    /** @brief Reads the project being opened, if any */
+    DocumentLoader *m_loader;
     void saveRecentFiles();
 };
 
@@ -0,0 +1,290 @@
+/*
+Copyright (C) 2018  Jean-Baptiste Mardelle <jb@kdenlive.org>
+This file is part of Kdenlive. See www.kdenlive.org.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sequenceindex.h"
+#include "kdenlive_debug.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QStandardPaths>
+#include <algorithm>
+
+// Increase when the stored data changes, older caches are then discarded
+static const int cacheVersion = 1;
+// Number of folders kept in the cache
+static const int maxCachedFolders = 100;
+
+static QMutex cacheMutex;
+static QMap<QString, SequenceIndex::Folder> cachedFolders;
+static bool cacheLoaded = false;
+
+static QString cacheFile()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/sequences.json");
+}
+
+// Called with cacheMutex locked
+static void loadCache()
+{
+    cacheLoaded = true;
+    QFile file(cacheFile());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    const QJsonObject cache = QJsonDocument::fromJson(file.readAll()).object();
+    if (cache.value(QStringLiteral("version")).toInt() != cacheVersion) {
+        return;
+    }
+    const QJsonObject folders = cache.value(QStringLiteral("folders")).toObject();
+    for (auto i = folders.constBegin(); i != folders.constEnd(); ++i) {
+        const QJsonObject data = i.value().toObject();
+        SequenceIndex::Folder folder;
+        folder.mtime = (qint64) data.value(QStringLiteral("mtime")).toDouble();
+        folder.scanned = (qint64) data.value(QStringLiteral("scanned")).toDouble();
+        const QJsonArray sequences = data.value(QStringLiteral("sequences")).toArray();
+        for (const QJsonValue &value : sequences) {
+            const QJsonObject seqData = value.toObject();
+            SequenceIndex::Sequence sequence;
+            sequence.prefix = seqData.value(QStringLiteral("prefix")).toString();
+            sequence.extension = seqData.value(QStringLiteral("extension")).toString();
+            const QJsonArray ranges = seqData.value(QStringLiteral("ranges")).toArray();
+            for (const QJsonValue &rangeValue : ranges) {
+                const QJsonArray rangeData = rangeValue.toArray();
+                SequenceIndex::Range range;
+                range.start = rangeData.at(0).toInt();
+                range.end = rangeData.at(1).toInt();
+                range.padding = rangeData.at(2).toInt();
+                sequence.ranges << range;
+            }
+            folder.sequences << sequence;
+        }
+        const QJsonArray others = data.value(QStringLiteral("others")).toArray();
+        for (const QJsonValue &value : others) {
+            folder.otherFiles << value.toString();
+        }
+        cachedFolders.insert(i.key(), folder);
+    }
+}
+
+// Called with cacheMutex locked
+static void saveCache()
+{
+    QJsonObject folders;
+    for (auto i = cachedFolders.constBegin(); i != cachedFolders.constEnd(); ++i) {
+        QJsonObject data;
+        data.insert(QStringLiteral("mtime"), (double) i.value().mtime);
+        data.insert(QStringLiteral("scanned"), (double) i.value().scanned);
+        QJsonArray sequences;
+        for (const SequenceIndex::Sequence &sequence : i.value().sequences) {
+            QJsonObject seqData;
+            seqData.insert(QStringLiteral("prefix"), sequence.prefix);
+            seqData.insert(QStringLiteral("extension"), sequence.extension);
+            QJsonArray ranges;
+            for (const SequenceIndex::Range &range : sequence.ranges) {
+                ranges.append(QJsonArray() << range.start << range.end << range.padding);
+            }
+            seqData.insert(QStringLiteral("ranges"), ranges);
+            sequences.append(seqData);
+        }
+        data.insert(QStringLiteral("sequences"), sequences);
+        data.insert(QStringLiteral("others"), QJsonArray::fromStringList(i.value().otherFiles));
+        folders.insert(i.key(), data);
+    }
+    QJsonObject cache;
+    cache.insert(QStringLiteral("version"), cacheVersion);
+    cache.insert(QStringLiteral("folders"), folders);
+    QDir().mkpath(QFileInfo(cacheFile()).absolutePath());
+    QSaveFile file(cacheFile());
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCDebug(KDENLIVE_LOG) << "Cannot write image sequence cache" << file.fileName();
+        return;
+    }
+    file.write(QJsonDocument(cache).toJson(QJsonDocument::Compact));
+    file.commit();
+}
+
+// static
+SequenceIndex::Folder SequenceIndex::scan(const QString &folder)
+{
+    const QString path = QDir::cleanPath(folder);
+    const qint64 mtime = QFileInfo(path).lastModified().toMSecsSinceEpoch();
+    cacheMutex.lock();
+    if (!cacheLoaded) {
+        loadCache();
+    }
+    auto cached = cachedFolders.find(path);
+    if (cached != cachedFolders.end() && cached.value().mtime == mtime) {
+        Folder result = cached.value();
+        cacheMutex.unlock();
+        return result;
+    }
+    cacheMutex.unlock();
+
+    Folder result = listFolder(path);
+    result.mtime = mtime;
+    result.scanned = QDateTime::currentMSecsSinceEpoch();
+    if (result.scanned - mtime < 2000) {
+        // The folder is being written (for example by a capture), another file could be added without changing its modification time
+        return result;
+    }
+    QMutexLocker lock(&cacheMutex);
+    cachedFolders.insert(path, result);
+    while (cachedFolders.count() > maxCachedFolders) {
+        auto oldest = cachedFolders.begin();
+        for (auto i = cachedFolders.begin(); i != cachedFolders.end(); ++i) {
+            if (i.value().scanned < oldest.value().scanned) {
+                oldest = i;
+            }
+        }
+        cachedFolders.erase(oldest);
+    }
+    saveCache();
+    return result;
+}
+
+// static
+SequenceIndex::Folder SequenceIndex::listFolder(const QString &folder)
+{
+    Folder result;
+    // Frame numbers and padding, by prefix and extension
+    QHash<QPair<QString, QString>, QVector<QPair<int, int> > > numbered;
+    const QStringList names = QDir(folder).entryList(QDir::Files, QDir::NoSort);
+    for (const QString &name : names) {
+        int dot = name.lastIndexOf(QLatin1Char('.'));
+        int digitsEnd = dot > 0 ? dot : name.length();
+        int digitsStart = digitsEnd;
+        while (digitsStart > 0 && name.at(digitsStart - 1).isDigit()) {
+            digitsStart--;
+        }
+        int digits = digitsEnd - digitsStart;
+        if (digits == 0 || digits > 9) {
+            result.otherFiles << name;
+            continue;
+        }
+        const QStringRef number = name.midRef(digitsStart, digits);
+        int padding = (digits > 1 && number.at(0) == QLatin1Char('0')) ? digits : 0;
+        numbered[qMakePair(name.left(digitsStart), name.mid(digitsEnd))] << qMakePair(padding, number.toInt());
+    }
+    for (auto i = numbered.begin(); i != numbered.end(); ++i) {
+        Sequence sequence;
+        sequence.prefix = i.key().first;
+        sequence.extension = i.key().second;
+        QVector<QPair<int, int> > &frames = i.value();
+        std::sort(frames.begin(), frames.end());
+        Range range;
+        range.padding = frames.first().first;
+        range.start = range.end = frames.first().second;
+        for (int j = 1; j < frames.count(); ++j) {
+            const QPair<int, int> &frame = frames.at(j);
+            if (frame.first == range.padding && frame.second == range.end + 1) {
+                range.end = frame.second;
+                continue;
+            }
+            sequence.ranges << range;
+            range.padding = frame.first;
+            range.start = range.end = frame.second;
+        }
+        sequence.ranges << range;
+        result.sequences << sequence;
+    }
+    return result;
+}
+
+// static
+QVector<int> SequenceIndex::frames(const Folder &folder, const QString &prefix, const QString &extension, int precision)
+{
+    QVector<int> result;
+    // Numbers that are not padded only match if they have at least precision digits
+    int minFrame = 0;
+    for (int i = 1; i < precision; ++i) {
+        minFrame = minFrame == 0 ? 10 : minFrame * 10;
+    }
+    for (const Sequence &sequence : folder.sequences) {
+        if (sequence.prefix != prefix || sequence.extension != extension) {
+            continue;
+        }
+        for (const Range &range : sequence.ranges) {
+            int start = range.start;
+            if (range.padding > 0) {
+                if (range.padding != precision) {
+                    continue;
+                }
+            } else {
+                start = qMax(start, minFrame);
+            }
+            for (int frame = start; frame <= range.end; ++frame) {
+                result << frame;
+            }
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+// static
+QStringList SequenceIndex::files(const Folder &folder, const QString &extension)
+{
+    QStringList result;
+    const QString suffix = QLatin1Char('.') + extension;
+    for (const Sequence &sequence : folder.sequences) {
+        if (!sequence.extension.endsWith(suffix, Qt::CaseInsensitive)) {
+            continue;
+        }
+        for (const Range &range : sequence.ranges) {
+            for (int frame = range.start; frame <= range.end; ++frame) {
+                result << fileName(sequence.prefix, frame, range.padding, sequence.extension);
+            }
+        }
+    }
+    for (const QString &name : folder.otherFiles) {
+        if (name.endsWith(suffix, Qt::CaseInsensitive)) {
+            result << name;
+        }
+    }
+    result.sort();
+    return result;
+}
+
+// static
+QVector<QPair<int, int> > SequenceIndex::gaps(const QVector<int> &frames)
+{
+    QVector<QPair<int, int> > result;
+    for (int i = 1; i < frames.count(); ++i) {
+        if (frames.at(i) > frames.at(i - 1) + 1) {
+            result << qMakePair(frames.at(i - 1) + 1, frames.at(i) - 1);
+        }
+    }
+    return result;
+}
+
+// static
+QString SequenceIndex::fileName(const QString &prefix, int frame, int precision, const QString &extension)
+{
+    return prefix + QString::number(frame).rightJustified(precision, QLatin1Char('0'), false) + extension;
+}
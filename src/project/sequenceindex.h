@@ -0,0 +1,78 @@
+/*
+Copyright (C) 2018  Jean-Baptiste Mardelle <jb@kdenlive.org>
+This file is part of Kdenlive. See www.kdenlive.org.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SEQUENCEINDEX_H
+#define SEQUENCEINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QPair>
+
+/**
+ * @class SequenceIndex
+ * @brief Detects the image sequences of a folder, collapsing numbered files into ranges.
+ *
+ * A folder is listed once and each file name is split into prefix, frame number and extension.
+ * The result is cached on disk with the folder modification time, so that large sequences
+ * are not listed again until their folder changes.
+ */
+class SequenceIndex
+{
+public:
+    struct Range {
+        Range() : start(0), end(0), padding(0) {}
+        int start;
+        int end;
+        /** @brief Number of digits if the frame numbers are padded with zeros, 0 otherwise. */
+        int padding;
+    };
+    struct Sequence {
+        QString prefix;
+        /** @brief File extension, including the dot. */
+        QString extension;
+        QVector<Range> ranges;
+    };
+    struct Folder {
+        Folder() : mtime(0), scanned(0) {}
+        qint64 mtime;
+        qint64 scanned;
+        QVector<Sequence> sequences;
+        /** @brief Files that are not numbered. */
+        QStringList otherFiles;
+    };
+
+    /** @brief Returns the content of @param folder, from the cache if it did not change since it was scanned. Can be called from any thread. */
+    static Folder scan(const QString &folder);
+    /** @brief Returns the sorted frame numbers of the files named prefix + number on @param precision digits + extension. */
+    static QVector<int> frames(const Folder &folder, const QString &prefix, const QString &extension, int precision);
+    /** @brief Returns the sorted names of all files with @param extension (without dot). */
+    static QStringList files(const Folder &folder, const QString &extension);
+    /** @brief Returns the missing frame ranges in sorted @param frames. */
+    static QVector<QPair<int, int> > gaps(const QVector<int> &frames);
+    /** @brief Returns the name of a frame file, as used in MLT patterns like image_%04d.png. */
+    static QString fileName(const QString &prefix, int frame, int precision, const QString &extension);
+
+private:
+    static Folder listFolder(const QString &folder);
+};
+
+#endif
@@ -442,12 +442,14 @@ void Render::startConsumer()
     m_isActive = true;
 }
 
-int Render::setSceneList(const QDomDocument &list, int position)
+int Render::setSceneList(const QString &playlist, int position)
 {
-    return setSceneList(list.toString(), position);
+    QDomDocument doc;
+    doc.setContent(playlist);
+    return setSceneList(doc, position);
 }
 
-int Render::setSceneList(QString playlist, int position)
+int Render::setSceneList(const QDomDocument &list, int position)
 {
     requestedSeekPosition = SEEK_INACTIVE;
     m_refreshTimer.stop();
@@ -455,14 +457,17 @@ int Render::setSceneList(QString playlist, int position)
     //if (m_winid == -1) return -1;
     int error = 0;
 
-    //qCDebug(KDENLIVE_LOG) << "//////  RENDER, SET SCENE LIST:\n" << playlist <<"\n..........:::.";
-
-    // Remove previous profile info
-    QDomDocument doc;
-    doc.setContent(playlist);
-    QDomElement profile = doc.documentElement().firstChildElement(QStringLiteral("profile"));
-    doc.documentElement().removeChild(profile);
-    playlist = doc.toString();
+    // Remove previous profile info while serializing, the document itself is left unchanged
+    QDomElement root = list.documentElement();
+    QDomElement profile = root.firstChildElement(QStringLiteral("profile"));
+    QDomNode profileNext = profile.nextSibling();
+    if (!profile.isNull()) {
+        root.removeChild(profile);
+    }
+    const QByteArray playlist = list.toByteArray();
+    if (!profile.isNull()) {
+        root.insertBefore(profile, profileNext);
+    }
 
     if (m_mltConsumer) {
         if (!m_mltConsumer->is_stopped()) {
@@ -486,10 +491,10 @@ int Render::setSceneList(QString playlist, int position)
     blockSignals(true);
     m_locale = QLocale();
     m_locale.setNumberOptions(QLocale::OmitGroupSeparator);
-    m_mltProducer = new Mlt::Producer(*m_qmlView->profile(), "xml-string", playlist.toUtf8().constData());
-    //m_mltProducer = new Mlt::Producer(*m_qmlView->profile(), "xml-nogl-string", playlist.toUtf8().constData());
+    m_mltProducer = new Mlt::Producer(*m_qmlView->profile(), "xml-string", playlist.constData());
+    //m_mltProducer = new Mlt::Producer(*m_qmlView->profile(), "xml-nogl-string", playlist.constData());
     if (!m_mltProducer || !m_mltProducer->is_valid()) {
-        qCDebug(KDENLIVE_LOG) << " WARNING - - - - -INVALID PLAYLIST: " << playlist.toUtf8().constData();
+        qCDebug(KDENLIVE_LOG) << " WARNING - - - - -INVALID PLAYLIST: " << playlist.constData();
         m_mltProducer = m_blackClip->cut(0, 1);
         error = -1;
     }
@@ -504,7 +509,7 @@ int Render::setSceneList(QString playlist, int position)
     }
 
     // init MLT's document root, useful to find full urls
-    m_binController->setDocumentRoot(doc.documentElement().attribute(QStringLiteral("root")));
+    m_binController->setDocumentRoot(root.attribute(QStringLiteral("root")));
 
     // Fill Bin's playlist
     Mlt::Service service(m_mltProducer->parent().get_service());
@@ -527,6 +532,8 @@ int Render::setSceneList(QString playlist, int position)
         QString retain = QStringLiteral("xml_retain %1").arg(m_binController->binPlaylistId());
         tractor.set(retain.toUtf8().constData(), m_binController->service(), 0);
         //if (!m_binController->hasClip("black")) m_binController->addClipToBin("black", *m_blackClip);
+        // Play and meter the timeline with all the channels of its clips
+        m_qmlView->setAudioFormat(m_binController->audioChannels(), 48000);
         m_qmlView->setProducer(m_mltProducer);
         m_mltConsumer = m_qmlView->consumer();
     }
@@ -772,6 +779,7 @@ void Render::switchPlay(bool play, double speed)
         }
         m_mltProducer->set_speed(speed);
     } else {
+        m_qmlView->resetPreviewScale();
         m_mltConsumer->set("real_time", -1);
         m_mltConsumer->set("buffer", 0);
         m_mltConsumer->set("prefill", 0);
@@ -807,6 +815,8 @@ void Render::play(double speed)
         m_mltConsumer->start();
         m_isRefreshing = true;
         m_mltConsumer->set("refresh", 1);
+    } else if (speed == 0) {
+        m_qmlView->resetPreviewScale();
     }
     m_mltProducer->set_speed(speed);
 }
@@ -1058,33 +1068,6 @@ void Render::slotCheckSeeking()
     }
 }
 
-void Render::showAudio(Mlt::Frame &frame)
-{
-    if (!frame.is_valid() || frame.get_int("test_audio") != 0) {
-        return;
-    }
-
-    mlt_audio_format audio_format = mlt_audio_s16;
-    //FIXME: should not be hardcoded..
-    int freq = 48000;
-    int num_channels = 2;
-    int samples = 0;
-    qint16 *data = (qint16 *)frame.get_audio(audio_format, freq, num_channels, samples);
-
-    if (!data) {
-        return;
-    }
-
-    // Data format: [ c00 c10 c01 c11 c02 c12 c03 c13 ... c0{samples-1} c1{samples-1} for 2 channels.
-    // So the vector is of size samples*channels.
-    audioShortVector sampleVector(samples * num_channels);
-    memcpy(sampleVector.data(), data, samples * num_channels * sizeof(qint16));
-
-    if (samples > 0) {
-        emit audioSamplesSignal(sampleVector, freq, num_channels, samples);
-    }
-}
-
 /*
  * MLT playlist direct manipulation.
  */
@@ -114,16 +114,16 @@ Q_OBJECT public:
 
     /** @brief Sets the current MLT producer playlist.
      * @param list The xml describing the playlist
-     * @param position (optional) time to seek to */
-    int setSceneList(const QDomDocument &list, int position = 0);
-
-    /** @brief Sets the current MLT producer playlist.
-     * @param list new playlist
      * @param position (optional) time to seek to
      * @return 0 when it has success, different from 0 otherwise
      *
-     * Creates the producer from the text playlist. */
-    int setSceneList(QString playlist, int position = 0);
+     * The document is serialized once and parsed by MLT, bin and tracks are then read from the resulting tractor. */
+    int setSceneList(const QDomDocument &list, int position = 0);
+
+    /** @brief Sets the current MLT producer playlist from its text.
+     * @param playlist new playlist
+     * @param position (optional) time to seek to */
+    int setSceneList(const QString &playlist, int position = 0);
     bool updateProducer(Mlt::Producer *producer);
     bool setProducer(Mlt::Producer *producer, int position, bool isActive);
 
@@ -198,8 +198,6 @@ Q_OBJECT public:
     /** @brief Sets an MLT consumer property. */
     void setConsumerProperty(const QString &name, const QString &value);
 
-    void showAudio(Mlt::Frame &);
-
     QList<int> checkTrackSequence(int);
     void sendFrameUpdate() Q_DECL_OVERRIDE;
 
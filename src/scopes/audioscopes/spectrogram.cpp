@@ -22,6 +22,8 @@
 // highest vertical screen resolution available for complete reconstruction.
 // Can be less as a pre-rendered image is kept in space.
 #define SPECTROGRAM_HISTORY_SIZE 1000
+// Maximum number of frequency values per spectrum, half of the largest FFT window.
+#define SPECTROGRAM_MAX_BINS 1024
 
 // Uncomment for debugging
 //#define DEBUG_SPECTROGRAM
@@ -38,7 +40,11 @@ Spectrogram::Spectrogram(QWidget *parent) :
     AbstractAudioScopeWidget(true, parent)
     , m_fftTools()
     , m_fftHistory()
+    , m_fftHistoryBins(SPECTROGRAM_HISTORY_SIZE, 0)
+    , m_fftHistoryHead(SPECTROGRAM_HISTORY_SIZE - 1)
+    , m_fftHistoryCount(0)
     , m_fftHistoryImg()
+    , m_dbMap()
     , m_dBmin(-70)
     , m_dBmax(0)
     , m_freqMax(0)
@@ -337,19 +343,25 @@ QImage Spectrogram::renderAudioScope(uint, const audioShortVector &audioFrame, c
         ui->labelFFTSizeNumber->setText(QVariant(fftWindow).toString());
 
         if (newDataAvailable) {
+            // The history is only allocated once the scope is actually used
+            if (m_fftHistory.isEmpty()) {
+                m_fftHistory.resize(SPECTROGRAM_HISTORY_SIZE * SPECTROGRAM_MAX_BINS);
+            }
+            if (fftWindow > 2 * SPECTROGRAM_MAX_BINS) {
+                fftWindow = 2 * SPECTROGRAM_MAX_BINS;
+            }
 
-            float freqSpectrum[fftWindow / 2];
+            // This method might be called also when a simple refresh is required.
+            // In this case there is no data to append to the history. Only append new data,
+            // overwriting the oldest row of the ring buffer once it is full.
+            m_fftHistoryHead = (m_fftHistoryHead + 1) % SPECTROGRAM_HISTORY_SIZE;
+            m_fftHistoryCount = qMin(m_fftHistoryCount + 1, SPECTROGRAM_HISTORY_SIZE);
+            m_fftHistoryBins[m_fftHistoryHead] = fftWindow / 2;
 
             // Get the spectral power distribution of the input samples,
-            // using the given window size and function
+            // using the given window size and function, directly into the history
             FFTTools::WindowType windowType = (FFTTools::WindowType) ui->windowFunction->itemData(ui->windowFunction->currentIndex()).toInt();
-            m_fftTools.fftNormalized(audioFrame, 0, num_channels, freqSpectrum, windowType, fftWindow, 0);
-
-            // This methid might be called also when a simple refresh is required.
-            // In this case there is no data to append to the history. Only append new data.
-            QVector<float> spectrumVector(fftWindow / 2);
-            memcpy(spectrumVector.data(), &freqSpectrum[0], fftWindow / 2 * sizeof(float));
-            m_fftHistory.prepend(spectrumVector);
+            m_fftTools.fftNormalized(audioFrame, 0, num_channels, m_fftHistory.data() + m_fftHistoryHead * SPECTROGRAM_MAX_BINS, windowType, fftWindow, 0);
         }
 #ifdef DEBUG_SPECTROGRAM
         else {
@@ -357,99 +369,77 @@ QImage Spectrogram::renderAudioScope(uint, const audioShortVector &audioFrame, c
         }
 #endif
 
-        // Limit the maximum history size to avoid wasting space
-        while (m_fftHistory.size() > SPECTROGRAM_HISTORY_SIZE) {
-            m_fftHistory.removeLast();
-        }
-
         // Draw the spectrum
-        QImage spectrum(m_scopeRect.size(), QImage::Format_ARGB32);
-        spectrum.fill(qRgba(0, 0, 0, 0));
-        QPainter davinci(&spectrum);
-        const uint h = m_innerScopeRect.height();
-        const uint leftDist = m_innerScopeRect.left() - m_scopeRect.left();
-        const uint topDist = m_innerScopeRect.top() - m_scopeRect.top();
-        uint windowSize;
-        uint y;
-        bool completeRedraw = true;
-
-        if (m_fftHistoryImg.size() == m_scopeRect.size() && !m_parameterChanged) {
-            // The size of the widget and the parameters (like min/max dB) have not changed since last time,
-            // so we can re-use it, shift it by one pixel, and render the single remaining line. Usually about
-            // 10 times faster for a widget height of around 400 px.
-            if (newDataAvailable) {
-                davinci.drawImage(0, -1, m_fftHistoryImg);
-            } else {
-                // spectrum = m_fftHistoryImg does NOT work, leads to segfaults (anyone knows why, please tell me)
-                davinci.drawImage(0, 0, m_fftHistoryImg);
-            }
-            completeRedraw = false;
-        }
+        const int topDist = m_innerScopeRect.top() - m_scopeRect.top();
+        const int h = qMin(m_innerScopeRect.height(), m_scopeRect.height() - topDist);
+        int y = 0;
+        bool completeRedraw = m_fftHistoryImg.size() != m_scopeRect.size() || m_parameterChanged;
 
-        y = 0;
-        if (newData || m_parameterChanged) {
+        if (completeRedraw) {
+            // Size or parameters (like min/max dB) have changed, render all lines from the history
             m_parameterChanged = false;
-            bool peak = false;
-
-            QVector<float> dbMap;
-            uint right;
-            ////////////////FIXME
-            for (QList<QVector<float> >::iterator it = m_fftHistory.begin(); it != m_fftHistory.end(); ++it) {
-
-                windowSize = (*it).size();
-
-                // Interpolate the frequency data to match the pixel coordinates
-                right = ((float) m_freqMax) / (m_freq / 2) * (windowSize - 1);
-                dbMap = FFTTools::interpolatePeakPreserving((*it), m_innerScopeRect.width(), 0, right, -180);
-
-                for (int i = 0; i < dbMap.size(); ++i) {
-                    float val;
-                    val = dbMap[i];
-                    peak = val > m_dBmax;
-
-                    // Normalize dB value to [0 1], 1 corresponding to dbMax dB and 0 to dbMin dB
-                    val = (val - m_dBmax) / (m_dBmax - m_dBmin) + 1;
-                    if (val < 0) {
-                        val = 0;
-                    } else if (val > 1) {
-                        val = 1;
-                    }
-                    if (!peak || !m_aHighlightPeaks->isChecked()) {
-                        spectrum.setPixel(leftDist + i, topDist + h - 1 - y, m_colorMap[(int)(val * 255)]);
-                    } else {
-                        spectrum.setPixel(leftDist + i, topDist + h - 1 - y, AbstractScopeWidget::colHighlightDark.rgba());
-                    }
-                }
-
-                y++;
-                if (y >= topDist + m_innerScopeRect.height()) {
-                    break;
-                }
-                if (!completeRedraw) {
-                    break;
-                }
+            m_fftHistoryImg = QImage(m_scopeRect.size(), QImage::Format_ARGB32);
+            m_fftHistoryImg.fill(qRgba(0, 0, 0, 0));
+            for (; y < m_fftHistoryCount && y < h; ++y) {
+                const int row = (m_fftHistoryHead - y + SPECTROGRAM_HISTORY_SIZE) % SPECTROGRAM_HISTORY_SIZE;
+                drawHistoryRow(m_fftHistoryImg, row, topDist + h - 1 - y);
             }
+        } else if (newDataAvailable && h > 0) {
+            // The size of the widget and the parameters have not changed since last time,
+            // so we can re-use the image, shift it by one line, and render the single remaining line.
+            const int bytesPerLine = m_fftHistoryImg.bytesPerLine();
+            uchar *bits = m_fftHistoryImg.bits();
+            memmove(bits + topDist * bytesPerLine, bits + (topDist + 1) * bytesPerLine, (size_t)((h - 1) * bytesPerLine));
+            drawHistoryRow(m_fftHistoryImg, m_fftHistoryHead, topDist + h - 1);
+            y = 1;
         }
 
 #ifdef DEBUG_SPECTROGRAM
-        qCDebug(KDENLIVE_LOG) << "Rendered " << y - topDist << "lines from " << m_fftHistory.size() << " available samples in " << start.elapsed() << " ms"
+        qCDebug(KDENLIVE_LOG) << "Rendered " << y << "lines from " << m_fftHistoryCount << " available samples in " << start.elapsed() << " ms"
                               << (completeRedraw ? "" : " (re-used old image)");
-        uint storedBytes = 0;
-        for (QList< QVector<float> >::iterator it = m_fftHistory.begin(); it != m_fftHistory.end(); ++it) {
-            storedBytes += (*it).size() * sizeof((*it)[0]);
-        }
-        qCDebug(KDENLIVE_LOG) << QString("Total storage used: %1 kB").arg((double)storedBytes / 1000, 0, 'f', 2);
+        qCDebug(KDENLIVE_LOG) << QString("Total storage used: %1 kB").arg((double)m_fftHistory.size() * sizeof(float) / 1000, 0, 'f', 2);
+#else
+        Q_UNUSED(y)
 #endif
 
-        m_fftHistoryImg = spectrum;
-
         emit signalScopeRenderingFinished(start.elapsed(), 1);
-        return spectrum;
+        return m_fftHistoryImg;
     } else {
         emit signalScopeRenderingFinished(0, 1);
         return QImage();
     }
 }
+void Spectrogram::drawHistoryRow(QImage &image, int row, int y)
+{
+    const int bins = m_fftHistoryBins.at(row);
+    const int leftDist = m_innerScopeRect.left() - m_scopeRect.left();
+    const int width = qMin(m_innerScopeRect.width(), image.width() - leftDist);
+    if (bins < 2 || width < 1) {
+        return;
+    }
+    const float *spectrum = m_fftHistory.constData() + row * SPECTROGRAM_MAX_BINS;
+
+    // Interpolate the frequency data to match the pixel coordinates
+    const uint right = ((float) m_freqMax) / (m_freq / 2) * (bins - 1);
+    m_dbMap.resize(width);
+    FFTTools::interpolatePeakPreserving(spectrum, bins, m_dbMap.data(), width, 0, right, -180);
+
+    const bool highlightPeaks = m_aHighlightPeaks->isChecked();
+    const QRgb peakColor = AbstractScopeWidget::colHighlightDark.rgba();
+    const float dBrange = m_dBmax - m_dBmin;
+    QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y)) + leftDist;
+    for (int i = 0; i < width; ++i) {
+        const float val = m_dbMap.at(i);
+        if (highlightPeaks && val > m_dBmax) {
+            line[i] = peakColor;
+            continue;
+        }
+        // Normalize dB value to [0 1], 1 corresponding to dbMax dB and 0 to dbMin dB
+        const float normalized = qBound(0.0f, (val - m_dBmax) / dBrange + 1, 1.0f);
+        line[i] = m_colorMap[(int)(normalized * 255)];
+    }
+}
+
 QImage Spectrogram::renderBackground(uint)
 {
     return QImage();
@@ -550,6 +540,7 @@ void Spectrogram::resizeEvent(QResizeEvent *event)
 }
 
 #undef SPECTROGRAM_HISTORY_SIZE
+#undef SPECTROGRAM_MAX_BINS
 #ifdef DEBUG_SPECTROGRAM
 #undef DEBUG_SPECTROGRAM
 #endif
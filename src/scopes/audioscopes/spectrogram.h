@@ -62,8 +62,18 @@ private:
     QAction *m_aTrackMouse;
     QAction *m_aHighlightPeaks;
 
-    QList<QVector<float> > m_fftHistory;
+    /** Ring buffer of spectral power distributions, SPECTROGRAM_HISTORY_SIZE rows of
+        SPECTROGRAM_MAX_BINS values in a single allocation. Row lengths are stored
+        in m_fftHistoryBins since the window size can change over time. */
+    QVector<float> m_fftHistory;
+    QVector<int> m_fftHistoryBins;
+    /** Row of the most recent spectrum */
+    int m_fftHistoryHead;
+    /** Number of valid rows in the history */
+    int m_fftHistoryCount;
     QImage m_fftHistoryImg;
+    /** Interpolation buffer for drawing one row */
+    QVector<float> m_dbMap;
 
     int m_dBmin;
     int m_dBmax;
@@ -76,6 +86,9 @@ private:
     QRect m_innerScopeRect;
     QRgb m_colorMap[256];
 
+    /** Draws the spectrum at position @param row of the history into line @param y of the image */
+    void drawHistoryRow(QImage &image, int row, int y);
+
 private slots:
     void slotResetMaxFreq();
 
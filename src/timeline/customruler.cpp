@@ -432,61 +432,29 @@ void CustomRuler::paintEvent(QPaintEvent *e)
     int zoneHeight = LABEL_SIZE * 0.8;
     p.fillRect(zoneStart - m_offset, MAX_HEIGHT - zoneHeight + 1, zoneEnd - zoneStart, zoneHeight - 1, m_zoneBG);
 
-    double f, fend;
-    const int offsetmax = ((paintRect.right() + m_offset) / FRAME_SIZE + 1) * FRAME_SIZE;
-    int offsetmin;
-
-    p.setPen(palette().text().color());
-    // draw time labels
-    if (paintRect.y() < LABEL_SIZE) {
-        offsetmin = (paintRect.left() + m_offset) / m_textSpacing;
-        offsetmin = offsetmin * m_textSpacing;
-        for (f = offsetmin; f < offsetmax; f += m_textSpacing) {
-            QString lab;
-            if (KdenliveSettings::frametimecode()) {
-                lab = QString::number((int)(f / m_factor + 0.5));
-            } else {
-                lab = m_timecode.getTimecodeFromFrames((int)(f / m_factor + 0.5));
-            }
-            p.drawText(f - m_offset + 2, LABEL_SIZE, lab);
-        }
+    // Labels and marks only change with zoom, they are drawn from cached tiles
+    if (paintRect.y() <= MAX_HEIGHT) {
+        RulerTiles::Layout layout;
+        layout.timecode = m_timecode;
+        layout.frameTimecode = KdenliveSettings::frametimecode();
+        layout.factor = m_factor;
+        layout.textSpacing = m_textSpacing;
+        layout.littleMarks = m_scale * littleMarkDistance;
+        layout.mediumMarks = m_scale * mediumMarkDistance;
+        layout.bigMarks = m_scale * bigMarkDistance;
+        layout.labelBottom = LABEL_SIZE;
+        layout.littleMarkTop = LITTLE_MARK_X;
+        layout.mediumMarkTop = MIDDLE_MARK_X;
+        layout.height = MAX_HEIGHT;
+        layout.font = font();
+        layout.textColor = palette().text().color();
+        layout.markColor = palette().dark().color();
+        layout.devicePixelRatio = devicePixelRatio();
+        m_tiles.setLayout(layout);
+        m_tiles.draw(&p, paintRect.left(), paintRect.right(), m_offset);
     }
     p.setPen(palette().dark().color());
-    offsetmin = (paintRect.left() + m_offset) / littleMarkDistance;
-    offsetmin = offsetmin * littleMarkDistance;
-    // draw the little marks
-    fend = m_scale * littleMarkDistance;
-    if (fend > 5) {
-        QLineF l(offsetmin - m_offset, LITTLE_MARK_X, offsetmin - m_offset, MAX_HEIGHT);
-        for (f = offsetmin; f < offsetmax; f += fend) {
-            l.translate(fend, 0);
-            p.drawLine(l);
-        }
-    }
 
-    offsetmin = (paintRect.left() + m_offset) / mediumMarkDistance;
-    offsetmin = offsetmin * mediumMarkDistance;
-    // draw medium marks
-    fend = m_scale * mediumMarkDistance;
-    if (fend > 5) {
-        QLineF l(offsetmin - m_offset - fend, MIDDLE_MARK_X, offsetmin - m_offset - fend, MAX_HEIGHT);
-        for (f = offsetmin - fend; f < offsetmax + fend; f += fend) {
-            l.translate(fend, 0);
-            p.drawLine(l);
-        }
-    }
-
-    offsetmin = (paintRect.left() + m_offset) / bigMarkDistance;
-    offsetmin = offsetmin * bigMarkDistance;
-    // draw big marks
-    fend = m_scale * bigMarkDistance;
-    if (fend > 5) {
-        QLineF l(offsetmin - m_offset, LABEL_SIZE, offsetmin - m_offset, MAX_HEIGHT);
-        for (f = offsetmin; f < offsetmax; f += fend) {
-            l.translate(fend, 0);
-            p.drawLine(l);
-        }
-    }
     // draw zone handles
     if (zoneStart > 0) {
         QPolygon pa(4);
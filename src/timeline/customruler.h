@@ -31,6 +31,7 @@
 
 #include "timeline/customtrackview.h"
 #include "timecode.h"
+#include "rulertiles.h"
 
 enum RULER_MOVE { RULER_CURSOR = 0, RULER_START = 1, RULER_MIDDLE = 2, RULER_END = 3 };
 enum MOUSE_MOVE { NO_MOVE = 0, HORIZONTAL_MOVE = 1, VERTICAL_MOVE = 2 };
@@ -101,6 +102,8 @@ private:
     QMenu *m_goMenu;
     QList<int> m_renderingPreviews;
     QList<int> m_dirtyRenderingPreviews;
+    /** @brief Rendered labels and marks of the ruler */
+    RulerTiles m_tiles;
 
 public slots:
     void slotMoveRuler(int newPos);
@@ -68,6 +68,7 @@
 #include <QMimeData>
 
 #include <QGraphicsDropShadowEffect>
+#include <QtMath>
 
 #define SEEK_INACTIVE (-1)
 //#define DEBUG
@@ -3731,6 +3732,8 @@ void CustomTrackView::addTrack(const TrackInfo &type, int ix)
     }
     // insert track in MLT's playlist
     transitionInfos = m_document->renderer()->mltInsertTrack(ix,  type.trackName, type.type == VideoTrack);
+    // Transition tracks were shifted and a mix was planted by the renderer
+    m_timeline->transitionHandler->invalidateIndex();
     Mlt::Tractor *tractor = m_document->renderer()->lockService();
     m_document->renderer()->unlockService(tractor);
     // Reload timeline and m_tracks structure from MLT's playlist
@@ -3796,6 +3799,7 @@ void CustomTrackView::removeTrack(int ix)
         if (mixTr) {
             field->disconnect_service(*mixTr.data());
         }
+        m_timeline->transitionHandler->invalidateIndex();
     }
     // Prepare groups for reload
     QDomDocument doc;
@@ -3831,6 +3835,8 @@ void CustomTrackView::removeTrack(int ix)
 
     // Delete track in MLT playlist
     tractor->remove_track(ix);
+    // Transitions of the upper tracks were moved down by MLT
+    m_timeline->transitionHandler->invalidateIndex();
     m_document->renderer()->unlockService(tractor);
     reloadTimeline();
     // Refresh track compositing and audio mix
@@ -4121,10 +4127,8 @@ void CustomTrackView::insertTimelineSpace(GenTime startPos, GenTime duration, in
 void CustomTrackView::insertSpace(const QList<ItemInfo> &clipsToMove, const QList<ItemInfo> &transToMove, int track, const GenTime &duration, const GenTime &offset)
 {
     int diff = duration.frames(m_document->fps());
+    int moveOffset = offset.frames(m_document->fps());
     resetSelectionGroup();
-    m_selectionMutex.lock();
-    m_selectionGroup = new AbstractGroupItem(m_document->fps());
-    scene()->addItem(m_selectionGroup);
 
     // Create lists with start pos for each track
     QMap<int, int> trackClipStartList;
@@ -4134,78 +4138,122 @@ void CustomTrackView::insertSpace(const QList<ItemInfo> &clipsToMove, const QLis
         trackClipStartList[i] = -1;
         trackTransitionStartList[i] = -1;
     }
-    if (!clipsToMove.isEmpty()) for (int i = 0; i < clipsToMove.count(); ++i) {
-            ClipItem *clip = getClipItemAtStart(clipsToMove.at(i).startPos + offset, clipsToMove.at(i).track);
-            if (clip) {
-                if (clip->parentItem()) {
-                    m_selectionGroup->addItem(clip->parentItem());
-                } else {
-                    m_selectionGroup->addItem(clip);
-                }
-                if (trackClipStartList.value(clipsToMove.at(i).track) == -1 || clipsToMove.at(i).startPos.frames(m_document->fps()) < trackClipStartList.value(clipsToMove.at(i).track)) {
-                    trackClipStartList[clipsToMove.at(i).track] = clipsToMove.at(i).startPos.frames(m_document->fps());
-                }
-            } else {
-                emit displayMessage(i18n("Cannot move clip at position %1, track %2", m_document->timecode().getTimecodeFromFrames((clipsToMove.at(i).startPos + offset).frames(m_document->fps())), clipsToMove.at(i).track), ErrorMessage);
-            }
-        }
-    if (!transToMove.isEmpty()) for (int i = 0; i < transToMove.count(); ++i) {
-            Transition *transition = getTransitionItemAtStart(transToMove.at(i).startPos + offset, transToMove.at(i).track);
-            if (transition) {
-                if (transition->parentItem()) {
-                    // If group has a locked item, ungroup first
-                    AbstractGroupItem *grp = static_cast <AbstractGroupItem *>(transition->parentItem());
-                    if (grp->isItemLocked()) {
-                        m_document->clipManager()->removeGroup(grp);
-                        if (grp == m_selectionGroup) {
-                            m_selectionGroup = nullptr;
+    int firstPos = -1;
+    for (const ItemInfo &info : clipsToMove) {
+        int pos = info.startPos.frames(m_document->fps());
+        firstPos = firstPos == -1 ? pos : qMin(firstPos, pos);
+    }
+    for (const ItemInfo &info : transToMove) {
+        int pos = info.startPos.frames(m_document->fps());
+        firstPos = firstPos == -1 ? pos : qMin(firstPos, pos);
+    }
+    if (firstPos == -1) {
+        m_document->renderer()->mltInsertSpace(trackClipStartList, trackTransitionStartList, track, duration, offset);
+        m_timeline->transitionHandler->invalidateIndex();
+        return;
+    }
+
+    // Index the items that can move by track and start position, in a single scene query
+    QHash<QPair<int, int>, ClipItem *> clips;
+    QHash<QPair<int, int>, Transition *> transitions;
+    const QRectF sceneArea = scene()->sceneRect();
+    const QRectF area(firstPos + moveOffset, sceneArea.top(), qMax(sceneArea.right() - firstPos - moveOffset, 0.) + 1, sceneArea.height());
+    const QList<QGraphicsItem *> itemList = scene()->items(area, Qt::IntersectsItemBoundingRect);
+    for (QGraphicsItem *item : itemList) {
+        if (!item->isEnabled()) {
+            continue;
+        }
+        if (item->type() == AVWidget) {
+            ClipItem *clip = static_cast<ClipItem *>(item);
+            clips.insert(qMakePair(clip->track(), (int) clip->startPos().frames(m_document->fps())), clip);
+        } else if (item->type() == TransitionWidget) {
+            Transition *transition = static_cast<Transition *>(item);
+            transitions.insert(qMakePair(transition->track(), (int) transition->startPos().frames(m_document->fps())), transition);
+        }
+    }
+
+    // Collect the top level items to move, a group moves with all its children
+    QList<QGraphicsItem *> toMove;
+    QSet<QGraphicsItem *> collected;
+    for (int i = 0; i < clipsToMove.count(); ++i) {
+        const ItemInfo &info = clipsToMove.at(i);
+        ClipItem *clip = clips.value(qMakePair(info.track, (int) (info.startPos + offset).frames(m_document->fps())));
+        if (!clip) {
+            emit displayMessage(i18n("Cannot move clip at position %1, track %2", m_document->timecode().getTimecodeFromFrames((info.startPos + offset).frames(m_document->fps())), info.track), ErrorMessage);
+            continue;
+        }
+        QGraphicsItem *item = clip->parentItem() ? clip->parentItem() : clip;
+        if (!collected.contains(item)) {
+            collected.insert(item);
+            toMove << item;
+        }
+        int pos = info.startPos.frames(m_document->fps());
+        if (trackClipStartList.value(info.track) == -1 || pos < trackClipStartList.value(info.track)) {
+            trackClipStartList[info.track] = pos;
+        }
+    }
+    for (int i = 0; i < transToMove.count(); ++i) {
+        const ItemInfo &info = transToMove.at(i);
+        Transition *transition = transitions.value(qMakePair(info.track, (int) (info.startPos + offset).frames(m_document->fps())));
+        if (!transition) {
+            emit displayMessage(i18n("Cannot move transition at position %1, track %2", m_document->timecode().getTimecodeFromFrames(info.startPos.frames(m_document->fps())), info.track), ErrorMessage);
+            continue;
+        }
+        QGraphicsItem *item = transition;
+        if (transition->parentItem()) {
+            // If group has a locked item, ungroup first
+            AbstractGroupItem *grp = static_cast <AbstractGroupItem *>(transition->parentItem());
+            if (grp->isItemLocked()) {
+                const QList<QGraphicsItem *> children = grp->childItems();
+                m_document->clipManager()->removeGroup(grp);
+                scene()->destroyItemGroup(grp);
+                transition->setItemLocked(false);
+                if (collected.remove(grp)) {
+                    // The group was already moving with a clip, its children now move on their own
+                    toMove.removeAll(grp);
+                    for (QGraphicsItem *child : children) {
+                        if (child != transition) {
+                            collected.insert(child);
+                            toMove << child;
                         }
-                        scene()->destroyItemGroup(grp);
-                        transition->setItemLocked(false);
-                        m_selectionGroup->addItem(transition);
-                    } else {
-                        m_selectionGroup->addItem(transition->parentItem());
                     }
-                } else {
-                    m_selectionGroup->addItem(transition);
-                }
-                if (trackTransitionStartList.value(transToMove.at(i).track) == -1 || transToMove.at(i).startPos.frames(m_document->fps()) < trackTransitionStartList.value(transToMove.at(i).track)) {
-                    trackTransitionStartList[transToMove.at(i).track] = transToMove.at(i).startPos.frames(m_document->fps());
                 }
             } else {
-                emit displayMessage(i18n("Cannot move transition at position %1, track %2", m_document->timecode().getTimecodeFromFrames(transToMove.at(i).startPos.frames(m_document->fps())), transToMove.at(i).track), ErrorMessage);
+                item = grp;
             }
         }
+        if (!collected.contains(item)) {
+            collected.insert(item);
+            toMove << item;
+        }
+        int pos = info.startPos.frames(m_document->fps());
+        if (trackTransitionStartList.value(info.track) == -1 || pos < trackTransitionStartList.value(info.track)) {
+            trackTransitionStartList[info.track] = pos;
+        }
+    }
 
-    m_selectionGroup->setTransform(QTransform::fromTranslate(diff, 0), true);
-
-    // update items coordinates
-    QList<QGraphicsItem *> itemList = m_selectionGroup->childItems();
-    QList<AbstractGroupItem *> groupList;
-
-    for (int i = 0; i < itemList.count(); ++i) {
-        if (itemList.at(i)->type() == AVWidget || itemList.at(i)->type() == TransitionWidget) {
-            int realTrack = getTrackFromPos(itemList.at(i)->scenePos().y());
-            static_cast < AbstractClipItem *>(itemList.at(i))->updateItem(realTrack);
-        } else if (itemList.at(i)->type() == GroupWidget) {
-            AbstractGroupItem *group = static_cast < AbstractGroupItem *>(itemList.at(i));
-            groupList << group;
-            m_document->clipManager()->removeGroup(group);
-            QList<QGraphicsItem *> children = itemList.at(i)->childItems();
-            for (int j = 0; j < children.count(); ++j) {
-                AbstractClipItem *clp = static_cast < AbstractClipItem *>(children.at(j));
-                int realTrack = getTrackFromPos(clp->scenePos().y());
-                clp->updateItem(realTrack);
+    // Translate the items directly: the position change handlers would check collisions with items that did not move yet
+    for (QGraphicsItem *item : toMove) {
+        const bool sendChanges = item->flags() & QGraphicsItem::ItemSendsGeometryChanges;
+        item->setFlag(QGraphicsItem::ItemSendsGeometryChanges, false);
+        item->moveBy(diff, 0);
+        item->setFlag(QGraphicsItem::ItemSendsGeometryChanges, sendChanges);
+        if (item->type() == GroupWidget) {
+            const QList<QGraphicsItem *> children = item->childItems();
+            for (QGraphicsItem *child : children) {
+                if (child->type() == AVWidget || child->type() == TransitionWidget) {
+                    AbstractClipItem *clp = static_cast <AbstractClipItem *>(child);
+                    clp->updateItem(clp->track());
+                }
             }
+        } else {
+            AbstractClipItem *clp = static_cast <AbstractClipItem *>(item);
+            clp->updateItem(clp->track());
         }
     }
-    m_selectionMutex.unlock();
-    resetSelectionGroup(false);
-    // Rebuild groups after translate
-    foreach (AbstractGroupItem *grp, groupList) {
-        rebuildGroup(grp);
-    }
     m_document->renderer()->mltInsertSpace(trackClipStartList, trackTransitionStartList, track, duration, offset);
+    // Transitions were moved directly in the field
+    m_timeline->transitionHandler->invalidateIndex();
 }
 
 void CustomTrackView::deleteClip(const QString &clipId, QUndoCommand *deleteCommand)
@@ -4380,6 +4428,7 @@ void CustomTrackView::completeSpaceOperation(int track, GenTime &timeOffset, boo
             m_commandStack->push(command);
             if (!fromStart) {
                 m_document->renderer()->mltInsertSpace(trackClipStartList, trackTransitionStartList, track, timeOffset, GenTime());
+                m_timeline->transitionHandler->invalidateIndex();
             }
         }
     }
@@ -6323,33 +6372,73 @@ void CustomTrackView::slotRefreshGuides()
 
 void CustomTrackView::drawBackground(QPainter *painter, const QRectF &rect)
 {
-    //TODO: optimize, we currently redraw bg on every cursor move
-    painter->setClipRect(rect);
-    QPen pen1 = painter->pen();
-    QColor lineColor = palette().text().color();
-    lineColor.setAlpha(50);
-    pen1.setColor(lineColor);
-    painter->setPen(pen1);
-    double min = rect.left();
-    double max = rect.right();
-    //painter->drawLine(QPointF(min, 0), QPointF(max, 0));
-    int maxTrack = m_timeline->visibleTracksCount();
-    QColor audioColor = palette().alternateBase().color();
-    QColor activeLockColor = m_lockedTrackColor;
-    activeLockColor.setAlpha(90);
+    // Track rows do not change along the timeline, they are rendered once in a tile that is repeated horizontally
+    const int maxTrack = m_timeline->visibleTracksCount();
+    const QTransform transform = painter->transform();
+    const qreal verticalScale = transform.m22();
+    QByteArray key;
+    key.reserve(maxTrack + 16);
     for (int i = 1; i <= maxTrack; ++i) {
-        TrackInfo info = m_timeline->getTrackInfo(i);
-        if (info.isLocked || info.type == AudioTrack || i == m_selectedTrack) {
-            const QRectF track(min, m_tracksHeight * (maxTrack - i), max - min, m_tracksHeight - 1);
-            if (i == m_selectedTrack) {
-                painter->fillRect(track, info.isLocked ? activeLockColor : m_selectedTrackColor);
-            } else {
-                painter->fillRect(track, info.isLocked ? m_lockedTrackColor : audioColor);
+        Track *tk = m_timeline->track(i);
+        char state = 0;
+        if (tk && tk->type == AudioTrack) {
+            state |= 1;
+        }
+        if (m_timeline->isTrackLocked(i)) {
+            state |= 2;
+        }
+        if (i == m_selectedTrack) {
+            state |= 4;
+        }
+        key.append(state);
+    }
+    key.append(QByteArray::number(m_tracksHeight)).append('/').append(QByteArray::number(verticalScale));
+    const int tileHeight = qCeil(m_tracksHeight * maxTrack * verticalScale);
+    if (tileHeight <= 0) {
+        return;
+    }
+    if (key != m_backgroundKey) {
+        m_backgroundKey = key;
+        const int dpr = viewport()->devicePixelRatio();
+        m_backgroundTile = QPixmap(256 * dpr, tileHeight * dpr);
+        m_backgroundTile.setDevicePixelRatio(dpr);
+        m_backgroundTile.fill(Qt::transparent);
+        QPainter p(&m_backgroundTile);
+        p.scale(1, verticalScale);
+        QColor lineColor = palette().text().color();
+        lineColor.setAlpha(50);
+        p.setPen(lineColor);
+        const double min = 0;
+        const double max = 256;
+        QColor audioColor = palette().alternateBase().color();
+        QColor activeLockColor = m_lockedTrackColor;
+        activeLockColor.setAlpha(90);
+        for (int i = 1; i <= maxTrack; ++i) {
+            const char state = key.at(i - 1);
+            if (state != 0) {
+                const QRectF track(min, m_tracksHeight * (maxTrack - i), max - min, m_tracksHeight - 1);
+                if (state & 4) {
+                    p.fillRect(track, (state & 2) ? activeLockColor : m_selectedTrackColor);
+                } else {
+                    p.fillRect(track, (state & 2) ? m_lockedTrackColor : audioColor);
+                }
             }
+            p.drawLine(QPointF(min, m_tracksHeight * (maxTrack - i) - 1), QPointF(max, m_tracksHeight * (maxTrack - i) - 1));
         }
-        painter->drawLine(QPointF(min, m_tracksHeight * (maxTrack - i) - 1), QPointF(max, m_tracksHeight * (maxTrack - i) - 1));
+        p.drawLine(QPointF(min, m_tracksHeight * (maxTrack) - 1), QPointF(max, m_tracksHeight * (maxTrack) - 1));
     }
-    painter->drawLine(QPointF(min, m_tracksHeight * (maxTrack) - 1), QPointF(max, m_tracksHeight * (maxTrack) - 1));
+    // Draw in viewport coordinates so that the tile is not scaled with the timeline zoom
+    const int top = qRound(transform.map(QPointF(0, 0)).y());
+    QRect target = transform.mapRect(rect).toAlignedRect();
+    target = target.intersected(QRect(target.left(), top, target.width(), tileHeight));
+    if (target.isEmpty()) {
+        return;
+    }
+    painter->save();
+    painter->setClipRect(rect);
+    painter->resetTransform();
+    painter->drawTiledPixmap(target, m_backgroundTile, QPoint(0, target.top() - top));
+    painter->restore();
 }
 
 bool CustomTrackView::findString(const QString &text)
@@ -8214,6 +8303,7 @@ void CustomTrackView::updatePalette()
     m_selectedTrackColor.setAlpha(150);
     m_lockedTrackColor = scheme.background(KColorScheme::NegativeBackground).color();
     m_lockedTrackColor.setAlpha(150);
+    m_backgroundKey.clear();
 }
 
 void CustomTrackView::removeTipAnimation()
@@ -462,6 +462,10 @@ private:
     QList<Guide *> m_guides;
     QColor m_selectedTrackColor;
     QColor m_lockedTrackColor;
+    /** @brief Track rows drawn in the background, repeated along the timeline */
+    QPixmap m_backgroundTile;
+    /** @brief State of the tracks (type, lock, selection and height) used to render m_backgroundTile */
+    QByteArray m_backgroundKey;
     QMap<AbstractToolManager::ToolManagerType, AbstractToolManager *> m_toolManagers;
     AbstractToolManager *m_currentToolManager;
 
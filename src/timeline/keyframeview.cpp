@@ -94,7 +94,7 @@ void KeyframeView::drawKeyFrames(const QRectF &br, int length, bool active, QPai
             if (active) {
                 painter->setPen(color);
             }
-            QPointF k = keyframePoint(br, i);
+            QPointF k(br.x() + br.width() * (frame < 0 ? frame + duration + m_offset : frame + m_offset) / duration, 0);
             painter->drawLine(transformation.map(QLineF(k.x(), br.top(), k.x(), br.height())));
             if (active) {
                 k.setY(br.top() + br.height() / 2);
@@ -129,16 +129,20 @@ void KeyframeView::drawKeyFrames(const QRectF &br, int length, bool active, QPai
         }
     }
 
-    int cnt = m_keyProperties.count();
-    QStringList paramNames;
-    paramNames.reserve(cnt);
-    for (int i = 0; i < cnt; i++) {
-        paramNames << m_keyProperties.get_name(i);
+    if (m_drawnParams.isEmpty()) {
+        int cnt = m_keyProperties.count();
+        m_drawnParams.reserve(cnt);
+        for (int i = 0; i < cnt; i++) {
+            m_drawnParams << m_keyProperties.get_name(i);
+        }
+        m_drawnParams.removeAll(m_inTimeline);
+        // Make sure edited param is painted last
+        m_drawnParams.append(m_inTimeline);
     }
-    paramNames.removeAll(m_inTimeline);
-    // Make sure edited param is painted last
-    paramNames.append(m_inTimeline);
-    foreach (const QString &paramName, paramNames) {
+    // Map curve coordinates to the clip rect
+    const QTransform curveTransform = QTransform(br.width() / duration, 0, 0, -br.height(), br.x(), br.bottom()) * transformation;
+    for (int ix = 0; ix < m_drawnParams.count(); ++ix) {
+        const QString &paramName = m_drawnParams.at(ix);
         if (m_notInTimeline.contains(paramName)) {
             continue;
         }
@@ -147,81 +151,26 @@ void KeyframeView::drawKeyFrames(const QRectF &br, int length, bool active, QPai
             // this is probably an animated rect
             continue;
         }
-        Mlt::Animation drawAnim = m_keyProperties.get_animation(paramName.toUtf8().constData());
-        if (!drawAnim.is_valid()) {
+        const CurveGeometry *curve = curveGeometry(paramName, info);
+        if (!curve) {
             continue;
         }
-        QPainterPath path;
-        // Find first key before our clip start, get frame for rect left first
-        int firstKF = qMax(0, drawAnim.previous_key(-m_offset));
-        int lastKF = drawAnim.next_key(duration - m_offset);
-        if (lastKF < duration - m_offset) {
-            lastKF = duration - m_offset;
-        }
-        int frame = firstKF;
-        double value = m_keyProperties.anim_get_double(paramName.toUtf8().constData(), frame, duration - m_offset);
-        QPointF start = keyframePoint(br, frame + m_offset, value, info.factor, info.min, info.max);
-        path.moveTo(br.x(), br.bottom());
-        path.lineTo(br.x(), start.y());
-        path.lineTo(start);
-        painter->setPen(paramName == m_inTimeline ? QColor(Qt::white) : Qt::NoPen);
-        for (int i = 0; i < drawAnim.key_count(); ++i) {
-            int currentFrame = drawAnim.key_get_frame(i);
-            if (currentFrame < firstKF) {
-                continue;
-            }
-            if (currentFrame > lastKF) {
-                break;
-            }
-            if (active && paramName == m_inTimeline) {
-                painter->setBrush((drawAnim.key_get_frame(i) == activeKeyframe) ? QColor(Qt::red) : QColor(Qt::blue));
-                painter->drawEllipse(QRectF(transformation.map(start) - h / 2, transformation.map(start) + h / 2));
-            }
-            if (i + 1 < drawAnim.key_count()) {
-                frame = drawAnim.key_get_frame(i + 1);
-                value = m_keyProperties.anim_get_double(paramName.toUtf8().constData(), frame, duration - m_offset);
-                QPointF end = keyframePoint(br, frame + m_offset, value, info.factor, info.min, info.max);
-                //QPointF end = keyframePoint(br, i + 1);
-                switch (drawAnim.key_get_type(i)) {
-                case mlt_keyframe_discrete:
-                    path.lineTo(end.x(), start.y());
-                    path.lineTo(end);
-                    break;
-                case mlt_keyframe_linear:
-                    path.lineTo(end);
-                    break;
-                case mlt_keyframe_smooth:
-                    frame = drawAnim.key_get_frame(qMax(i - 1, 0));
-                    value = m_keyProperties.anim_get_double(paramName.toUtf8().constData(), frame, duration - m_offset);
-                    QPointF pre = keyframePoint(br, frame + m_offset, value, info.factor, info.min, info.max);
-                    frame = drawAnim.key_get_frame(qMin(i + 2, drawAnim.key_count() - 1));
-                    value = m_keyProperties.anim_get_double(paramName.toUtf8().constData(), frame, duration - m_offset);
-                    QPointF post = keyframePoint(br, frame + m_offset, value, info.factor, info.min, info.max);
-                    QPointF c1 = (end - pre) / 6.0; // + start
-                    QPointF c2 = (start - post) / 6.0; // + end
-                    double mid = (end.x() - start.x()) / 2;
-                    if (c1.x() >  mid) {
-                        c1 = c1 * mid / c1.x();    // scale down tangent vector to not go beyond middle
-                    }
-                    if (c2.x() < -mid) {
-                        c2 = c2 * -mid / c2.x();
-                    }
-                    path.cubicTo(start + c1, end + c2, end);
-                    break;
-                }
-                start = end;
-            } else {
-                path.lineTo(br.right(), start.y());
+        bool editedParam = paramName == m_inTimeline;
+        painter->setPen(editedParam ? QColor(Qt::white) : Qt::NoPen);
+        if (active && editedParam) {
+            for (int i = 0; i < curve->keys.count(); ++i) {
+                QPointF k = curveTransform.map(curve->keys.at(i));
+                painter->setBrush(curve->keyFrames.at(i) == activeKeyframe ? QColor(Qt::red) : QColor(Qt::blue));
+                painter->drawEllipse(QRectF(k - h / 2, k + h / 2));
             }
         }
-        path.lineTo(br.right(), br.bottom());
-        if (paramName == m_inTimeline) {
+        if (editedParam) {
             QColor col(Qt::white);
             col.setAlpha(active ? 120 : 80);
             painter->setBrush(col);
         } else {
             QColor col;
-            switch (paramNames.indexOf(paramName)) {
+            switch (ix) {
             case 0:
                 col = Qt::blue;
                 break;
@@ -244,11 +193,95 @@ void KeyframeView::drawKeyFrames(const QRectF &br, int length, bool active, QPai
             col.setAlpha(80);
             painter->setBrush(col);
         }
-        painter->drawPath(transformation.map(path));
+        painter->drawPath(curveTransform.map(curve->path));
     }
     painter->restore();
 }
 
+void KeyframeView::invalidateCurves()
+{
+    m_curves.clear();
+    m_drawnParams.clear();
+}
+
+const KeyframeView::CurveGeometry *KeyframeView::curveGeometry(const QString &paramName, const ParameterInfo &info)
+{
+    QMap<QString, CurveGeometry>::const_iterator cached = m_curves.constFind(paramName);
+    if (cached != m_curves.constEnd() && cached->duration == duration && cached->offset == m_offset) {
+        return &cached.value();
+    }
+    const QByteArray name = paramName.toUtf8();
+    Mlt::Animation drawAnim = m_keyProperties.get_animation(name.constData());
+    if (!drawAnim.is_valid()) {
+        return nullptr;
+    }
+    CurveGeometry curve;
+    curve.duration = duration;
+    curve.offset = m_offset;
+    // Compute each keyframe point once
+    const int count = drawAnim.key_count();
+    QVector<QPointF> points(count);
+    for (int i = 0; i < count; ++i) {
+        int frame = drawAnim.key_get_frame(i);
+        double value = m_keyProperties.anim_get_double(name.constData(), frame, duration - m_offset);
+        points[i] = QPointF(frame + m_offset, (value * info.factor - info.min) / (info.max - info.min));
+    }
+    QPainterPath &path = curve.path;
+    // Find first key before our clip start, get frame for rect left first
+    int firstKF = qMax(0, drawAnim.previous_key(-m_offset));
+    int lastKF = drawAnim.next_key(duration - m_offset);
+    if (lastKF < duration - m_offset) {
+        lastKF = duration - m_offset;
+    }
+    double value = m_keyProperties.anim_get_double(name.constData(), firstKF, duration - m_offset);
+    QPointF start(firstKF + m_offset, (value * info.factor - info.min) / (info.max - info.min));
+    path.moveTo(0, 0);
+    path.lineTo(0, start.y());
+    path.lineTo(start);
+    for (int i = 0; i < count; ++i) {
+        int currentFrame = drawAnim.key_get_frame(i);
+        if (currentFrame < firstKF) {
+            continue;
+        }
+        if (currentFrame > lastKF) {
+            break;
+        }
+        curve.keys << start;
+        curve.keyFrames << currentFrame;
+        if (i + 1 < count) {
+            const QPointF &end = points.at(i + 1);
+            switch (drawAnim.key_get_type(i)) {
+            case mlt_keyframe_discrete:
+                path.lineTo(end.x(), start.y());
+                path.lineTo(end);
+                break;
+            case mlt_keyframe_linear:
+                path.lineTo(end);
+                break;
+            case mlt_keyframe_smooth:
+                const QPointF &pre = points.at(qMax(i - 1, 0));
+                const QPointF &post = points.at(qMin(i + 2, count - 1));
+                QPointF c1 = (end - pre) / 6.0; // + start
+                QPointF c2 = (start - post) / 6.0; // + end
+                double mid = (end.x() - start.x()) / 2;
+                if (c1.x() >  mid) {
+                    c1 = c1 * mid / c1.x();    // scale down tangent vector to not go beyond middle
+                }
+                if (c2.x() < -mid) {
+                    c2 = c2 * -mid / c2.x();
+                }
+                path.cubicTo(start + c1, end + c2, end);
+                break;
+            }
+            start = end;
+        } else {
+            path.lineTo(duration, start.y());
+        }
+    }
+    path.lineTo(duration, 0);
+    return &m_curves.insert(paramName, curve).value();
+}
+
 void KeyframeView::drawKeyFrameChannels(const QRectF &br, int in, int out, QPainter *painter, const QList<QPoint> &maximas, int limitKeyframes, const QColor &textColor)
 {
     double frameFactor = (double)(out - in) / br.width();
@@ -373,6 +406,7 @@ void KeyframeView::drawKeyFrameChannels(const QRectF &br, int in, int out, QPain
 
 QString KeyframeView::getSingleAnimation(int ix, int in, int out, int offset, int limitKeyframes, QPoint maximas, double min, double max)
 {
+    invalidateCurves();
     m_keyProperties.set("kdenlive_import", "");
     int newduration = out - in + offset;
     m_keyProperties.anim_get_double("kdenlive_import", 0, newduration);
@@ -456,6 +490,7 @@ QString KeyframeView::getSingleAnimation(int ix, int in, int out, int offset, in
 
 QString KeyframeView::getOffsetAnimation(int in, int out, int offset, int limitKeyframes, ProfileInfo profile, bool allowAnimation, bool positionOnly, QPoint rectOffset)
 {
+    invalidateCurves();
     m_keyProperties.set("kdenlive_import", "");
     int newduration = out - in + offset;
     int pWidth = profile.profileSize.width();
@@ -558,6 +593,7 @@ double KeyframeView::editedKeyFrameValue()
 
 void KeyframeView::updateKeyFramePos(const QRectF &br, int frame, const double y)
 {
+    invalidateCurves();
     if (!m_keyAnim.is_key(activeKeyframe)) {
         return;
     }
@@ -637,6 +673,7 @@ mlt_keyframe_type KeyframeView::type(int frame)
 
 void KeyframeView::addKeyframe(int frame, double value, mlt_keyframe_type type)
 {
+    invalidateCurves();
     m_keyProperties.anim_set(m_inTimeline.toUtf8().constData(), value, frame - m_offset, duration - m_offset, type);
     // Last keyframe should stick to end
     if (frame == duration - 1) {
@@ -665,6 +702,7 @@ void KeyframeView::addKeyframe(int frame, double value, mlt_keyframe_type type)
 
 void KeyframeView::addDefaultKeyframe(ProfileInfo profile, int frame, mlt_keyframe_type type)
 {
+    invalidateCurves();
     double value = m_keyframeDefault;
     if (m_keyAnim.key_count() == 1 && frame != m_keyAnim.key_get_frame(0)) {
         value = m_keyProperties.anim_get_double(m_inTimeline.toUtf8().constData(), m_keyAnim.key_get_frame(0), duration - m_offset);
@@ -707,6 +745,7 @@ void KeyframeView::addDefaultKeyframe(ProfileInfo profile, int frame, mlt_keyfra
 
 void KeyframeView::removeKeyframe(int frame)
 {
+    invalidateCurves();
     m_keyAnim.remove(frame);
     if (frame == duration - 1 && frame == attachToEnd) {
         attachToEnd = -2;
@@ -759,6 +798,7 @@ void KeyframeView::attachKeyframeToEnd(bool attach)
 
 void KeyframeView::editKeyframeType(int type)
 {
+    invalidateCurves();
     if (m_keyAnim.is_key(activeKeyframe)) {
         // This is a keyframe
         double val = m_keyProperties.anim_get_double(m_inTimeline.toUtf8().constData(), activeKeyframe, duration - m_offset);
@@ -816,6 +856,7 @@ const QString KeyframeView::serialize(const QString &name, bool rectAnimation)
 
 QList<QPoint> KeyframeView::loadKeyframes(const QString &data)
 {
+    invalidateCurves();
     QList<QPoint> result;
     m_keyframeType = NoKeyframe;
     m_inTimeline = QStringLiteral("imported");
@@ -875,6 +916,7 @@ QList<QPoint> KeyframeView::loadKeyframes(const QString &data)
 
 bool KeyframeView::loadKeyframes(const QLocale &locale, const QDomElement &effect, int cropStart, int length)
 {
+    invalidateCurves();
     m_keyframeType = NoKeyframe;
     duration = length;
     m_inTimeline.clear();
@@ -963,6 +1005,7 @@ bool KeyframeView::loadKeyframes(const QLocale &locale, const QDomElement &effec
 
 void KeyframeView::setOffset(int frames)
 {
+    invalidateCurves();
     if (duration == 0 || !m_keyAnim.is_valid()) {
         return;
     }
@@ -1012,6 +1055,7 @@ void KeyframeView::reset()
         return;
     }
     m_keyframeType = NoKeyframe;
+    invalidateCurves();
     duration = 0;
     attachToEnd = -2;
     activeKeyframe = -1;
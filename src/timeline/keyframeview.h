@@ -29,6 +29,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "mlt++/MltProperties.h"
 #include "mlt++/MltAnimation.h"
 
+#include <QPainterPath>
+#include <QVector>
+
 class QAction;
 
 /**
@@ -133,6 +136,22 @@ private:
         QString defaultValue;
     };
     QMap<QString, ParameterInfo> m_paramInfos;
+    /** @brief Geometry of a parameter curve, x in frames from clip start and y in [0, 1] from min to max value */
+    struct CurveGeometry {
+        int duration;
+        int offset;
+        QPainterPath path;
+        QVector<QPointF> keys;
+        QVector<int> keyFrames;
+    };
+    /** @brief Curves of the drawn parameters, reused across repaints and zoom levels until keyframes change */
+    QMap<QString, CurveGeometry> m_curves;
+    /** @brief Names of the drawn parameters, the edited one last */
+    QStringList m_drawnParams;
+    /** @brief Discard cached curves, must be called whenever keyframes are modified */
+    void invalidateCurves();
+    /** @brief Returns the cached curve of @param paramName, building it if needed. Returns nullptr if the parameter is not animated. */
+    const CurveGeometry *curveGeometry(const QString &paramName, const ParameterInfo &info);
 
 signals:
     void updateKeyframes(const QRectF &r = QRectF());
@@ -21,11 +21,16 @@
 #include "../customruler.h"
 #include "kdenlivesettings.h"
 #include "doc/kdenlivedoc.h"
+#include "core.h"
+#include "project/cachemanager.h"
+#include "titler/titlecache.h"
 
 #include <KLocalizedString>
 #include <QtConcurrent>
 #include <QStandardPaths>
 #include <QProcess>
+#include <QDomDocument>
+#include <QFile>
 
 PreviewManager::PreviewManager(KdenliveDoc *doc, CustomRuler *ruler, Mlt::Tractor *tractor) : QObject()
     , m_doc(doc)
@@ -120,6 +125,7 @@ void PreviewManager::loadChunks(const QStringList &previewChunks, QStringList di
             if (!documentDate.isNull() && QFileInfo(file).lastModified() > documentDate) {
                 // Timeline preview file was created after document, invalidate
                 file.remove();
+                pCore->cacheManager()->removeFile(fileName);
                 dirtyChunks << frame;
             } else {
                 gotPreviewRender(frame.toInt(), fileName, 1000);
@@ -273,6 +279,8 @@ void PreviewManager::invalidatePreviews(const QList<int> &chunks)
         qSort(foundChunks);
         reloadChunks(foundChunks);
     }
+    // Chunks were moved to or restored from the undo folders
+    pCore->cacheManager()->refreshLater(m_cacheDir.absolutePath());
     m_doc->setModified(true);
     if (timer) {
         m_previewTimer.start();
@@ -314,7 +322,9 @@ void PreviewManager::clearPreviewRange()
     m_tractor->lock();
     bool hasPreview = m_previewTrack != nullptr;
     foreach (int ix, toProcess) {
-        m_cacheDir.remove(QStringLiteral("%1.%2").arg(ix).arg(m_extension));
+        const QString fileName = m_cacheDir.absoluteFilePath(QStringLiteral("%1.%2").arg(ix).arg(m_extension));
+        QFile::remove(fileName);
+        pCore->cacheManager()->removeFile(fileName);
         if (!hasPreview) {
             continue;
         }
@@ -360,7 +370,9 @@ void PreviewManager::addPreviewRange(bool add)
         m_tractor->lock();
         bool hasPreview = m_previewTrack != nullptr;
         foreach (int ix, toProcess) {
-            m_cacheDir.remove(QStringLiteral("%1.%2").arg(ix).arg(m_extension));
+            const QString fileName = m_cacheDir.absoluteFilePath(QStringLiteral("%1.%2").arg(ix).arg(m_extension));
+            QFile::remove(fileName);
+            pCore->cacheManager()->removeFile(fileName);
             if (!hasPreview) {
                 continue;
             }
@@ -404,11 +416,31 @@ void PreviewManager::startPreviewRender()
         m_waitingThumbs.clear();
         const QString sceneList = m_cacheDir.absoluteFilePath(QStringLiteral("preview.mlt"));
         m_doc->saveMltPlaylist(sceneList);
+        replaceStaticTitles(sceneList);
         m_waitingThumbs = chunks;
         m_previewThread = QtConcurrent::run(this, &PreviewManager::doPreviewRender, sceneList);
     }
 }
 
+void PreviewManager::replaceStaticTitles(const QString &sceneList)
+{
+    QFile file(sceneList);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    QDomDocument doc;
+    bool loaded = doc.setContent(&file, false);
+    file.close();
+    if (!loaded || TitleCache::replaceStaticTitles(doc) == 0) {
+        return;
+    }
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return;
+    }
+    file.write(doc.toString().toUtf8());
+    file.close();
+}
+
 void PreviewManager::doPreviewRender(const QString &scene)
 {
     int progress;
@@ -451,8 +483,10 @@ void PreviewManager::doPreviewRender(const QString &scene)
                     emit previewRender(i, previewProcess.readAllStandardError(), -1);
                 }
                 QFile::remove(m_cacheDir.absoluteFilePath(fileName));
+                pCore->cacheManager()->removeFile(m_cacheDir.absoluteFilePath(fileName));
                 break;
             } else {
+                pCore->cacheManager()->addFile(m_cacheDir.absoluteFilePath(fileName));
                 emit previewRender(i, m_cacheDir.absoluteFilePath(fileName), progress);
             }
         } else {
@@ -494,6 +528,7 @@ void PreviewManager::slotRemoveInvalidUndo(int ix)
             }
         }
     }
+    pCore->cacheManager()->refreshLater(m_cacheDir.absolutePath());
 }
 
 void PreviewManager::invalidatePreview(int startFrame, int endFrame)
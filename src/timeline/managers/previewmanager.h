@@ -102,6 +102,8 @@ private:
     QFuture <void> m_previewThread;
     /** @brief: After an undo/redo, if we have preview history, use it. */
     void reloadChunks(const QList<int> &chunks);
+    /** @brief: Use cached images for the static titles of the playlist file @param sceneList. */
+    void replaceStaticTitles(const QString &sceneList);
 
 private slots:
     /** @brief: To avoid filling the hard drive, remove preview undo history after 5 steps. */
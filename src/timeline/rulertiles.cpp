@@ -0,0 +1,144 @@
+/*
+Copyright (C) 2018  Jean-Baptiste Mardelle <jb@kdenlive.org>
+This file is part of Kdenlive. See www.kdenlive.org.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "rulertiles.h"
+
+#include <QPainter>
+#include <QFontMetrics>
+
+#include <cmath>
+
+// Width of a cached ruler tile
+static const int TILE_WIDTH = 256;
+// Maximum number of cached ruler tiles, the cache is cleared when it is exceeded
+static const int MAX_TILES = 64;
+
+RulerTiles::Layout::Layout() :
+    frameTimecode(false)
+    , factor(1)
+    , textSpacing(1)
+    , littleMarks(0)
+    , mediumMarks(0)
+    , bigMarks(0)
+    , labelBottom(0)
+    , littleMarkTop(0)
+    , mediumMarkTop(0)
+    , height(0)
+    , devicePixelRatio(1)
+{
+}
+
+RulerTiles::RulerTiles()
+{
+}
+
+void RulerTiles::setLayout(const Layout &layout)
+{
+    if (layout.timecode.fps() != m_layout.timecode.fps() || layout.timecode.format() != m_layout.timecode.format()
+            || layout.frameTimecode != m_layout.frameTimecode || layout.factor != m_layout.factor || layout.textSpacing != m_layout.textSpacing
+            || layout.littleMarks != m_layout.littleMarks || layout.mediumMarks != m_layout.mediumMarks || layout.bigMarks != m_layout.bigMarks
+            || layout.labelBottom != m_layout.labelBottom || layout.littleMarkTop != m_layout.littleMarkTop || layout.mediumMarkTop != m_layout.mediumMarkTop
+            || layout.height != m_layout.height || layout.font != m_layout.font || layout.textColor != m_layout.textColor
+            || layout.markColor != m_layout.markColor || layout.devicePixelRatio != m_layout.devicePixelRatio) {
+        m_tiles.clear();
+    }
+    m_layout = layout;
+}
+
+int RulerTiles::count() const
+{
+    return m_tiles.count();
+}
+
+void RulerTiles::draw(QPainter *painter, int left, int right, int offset)
+{
+    const int firstTile = qMax(0, left + offset) / TILE_WIDTH;
+    const int lastTile = qMax(0, right + offset) / TILE_WIDTH;
+    for (int i = firstTile; i <= lastTile; ++i) {
+        painter->drawPixmap(i * TILE_WIDTH - offset, 0, tile(i));
+    }
+}
+
+const QPixmap &RulerTiles::tile(int index)
+{
+    auto cached = m_tiles.constFind(index);
+    if (cached != m_tiles.constEnd()) {
+        return cached.value();
+    }
+    if (m_tiles.count() >= MAX_TILES) {
+        m_tiles.clear();
+    }
+    const int dpr = m_layout.devicePixelRatio;
+    QPixmap pix(TILE_WIDTH * dpr, (m_layout.height + 1) * dpr);
+    pix.setDevicePixelRatio(dpr);
+    pix.fill(Qt::transparent);
+    QPainter p(&pix);
+    // Tile coordinates, from the timeline start
+    const double tileStart = index * TILE_WIDTH;
+    p.translate(-tileStart, 0);
+    render(&p, tileStart, tileStart + TILE_WIDTH);
+    p.end();
+    return m_tiles.insert(index, pix).value();
+}
+
+void RulerTiles::render(QPainter *painter, double start, double end) const
+{
+    double f, fend;
+    painter->setFont(m_layout.font);
+
+    // draw time labels, including the ones starting before the range
+    painter->setPen(m_layout.textColor);
+    const int labelWidth = QFontMetrics(m_layout.font).boundingRect(QStringLiteral("00:00:00:000")).width();
+    for (f = qMax(0.0, std::floor((start - labelWidth) / m_layout.textSpacing) * m_layout.textSpacing); f < end; f += m_layout.textSpacing) {
+        QString lab;
+        if (m_layout.frameTimecode) {
+            lab = QString::number((int)(f / m_layout.factor + 0.5));
+        } else {
+            lab = m_layout.timecode.getTimecodeFromFrames((int)(f / m_layout.factor + 0.5));
+        }
+        painter->drawText(QPointF(f + 2, m_layout.labelBottom), lab);
+    }
+
+    painter->setPen(m_layout.markColor);
+    // draw the little marks
+    fend = m_layout.littleMarks;
+    if (fend > 5) {
+        for (f = std::ceil(start / fend) * fend; f < end; f += fend) {
+            painter->drawLine(QLineF(f, m_layout.littleMarkTop, f, m_layout.height));
+        }
+    }
+
+    // draw medium marks
+    fend = m_layout.mediumMarks;
+    if (fend > 5) {
+        for (f = std::ceil(start / fend) * fend; f < end; f += fend) {
+            painter->drawLine(QLineF(f, m_layout.mediumMarkTop, f, m_layout.height));
+        }
+    }
+
+    // draw big marks
+    fend = m_layout.bigMarks;
+    if (fend > 5) {
+        for (f = std::ceil(start / fend) * fend; f < end; f += fend) {
+            painter->drawLine(QLineF(f, m_layout.labelBottom, f, m_layout.height));
+        }
+    }
+}
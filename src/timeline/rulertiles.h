@@ -0,0 +1,85 @@
+/*
+Copyright (C) 2018  Jean-Baptiste Mardelle <jb@kdenlive.org>
+This file is part of Kdenlive. See www.kdenlive.org.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef RULERTILES_H
+#define RULERTILES_H
+
+#include "timecode.h"
+
+#include <QHash>
+#include <QPixmap>
+#include <QFont>
+#include <QColor>
+
+class QPainter;
+
+/**
+ * @class RulerTiles
+ * @brief Renders the time labels and marks of the timeline ruler into cached tiles.
+ *
+ * Labels and marks only depend on the zoom level, the timecode and the style, so they are rendered once
+ * into tiles indexed from the timeline start and blitted when the ruler is painted.
+ */
+class RulerTiles
+{
+public:
+    /** @brief Everything the labels and marks depend on. Distances and positions are in pixels. */
+    struct Layout {
+        Layout();
+        Timecode timecode;
+        /** @brief Display frame numbers instead of timecodes */
+        bool frameTimecode;
+        /** @brief Width of a frame */
+        double factor;
+        double textSpacing;
+        double littleMarks;
+        double mediumMarks;
+        double bigMarks;
+        /** @brief Baseline of the labels, also the top of the big marks */
+        int labelBottom;
+        int littleMarkTop;
+        int mediumMarkTop;
+        int height;
+        QFont font;
+        QColor textColor;
+        QColor markColor;
+        int devicePixelRatio;
+    };
+
+    RulerTiles();
+    /** @brief Use @param layout for the next paints, the cached tiles are dropped if it changed. */
+    void setLayout(const Layout &layout);
+    /** @brief Draw the labels and marks from @param left to @param right (painter coordinates), the timeline being scrolled by @param offset pixels. */
+    void draw(QPainter *painter, int left, int right, int offset);
+    /** @brief Draw the labels and marks from @param start to @param end in timeline coordinates without using the cache. */
+    void render(QPainter *painter, double start, double end) const;
+    /** @brief Returns the number of cached tiles. */
+    int count() const;
+
+private:
+    Layout m_layout;
+    /** @brief Rendered labels and marks, by tile index from the timeline start */
+    QHash<int, QPixmap> m_tiles;
+    /** @brief Returns the tile at @param index, rendering it if necessary */
+    const QPixmap &tile(int index);
+};
+
+#endif
@@ -26,11 +26,14 @@
 #include "clipitem.h"
 #include "transition.h"
 #include "transitionhandler.h"
+#include "trackcompositing.h"
 #include "timelinecommands.h"
 #include "customruler.h"
 #include "customtrackview.h"
 #include "dialogs/profilesdialog.h"
 #include "mltcontroller/clipcontroller.h"
+#include "mltcontroller/producerqueue.h"
+#include "core.h"
 #include "bin/projectclip.h"
 #include "kdenlivesettings.h"
 #include "mainwindow.h"
@@ -81,6 +84,10 @@ Timeline::Timeline(KdenliveDoc *doc, const QList<QAction *> &actions, const QLis
 {
     m_trackActions << actions;
     setupUi(this);
+    // Coalesce the changes of an edit operation
+    m_compositingTimer.setSingleShot(true);
+    m_compositingTimer.setInterval(0);
+    connect(&m_compositingTimer, &QTimer::timeout, this, &Timeline::slotUpdateCompositing);
     splitter->setStretchFactor(1, 2);
     connect(splitter, &QSplitter::splitterMoved, this, &Timeline::storeHeaderSize);
     m_scene = new CustomTrackScene(this);
@@ -360,6 +367,7 @@ int Timeline::getTracks()
                 slotUpdateTrackEffectState(i);
             }
             connect(tk, &Track::newTrackDuration, this, &Timeline::checkDuration, Qt::DirectConnection);
+            connect(tk, &Track::contentChanged, this, &Timeline::slotTrackContentChanged, Qt::QueuedConnection);
             connect(tk, SIGNAL(storeSlowMotion(QString, Mlt::Producer *)), m_doc->renderer(), SLOT(storeSlowmotionProducer(QString, Mlt::Producer *)));
         }
     }
@@ -372,6 +380,7 @@ int Timeline::getTracks()
     }
     updatePalette();
     refreshTrackActions();
+    updateAllCompositing();
     return duration;
 }
 
@@ -380,6 +389,40 @@ void Timeline::checkDuration()
     m_doc->renderer()->mltCheckLength(m_tractor);
 }
 
+void Timeline::slotTrackContentChanged(int ix)
+{
+    m_changedTracks.insert(ix);
+    m_compositingTimer.start();
+}
+
+void Timeline::updateAllCompositing()
+{
+    for (int i = 1; i < m_tracks.count(); ++i) {
+        m_changedTracks.insert(i);
+    }
+    m_compositingTimer.start();
+}
+
+void Timeline::slotUpdateCompositing()
+{
+    // Blanks shorter than a second are blended to limit the number of transitions
+    const int minGap = qRound(m_doc->fps());
+    bool changed = false;
+    foreach (int ix, m_changedTracks) {
+        Track *tk = track(ix);
+        if (tk == nullptr || tk->trackHeader == nullptr) {
+            continue;
+        }
+        if (transitionHandler->setTrackContentRanges(ix, tk->contentRanges(minGap, TrackCompositing::maxRanges))) {
+            changed = true;
+        }
+    }
+    m_changedTracks.clear();
+    if (changed) {
+        m_doc->renderer()->doRefresh();
+    }
+}
+
 void Timeline::getTransitions()
 {
     int compositeMode = 0;
@@ -482,6 +525,8 @@ void Timeline::getTransitions()
             service = mlt_service_producer(service);
         }
     }
+    // Invalid transitions were removed from the field
+    transitionHandler->invalidateIndex();
     m_doc->updateCompositionMode(compositeMode);
 }
 
@@ -1003,6 +1048,7 @@ int Timeline::loadTrack(int ix, int offset, Mlt::Playlist &playlist, int start,
         end = playlist.count();
     }
     bool locked = playlist.get_int("kdenlive:locked_track") == 1;
+    QStringList usedClips;
     for (int i = start; i <= end; ++i) {
         emit loadingBin(offset + i + 1);
         if (playlist.is_blank(i)) {
@@ -1065,6 +1111,7 @@ int Timeline::loadTrack(int ix, int offset, Mlt::Playlist &playlist, int start,
         }
         if (updateReferences) {
             binclip->addRef();
+            usedClips << id;
         }
         ItemInfo clipinfo;
         clipinfo.startPos = GenTime(info->start, fps);
@@ -1091,6 +1138,10 @@ int Timeline::loadTrack(int ix, int offset, Mlt::Playlist &playlist, int start,
         // parse clip effects
         getEffects(*clip, item);
     }
+    if (!usedClips.isEmpty()) {
+        // Clips used in timeline should get their thumbnails first
+        pCore->producerQueue()->prioritize(usedClips);
+    }
     return playlist.get_length();
 }
 
@@ -1624,10 +1675,10 @@ int Timeline::getTrackSpaceLength(int trackIndex, int pos, bool fromBlankStart)
     return track(trackIndex)->getBlankLength(pos, fromBlankStart);
 }
 
-void Timeline::updateClipProperties(const QString &id, const QMap<QString, QString> &properties)
+void Timeline::updateClipProperties(const QMap<QString, QMap<QString, QString> > &clipProperties)
 {
     for (int i = 1; i < m_tracks.count(); i++) {
-        track(i)->updateClipProperties(id, properties);
+        track(i)->updateClipProperties(clipProperties);
     }
 }
 
@@ -1728,6 +1779,10 @@ void Timeline::slotMultitrackView(bool enable)
 {
     multitrackView = enable;
     transitionHandler->enableMultiTrack(enable);
+    if (!enable) {
+        // Tracks restored by the split view might be empty
+        updateAllCompositing();
+    }
 }
 
 void Timeline::connectOverlayTrack(bool enable)
@@ -2130,6 +2185,7 @@ void Timeline::switchComposite(int mode)
         }
     }
     transitionHandler->rebuildTransitions(mode, videoTracks, maxTrack);
+    updateAllCompositing();
     m_doc->renderer()->doRefresh();
     m_doc->setModified();
 }
@@ -34,6 +34,8 @@
 #include <QGraphicsScene>
 #include <QGraphicsLineItem>
 #include <QDomElement>
+#include <QTimer>
+#include <QSet>
 
 #include <mlt++/Mlt.h>
 
@@ -134,7 +136,8 @@ public:
     /** @brief Check if we have a blank space on selected track.
      *  Returns -1 if track is shorter, 0 if not blank and > 0 for blank length */
     int getTrackSpaceLength(int trackIndex, int pos, bool fromBlankStart);
-    void updateClipProperties(const QString &id, const QMap<QString, QString> &properties);
+    /** @brief Pass producer properties to the track duplicates of several clips in one pass, properties are indexed by clip id. */
+    void updateClipProperties(const QMap<QString, QMap<QString, QString> > &clipProperties);
     int changeClipSpeed(const ItemInfo &info, const ItemInfo &speedIndependantInfo, PlaylistState::ClipState state, double speed, int strobe, Mlt::Producer *originalProd, bool removeEffect = false);
     /** @brief Set an effect's XML accordingly to MLT::filter values. */
     static void setParam(ProfileInfo info, QDomElement param, const QString &value);
@@ -231,8 +234,13 @@ private:
     PreviewManager *m_timelinePreview;
     bool m_usePreview;
     QAction *m_disablePreview;
+    /** @brief Tracks whose content changed since their compositing range was last updated */
+    QSet<int> m_changedTracks;
+    QTimer m_compositingTimer;
 
     void adjustTrackHeaders();
+    /** @brief Schedule an update of the compositing range of all tracks */
+    void updateAllCompositing();
 
     void parseDocument(const QDomDocument &doc);
     int loadTrack(int ix, int offset, Mlt::Playlist &playlist, int start = 0, int end = -1, bool updateReferences = true);
@@ -280,6 +288,10 @@ private slots:
     void resizeRuler(int height);
     /** @brief The timeline track headers were resized, store width. */
     void storeHeaderSize(int pos, int index);
+    /** @brief Clips were added, moved or removed on a track. */
+    void slotTrackContentChanged(int ix);
+    /** @brief Restrict automatic compositing and audio mix of the changed tracks to the range covered by clips. */
+    void slotUpdateCompositing();
 
 signals:
     void mousePosition(int);
@@ -26,25 +26,39 @@
 #include "kdenlivesettings.h"
 #include "clip.h"
 #include "effectmanager.h"
+#include "trackcompositing.h"
 
 #include "kdenlive_debug.h"
 #include <math.h>
 
+static void playlist_changed(mlt_properties, Track *self)
+{
+    emit self->contentChanged(self->index());
+}
+
 Track::Track(int index, const QList<QAction *> &actions, Mlt::Playlist &playlist, TrackType trackType, int height, QWidget *parent) :
     effectsList(EffectsList(true)),
     type(trackType),
     trackHeader(nullptr),
     m_index(index),
-    m_playlist(playlist)
+    m_playlist(playlist),
+    m_changeEvent(nullptr),
+    m_cutIndexValid(false)
 {
     QString playlist_name = playlist.get("id");
     if (playlist_name != QLatin1String("black_track")) {
         trackHeader = new HeaderTrack(info(), actions, this, height, parent);
+        m_changeEvent = m_playlist.listen("producer-changed", this, (mlt_listener) playlist_changed);
+        // Clips were added, moved or removed, the cut index must be rebuilt
+        connect(this, &Track::contentChanged, this, [this]() {
+            m_cutIndexValid = false;
+        }, Qt::DirectConnection);
     }
 }
 
 Track::~Track()
 {
+    delete m_changeEvent;
     if (trackHeader) trackHeader->deleteLater();
 }
 
@@ -302,14 +316,38 @@ void Track::lockTrack(bool locked)
     trackHeader->setLock(locked);
 }
 
+QVector<int> Track::clipCuts(const QString &id)
+{
+    if (!m_cutIndexValid) {
+        m_cutIndex.clear();
+        for (int i = 0; i < m_playlist.count(); i++) {
+            if (m_playlist.is_blank(i)) continue;
+            QScopedPointer<Mlt::Producer> p(m_playlist.get_clip(i));
+            QString current = p->parent().get("id");
+            if (current.startsWith(QLatin1Char('#'))) {
+                // Producer waiting for replacement
+                current.remove(0, 1);
+            }
+            if (current.startsWith(QLatin1String("slowmotion:"))) {
+                current = current.section(QLatin1Char(':'), 1, 1);
+            } else {
+                current = current.section(QLatin1Char('_'), 0, 0);
+            }
+            m_cutIndex[current] << i;
+        }
+        // Without change listener (black track), we cannot know when the index is outdated
+        m_cutIndexValid = m_changeEvent != nullptr;
+    }
+    return m_cutIndex.value(id);
+}
+
 void Track::replaceId(const QString &id)
 {
     QString idForAudioTrack = id + QLatin1Char('_') + m_playlist.get("id") + QStringLiteral("_audio");
     QString idForVideoTrack = id + QStringLiteral("_video");
     QString idForTrack = id + QLatin1Char('_') + m_playlist.get("id");
     //TODO: slowmotion
-    for (int i = 0; i < m_playlist.count(); i++) {
-        if (m_playlist.is_blank(i)) continue;
+    for (int i : clipCuts(id)) {
         QScopedPointer<Mlt::Producer> p(m_playlist.get_clip(i));
         QString current = p->parent().get("id");
 	if (current == id || current == idForTrack || current == idForAudioTrack || current == idForVideoTrack || current.startsWith("slowmotion:" + id + QLatin1Char(':'))) {
@@ -323,8 +361,7 @@ QList<Track::SlowmoInfo> Track::getSlowmotionInfos(const QString &id)
 {
     QList<Track::SlowmoInfo> list;
     QLocale locale;
-    for (int i = 0; i < m_playlist.count(); i++) {
-        if (m_playlist.is_blank(i)) continue;
+    for (int i : clipCuts(id)) {
         QScopedPointer<Mlt::Producer> p(m_playlist.get_clip(i));
         QString current = p->parent().get("id");
     if (!current.startsWith(QLatin1Char('#'))) {
@@ -356,8 +393,9 @@ QList<ItemInfo> Track::replaceAll(const QString &id, Mlt::Producer *original, Ml
     Mlt::Producer *trackProducer = nullptr;
     Mlt::Producer *audioTrackProducer = nullptr;
     QList<ItemInfo> replaced;
-    for (int i = 0; i < m_playlist.count(); i++) {
-        if (m_playlist.is_blank(i)) continue;
+    // Cuts are replaced at the same index, so the list stays valid while the playlist is modified
+    const QVector<int> cuts = clipCuts(id);
+    for (int i : cuts) {
         QScopedPointer<Mlt::Producer> p(m_playlist.get_clip(i));
         QString current = p->parent().get("id");
         if (current == id) {
@@ -489,8 +527,7 @@ const QList<ItemInfo> Track::updateEffects(const QString &id, Mlt::Producer *ori
         idForTrack.append(QLatin1Char('_') + m_playlist.get("id"));
     }
 
-    for (int i = 0; i < m_playlist.count(); i++) {
-        if (m_playlist.is_blank(i)) continue;
+    for (int i : clipCuts(id)) {
         QScopedPointer<Mlt::Producer> p(m_playlist.get_clip(i));
         Mlt::Producer origin = p->parent();
         QString current = origin.get("id");
@@ -650,27 +687,33 @@ int Track::getBlankLength(int pos, bool fromBlankStart)
     return m_playlist.clip_length(clipIndex) + m_playlist.clip_start(clipIndex) - pos;
 }
 
-void Track::updateClipProperties(const QString &id, const QMap<QString, QString> &properties)
+void Track::updateClipProperties(const QMap<QString, QMap<QString, QString> > &clipProperties)
 {
-    QString idForTrack = id + QLatin1Char('_') + m_playlist.get("id");
-    QString idForVideoTrack = id + QStringLiteral("_video");
-    QString idForAudioTrack = idForTrack + QStringLiteral("_audio");
     // slowmotion producers are updated in renderer
-
-    for (int i = 0; i < m_playlist.count(); i++) {
-        if (m_playlist.is_blank(i)) continue;
-        QScopedPointer<Mlt::Producer> p(m_playlist.get_clip(i));
-        QString current = p->parent().get("id");
+    const QString trackId = m_playlist.get("id");
+    m_playlist.lock();
+    QMapIterator<QString, QMap<QString, QString> > k(clipProperties);
+    while (k.hasNext()) {
+        k.next();
+        const QString &id = k.key();
+        QString idForTrack = id + QLatin1Char('_') + trackId;
+        QString idForVideoTrack = id + QStringLiteral("_video");
+        QString idForAudioTrack = idForTrack + QStringLiteral("_audio");
         QStringList processed;
-        if (!processed.contains(current) && (current == idForTrack || current == idForAudioTrack || current == idForVideoTrack)) {
-            QMapIterator<QString, QString> j(properties);
-            while (j.hasNext()) {
-                j.next();
-                p->parent().set(j.key().toUtf8().constData(), j.value().toUtf8().constData());
+        for (int i : clipCuts(id)) {
+            QScopedPointer<Mlt::Producer> p(m_playlist.get_clip(i));
+            QString current = p->parent().get("id");
+            if (!processed.contains(current) && (current == idForTrack || current == idForAudioTrack || current == idForVideoTrack)) {
+                QMapIterator<QString, QString> j(k.value());
+                while (j.hasNext()) {
+                    j.next();
+                    p->parent().set(j.key().toUtf8().constData(), j.value().toUtf8().constData());
+                }
+                processed << current;
             }
-            processed << current;
         }
     }
+    m_playlist.unlock();
 }
 
 Mlt::Producer *Track::buildSlowMoProducer(Mlt::Properties passProps, const QString &url, const QString &id, Track::SlowmoInfo info)
@@ -871,6 +914,19 @@ int Track::index() const
     return m_index;
 }
 
+QList<QPair<int, int> > Track::contentRanges(int minGap, int maxRanges)
+{
+    QList<QPair<int, int> > ranges;
+    for (int i = 0; i < m_playlist.count(); ++i) {
+        if (m_playlist.is_blank(i)) {
+            continue;
+        }
+        int start = m_playlist.clip_start(i);
+        ranges << QPair<int, int>(start, start + m_playlist.clip_length(i));
+    }
+    return TrackCompositing::mergeRanges(ranges, minGap, maxRanges);
+}
+
 
 int Track::spaceLength(int pos, bool fromBlankStart)
 {
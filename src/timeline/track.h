@@ -27,9 +27,12 @@
 #include "definitions.h"
 #include "mltcontroller/effectscontroller.h"
 #include <QObject>
+#include <QHash>
+#include <QVector>
 
 #include <mlt++/MltPlaylist.h>
 #include <mlt++/MltProducer.h>
+#include <mlt++/MltEvent.h>
 
 class HeaderTrack;
 
@@ -97,6 +100,10 @@ public:
 
     /** @brief Returns MLT's track index */
     int index() const;
+    /** @brief Returns the (first frame, frame after the end) ranges covered by clips, an empty list if the track only contains blanks
+     *  @param minGap blanks shorter than this are included in the ranges
+     *  @param maxRanges the closest ranges are joined to return at most this count */
+    QList<QPair<int, int> > contentRanges(int minGap, int maxRanges);
 
     /** @brief add a clip
      * @param t is the time position to start the cut (in seconds)
@@ -187,8 +194,8 @@ public:
     /** @brief Check if we have a blank space at pos and its length.
      *  Returns -1 if track is shorter, 0 if not blank and > 0 for blank length */
     int getBlankLength(int pos, bool fromBlankStart);
-    /** @brief Update producer properties on all instances of this clip. */
-    void updateClipProperties(const QString &id, const QMap<QString, QString> &properties);
+    /** @brief Update producer properties on all instances of these clips, properties are indexed by clip id. */
+    void updateClipProperties(const QMap<QString, QMap<QString, QString> > &clipProperties);
     /** @brief Returns a list of speed info for all slowmotion producer used on this track for an id. */
     QList<SlowmoInfo> getSlowmotionInfos(const QString &id);
     /** @brief Returns the length of blank space from a position pos. */
@@ -218,6 +225,8 @@ signals:
     /** @brief notify track length change to update background
      * @param duration is the new length */
     void newTrackDuration(int duration);
+    /** @brief The MLT playlist was modified (clips added, moved, resized or removed) */
+    void contentChanged(int index);
     void storeSlowMotion(const QString &url, Mlt::Producer *prod);
 
 private:
@@ -225,6 +234,14 @@ private:
     int m_index;
     /** MLT playlist behind the scene */
     Mlt::Playlist m_playlist;
+    /** @brief Listens to the playlist changes */
+    Mlt::Event *m_changeEvent;
+    /** @brief Playlist indexes of the cuts of each bin clip, including track duplicates and slowmotion producers */
+    QHash<QString, QVector<int> > m_cutIndex;
+    /** @brief False when the playlist changed since the cut index was built */
+    bool m_cutIndexValid;
+    /** @brief Returns the playlist indexes of the cuts of bin clip @param id, rebuilding the index if needed */
+    QVector<int> clipCuts(const QString &id);
     /** @brief Returns true is this MLT service needs duplication to work on multiple tracks */
     bool needsDuplicate(const QString &service) const;
     void checkEffect(const QString effectName, int pos, int duration);
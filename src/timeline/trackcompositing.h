@@ -0,0 +1,87 @@
+/*
+Copyright (C) 2018  Jean-Baptiste Mardelle <jb@kdenlive.org>
+This file is part of Kdenlive. See www.kdenlive.org.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TRACKCOMPOSITING_H
+#define TRACKCOMPOSITING_H
+
+#include <mlt++/Mlt.h>
+
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <functional>
+
+/**
+ * @namespace TrackCompositing
+ * @brief Choice of the internal track transitions, without dependency on the application so that
+ * the benchmarks of the testingArea folder build the same timeline as Kdenlive.
+ */
+namespace TrackCompositing
+{
+/** @brief Maximum number of frame ranges of a track with their own automatic transitions. */
+const int maxRanges = 32;
+
+/** @brief Returns true if the mix transition of the installed MLT supports the sum property. */
+inline bool sumAudioMixAvailable()
+{
+    // TODO: remove whenever we require MLT > 6.4.x
+    return (LIBMLT_VERSION_MAJOR > 6 || (LIBMLT_VERSION_MAJOR == 6 && LIBMLT_VERSION_MINOR > 4));
+}
+
+/** @brief Returns the preferred CPU track composite among the transitions for which @param isAvailable returns true. */
+inline QString preferredComposite(const std::function<bool(const QString &)> &isAvailable)
+{
+    if (isAvailable(QStringLiteral("qtblend"))) {
+        return QStringLiteral("qtblend");
+    }
+    if (isAvailable(QStringLiteral("frei0r.cairoblend"))) {
+        return QStringLiteral("frei0r.cairoblend");
+    }
+    return QStringLiteral("composite");
+}
+
+/** @brief Returns the sorted frame ranges @param ranges joined when they are less than @param minGap frames apart,
+ *  then by closest pairs until at most @param maxRanges remain. */
+inline QList<QPair<int, int> > mergeRanges(const QList<QPair<int, int> > &ranges, int minGap, int maxRanges)
+{
+    QList<QPair<int, int> > merged;
+    foreach (const QPair<int, int> &range, ranges) {
+        if (!merged.isEmpty() && range.first - merged.last().second < minGap) {
+            merged.last().second = qMax(merged.last().second, range.second);
+        } else {
+            merged << range;
+        }
+    }
+    while (merged.count() > qMax(1, maxRanges)) {
+        int closest = 0;
+        for (int i = 1; i < merged.count() - 1; ++i) {
+            if (merged.at(i + 1).first - merged.at(i).second < merged.at(closest + 1).first - merged.at(closest).second) {
+                closest = i;
+            }
+        }
+        merged[closest].second = merged.at(closest + 1).second;
+        merged.removeAt(closest + 1);
+    }
+    return merged;
+}
+}
+
+#endif
@@ -18,15 +18,43 @@
  ***************************************************************************/
 
 #include "transitionhandler.h"
+#include "trackcompositing.h"
 #include "mltcontroller/effectscontroller.h"
 #include "mainwindow.h"
 #include "kdenlivesettings.h"
+#include "kdenlive_debug.h"
+
+#include <climits>
 
 TransitionHandler::TransitionHandler(Mlt::Tractor *tractor) : QObject()
     , m_tractor(tractor)
+    , m_index(tractor)
 {
 }
 
+TransitionHandler::~TransitionHandler()
+{
+}
+
+void TransitionHandler::invalidateIndex()
+{
+    m_index.invalidate();
+}
+
+mlt_transition TransitionHandler::findTransition(const QString &tag, int b_track, int in, int out) const
+{
+    return m_index.find(b_track, in, in, false, [&tag, out](mlt_transition tr, int, int trOut) {
+        return trOut == out && tag == mlt_properties_get(MLT_TRANSITION_PROPERTIES(tr), "mlt_service");
+    });
+}
+
+mlt_transition TransitionHandler::findTransitionAt(const QString &tag, int b_track, int position) const
+{
+    return m_index.find(b_track, 0, position, true, [&tag, position](mlt_transition tr, int, int trOut) {
+        return trOut >= position && tag == mlt_properties_get(MLT_TRANSITION_PROPERTIES(tr), "mlt_service");
+    });
+}
+
 bool TransitionHandler::addTransition(const QString &tag, int a_track, int b_track, GenTime in, GenTime out, const QDomElement &xml)
 {
     if (in >= out) {
@@ -203,6 +231,7 @@ void TransitionHandler::plantTransition(Mlt::Field *field, Mlt::Transition &tr,
             cloneProperties(new_trans_props, trans_props);
             trList.append(cp);
             field->disconnect_service(transition);
+            m_index.remove(transition.get_transition());
         }
         //else qCDebug(KDENLIVE_LOG) << "// FOUND TRANS OK, "<<resource<< ", A_: " << aTrack << ", B_ "<<bTrack;
 
@@ -214,11 +243,14 @@ void TransitionHandler::plantTransition(Mlt::Field *field, Mlt::Transition &tr,
         resource = mlt_properties_get(properties, "mlt_service");
     }
     field->plant_transition(tr, a_track, b_track);
+    // Planted transitions become the head of the field chain
+    m_index.addHead(tr.get_transition());
 
     // re-add upper transitions
     for (int i = trList.count() - 1; i >= 0; --i) {
         ////qCDebug(KDENLIVE_LOG)<< "REPLANT ON TK: "<<trList.at(i)->get_a_track()<<", "<<trList.at(i)->get_b_track();
         field->plant_transition(*trList.at(i), trList.at(i)->get_a_track(), trList.at(i)->get_b_track());
+        m_index.addHead(trList.at(i)->get_transition());
     }
     qDeleteAll(trList);
 }
@@ -254,64 +286,45 @@ void TransitionHandler::updateTransitionParams(const QString &type, int a_track,
     QScopedPointer<Mlt::Field> field(m_tractor->field());
     field->lock();
     double fps = m_tractor->get_fps();
-    mlt_service nextservice = mlt_service_get_producer(field->get_service());
-    mlt_properties properties = MLT_SERVICE_PROPERTIES(nextservice);
-    QString resource = mlt_properties_get(properties, "mlt_service");
     int in_pos = (int) in.frames(fps);
     int out_pos = (int) out.frames(fps) - 1;
 
-    mlt_service_type mlt_type = mlt_service_identify(nextservice);
-    while (mlt_type == transition_type) {
-        mlt_transition tr = (mlt_transition) nextservice;
-        int currentTrack = mlt_transition_get_b_track(tr);
+    mlt_transition tr = findTransition(type, b_track, in_pos, out_pos);
+    if (tr) {
         int currentBTrack = mlt_transition_get_a_track(tr);
-        int currentIn = (int) mlt_transition_get_in(tr);
-        int currentOut = (int) mlt_transition_get_out(tr);
-
-        // //qCDebug(KDENLIVE_LOG)<<"Looking for transition : " << currentIn <<'x'<<currentOut<< ", OLD oNE: "<<in_pos<<'x'<<out_pos;
-        if (resource == type && b_track == currentTrack && currentIn == in_pos && currentOut == out_pos) {
-            QMap<QString, QString> map = getTransitionParamsFromXml(xml);
-            QMap<QString, QString>::Iterator it;
-            QString key;
-            mlt_properties transproperties = MLT_TRANSITION_PROPERTIES(tr);
-
-            QString currentId = mlt_properties_get(transproperties, "kdenlive_id");
-            if (currentId != xml.attribute(QStringLiteral("id"))) {
-                // The transition ID is not the same, so reset all properties
-                mlt_properties_set(transproperties, "kdenlive_id", xml.attribute(QStringLiteral("id")).toUtf8().constData());
-                // Cleanup previous properties
-                QStringList permanentProps;
-                permanentProps << QStringLiteral("factory") << QStringLiteral("kdenlive_id") << QStringLiteral("mlt_service") << QStringLiteral("mlt_type") << QStringLiteral("in");
-                permanentProps << QStringLiteral("out") << QStringLiteral("a_track") << QStringLiteral("b_track");
-                for (int i = 0; i < mlt_properties_count(transproperties); ++i) {
-                    QString propName = mlt_properties_get_name(transproperties, i);
-                    if (!propName.startsWith('_') && ! permanentProps.contains(propName)) {
-                        mlt_properties_set(transproperties, propName.toUtf8().constData(), "");
-                    }
+        QMap<QString, QString> map = getTransitionParamsFromXml(xml);
+        QMap<QString, QString>::Iterator it;
+        QString key;
+        mlt_properties transproperties = MLT_TRANSITION_PROPERTIES(tr);
+
+        QString currentId = mlt_properties_get(transproperties, "kdenlive_id");
+        if (currentId != xml.attribute(QStringLiteral("id"))) {
+            // The transition ID is not the same, so reset all properties
+            mlt_properties_set(transproperties, "kdenlive_id", xml.attribute(QStringLiteral("id")).toUtf8().constData());
+            // Cleanup previous properties
+            QStringList permanentProps;
+            permanentProps << QStringLiteral("factory") << QStringLiteral("kdenlive_id") << QStringLiteral("mlt_service") << QStringLiteral("mlt_type") << QStringLiteral("in");
+            permanentProps << QStringLiteral("out") << QStringLiteral("a_track") << QStringLiteral("b_track");
+            for (int i = 0; i < mlt_properties_count(transproperties); ++i) {
+                QString propName = mlt_properties_get_name(transproperties, i);
+                if (!propName.startsWith('_') && ! permanentProps.contains(propName)) {
+                    mlt_properties_set(transproperties, propName.toUtf8().constData(), "");
                 }
             }
+        }
 
-            mlt_properties_set_int(transproperties, "force_track", xml.attribute(QStringLiteral("force_track")).toInt());
-            mlt_properties_set_int(transproperties, "automatic", xml.attribute(QStringLiteral("automatic"), QStringLiteral("0")).toInt());
+        mlt_properties_set_int(transproperties, "force_track", xml.attribute(QStringLiteral("force_track")).toInt());
+        mlt_properties_set_int(transproperties, "automatic", xml.attribute(QStringLiteral("automatic"), QStringLiteral("0")).toInt());
 
-            if (currentBTrack != a_track) {
-                mlt_properties_set_int(transproperties, "a_track", a_track);
-            }
-            for (it = map.begin(); it != map.end(); ++it) {
-                key = it.key();
-                mlt_properties_set(transproperties, key.toUtf8().constData(), it.value().toUtf8().constData());
-                //qCDebug(KDENLIVE_LOG) << " ------  UPDATING TRANS PARAM: " << key.toUtf8().constData() << ": " << it.value().toUtf8().constData();
-                //filter->set("kdenlive_id", id);
-            }
-            break;
+        if (currentBTrack != a_track) {
+            mlt_properties_set_int(transproperties, "a_track", a_track);
         }
-        nextservice = mlt_service_producer(nextservice);
-        if (nextservice == nullptr) {
-            break;
+        for (it = map.begin(); it != map.end(); ++it) {
+            key = it.key();
+            mlt_properties_set(transproperties, key.toUtf8().constData(), it.value().toUtf8().constData());
+            //qCDebug(KDENLIVE_LOG) << " ------  UPDATING TRANS PARAM: " << key.toUtf8().constData() << ": " << it.value().toUtf8().constData();
+            //filter->set("kdenlive_id", id);
         }
-        properties = MLT_SERVICE_PROPERTIES(nextservice);
-        mlt_type = mlt_service_identify(nextservice);
-        resource = mlt_properties_get(properties, "mlt_service");
     }
     field->unlock();
     //askForRefresh();
@@ -322,39 +335,19 @@ bool TransitionHandler::deleteTransition(const QString &tag, int /*a_track*/, in
 {
     QScopedPointer<Mlt::Field> field(m_tractor->field());
     field->lock();
-    mlt_service nextservice = mlt_service_get_producer(field->get_service());
-    mlt_properties properties = MLT_SERVICE_PROPERTIES(nextservice);
-    QString resource = mlt_properties_get(properties, "mlt_service");
     double fps = m_tractor->get_fps();
     const int old_pos = (int)((in + out).frames(fps) / 2);
-    bool found = false;
     ////qCDebug(KDENLIVE_LOG) << " del trans pos: " << in.frames(25) << '-' << out.frames(25);
 
-    mlt_service_type mlt_type = mlt_service_identify(nextservice);
-    while (mlt_type == transition_type) {
-        mlt_transition tr = (mlt_transition) nextservice;
-        int currentTrack = mlt_transition_get_b_track(tr);
-        int currentIn = (int) mlt_transition_get_in(tr);
-        int currentOut = (int) mlt_transition_get_out(tr);
-        ////qCDebug(KDENLIVE_LOG) << "// FOUND EXISTING TRANS, IN: " << currentIn << ", OUT: " << currentOut << ", TRACK: " << currentTrack;
-
-        if (resource == tag && b_track == currentTrack && currentIn <= old_pos && currentOut >= old_pos) {
-            found = true;
-            mlt_field_disconnect_service(field->get_field(), nextservice);
-            break;
-        }
-        nextservice = mlt_service_producer(nextservice);
-        if (nextservice == nullptr) {
-            break;
-        }
-        properties = MLT_SERVICE_PROPERTIES(nextservice);
-        mlt_type = mlt_service_identify(nextservice);
-        resource = mlt_properties_get(properties, "mlt_service");
+    mlt_transition tr = findTransitionAt(tag, b_track, old_pos);
+    if (tr) {
+        mlt_field_disconnect_service(field->get_field(), MLT_TRANSITION_SERVICE(tr));
+        m_index.remove(tr);
     }
     field->unlock();
     //askForRefresh();
     //if (m_isBlocked == 0) m_mltConsumer->set("refresh", 1);
-    return found;
+    return tr != nullptr;
 }
 
 void TransitionHandler::deleteTrackTransitions(int ix)
@@ -368,6 +361,7 @@ void TransitionHandler::deleteTrackTransitions(int ix)
         int currentTrack = transition.get_b_track();
         if (ix == currentTrack) {
             field->disconnect_service(transition);
+            m_index.invalidate();
         }
         if (nextservice == nullptr) {
             break;
@@ -389,87 +383,50 @@ bool TransitionHandler::moveTransition(const QString &type, int startTrack, int
 
     QScopedPointer<Mlt::Field> field(m_tractor->field());
     field->lock();
-    mlt_service nextservice = mlt_service_get_producer(field->get_service());
-    mlt_properties properties = MLT_SERVICE_PROPERTIES(nextservice);
-    QString resource = mlt_properties_get(properties, "mlt_service");
     int old_pos = (int)(old_in + old_out) / 2;
-    bool found = false;
-    mlt_service_type mlt_type = mlt_service_identify(nextservice);
-    while (mlt_type == transition_type) {
-        Mlt::Transition transition((mlt_transition) nextservice);
-        nextservice = mlt_service_producer(nextservice);
-        int currentTrack = transition.get_b_track();
-        int currentIn = (int) transition.get_in();
-        int currentOut = (int) transition.get_out();
-
-        if (resource == type && startTrack == currentTrack && currentIn <= old_pos && currentOut >= old_pos) {
-            found = true;
-            if (newTrack - startTrack != 0) {
-                Mlt::Properties trans_props(transition.get_properties());
-                Mlt::Transition new_transition(*m_tractor->profile(), transition.get("mlt_service"));
-                Mlt::Properties new_trans_props(new_transition.get_properties());
-                // We cannot use MLT's property inherit because it also clones internal values like _unique_id which messes up the playlist
-                cloneProperties(new_trans_props, trans_props);
-                new_transition.set_in_and_out(new_in, new_out);
-                field->disconnect_service(transition);
-                plantTransition(field.data(), new_transition, newTransitionTrack, newTrack);
-            } else {
-                transition.set_in_and_out(new_in, new_out);
-            }
-            break;
-        }
-        if (nextservice == nullptr) {
-            break;
+    mlt_transition tr = findTransitionAt(type, startTrack, old_pos);
+    if (tr) {
+        Mlt::Transition transition(tr);
+        if (newTrack - startTrack != 0) {
+            Mlt::Properties trans_props(transition.get_properties());
+            Mlt::Transition new_transition(*m_tractor->profile(), transition.get("mlt_service"));
+            Mlt::Properties new_trans_props(new_transition.get_properties());
+            // We cannot use MLT's property inherit because it also clones internal values like _unique_id which messes up the playlist
+            cloneProperties(new_trans_props, trans_props);
+            new_transition.set_in_and_out(new_in, new_out);
+            field->disconnect_service(transition);
+            m_index.remove(tr);
+            plantTransition(field.data(), new_transition, newTransitionTrack, newTrack);
+        } else {
+            const int order = m_index.remove(tr);
+            transition.set_in_and_out(new_in, new_out);
+            m_index.reinsert(tr, order);
         }
-        properties = MLT_SERVICE_PROPERTIES(nextservice);
-        mlt_type = mlt_service_identify(nextservice);
-        resource = mlt_properties_get(properties, "mlt_service");
     }
     field->unlock();
     //if (m_isBlocked == 0) m_mltConsumer->set("refresh", 1);
-    return found;
+    return tr != nullptr;
 }
 
 Mlt::Transition *TransitionHandler::getTransition(const QString &name, int b_track, int a_track, bool internalTransition) const
 {
-    QScopedPointer<Mlt::Service> service(m_tractor->field());
-    while (service && service->is_valid()) {
-        if (service->type() == transition_type) {
-            Mlt::Transition t((mlt_transition) service->get_service());
-            if (name == t.get("mlt_service") && t.get_b_track() == b_track) {
-                if (a_track == -1 || t.get_a_track() == a_track) {
-                    int internal = t.get_int("internal_added");
-                    if (internal == 0) {
-                        if (!internalTransition) {
-                            return new Mlt::Transition(t);
-                        }
-                    } else if (internalTransition) {
-                        return new Mlt::Transition(t);
-                    }
-                }
-            }
+    mlt_transition tr = m_index.find(b_track, INT_MIN, INT_MAX, false, [&name, a_track, internalTransition](mlt_transition t, int, int) {
+        mlt_properties props = MLT_TRANSITION_PROPERTIES(t);
+        if (name != mlt_properties_get(props, "mlt_service") || (a_track != -1 && mlt_transition_get_a_track(t) != a_track)) {
+            return false;
         }
-        service.reset(service->producer());
-    }
-    return nullptr;
+        return (mlt_properties_get_int(props, "internal_added") != 0) == internalTransition;
+    });
+    return tr ? new Mlt::Transition(tr) : nullptr;
 }
 
 Mlt::Transition *TransitionHandler::getTrackTransition(const QStringList &names, int b_track, int a_track) const
 {
-    QScopedPointer<Mlt::Service> service(m_tractor->field());
-    while (service && service->is_valid()) {
-        if (service->type() == transition_type) {
-            Mlt::Transition t((mlt_transition) service->get_service());
-            int internal = t.get_int("internal_added");
-            if (internal >= 200) {
-                if (names.contains(t.get("mlt_service")) && t.get_b_track() == b_track && (a_track == -1 || t.get_a_track() == a_track)) {
-                    return new Mlt::Transition(t);
-                }
-            }
-        }
-        service.reset(service->producer());
-    }
-    return nullptr;
+    mlt_transition tr = m_index.find(b_track, INT_MIN, INT_MAX, false, [&names, a_track](mlt_transition t, int, int) {
+        mlt_properties props = MLT_TRANSITION_PROPERTIES(t);
+        return mlt_properties_get_int(props, "internal_added") >= 200 && names.contains(mlt_properties_get(props, "mlt_service")) && (a_track == -1 || mlt_transition_get_a_track(t) == a_track);
+    });
+    return tr ? new Mlt::Transition(tr) : nullptr;
 }
 
 void TransitionHandler::duplicateTransitionOnPlaylist(int in, int out, const QString &tag, const QDomElement &xml, int a_track, int b_track, Mlt::Field *field)
@@ -518,6 +475,7 @@ void TransitionHandler::enableMultiTrack(bool enable)
     QScopedPointer<Mlt::Service> service(m_tractor->field());
     QScopedPointer<Mlt::Field> field(m_tractor->field());
     field->lock();
+    m_index.invalidate();
     if (enable) {
         // disable track composition (frei0r.cairoblend)
         mlt_service nextservice = mlt_service_get_producer(field->get_service());
@@ -527,9 +485,15 @@ void TransitionHandler::enableMultiTrack(bool enable)
             nextservice = mlt_service_producer(nextservice);
             int added = transition.get_int("internal_added");
             if (added == 237) {
-                if (compositeService.contains(transition.get("mlt_service")) && transition.get_int("disable") == 0) {
-                    transition.set("disable", 1);
-                    transition.set("split_disable", 1);
+                if (compositeService.contains(transition.get("mlt_service"))) {
+                    if (transition.get_int("disable") == 0) {
+                        transition.set("disable", 1);
+                        transition.set("split_disable", 1);
+                    } else if (transition.get_int("empty_disable") == 1) {
+                        // Track is empty, let the split view restore it like the others
+                        transition.set("empty_disable", (char *) nullptr);
+                        transition.set("split_disable", 1);
+                    }
                 }
             }
             if (nextservice == nullptr) {
@@ -604,19 +568,132 @@ void TransitionHandler::enableMultiTrack(bool enable)
     emit refresh();
 }
 
+bool TransitionHandler::setTrackContentRanges(int b_track, const QList<QPair<int, int> > &ranges)
+{
+    QScopedPointer<Mlt::Field> field(m_tractor->field());
+    field->lock();
+    bool changed = false;
+    // Audio mix first, then compositing
+    for (int pass = 0; pass < 2; ++pass) {
+        const bool mix = pass == 0;
+        mlt_transition primary = nullptr;
+        QList<mlt_transition> segments;
+        mlt_service nextservice = mlt_service_get_producer(field->get_service());
+        mlt_service_type type = mlt_service_identify(nextservice);
+        while (type == transition_type) {
+            mlt_transition tr = (mlt_transition) nextservice;
+            nextservice = mlt_service_producer(nextservice);
+            mlt_properties props = MLT_TRANSITION_PROPERTIES(tr);
+            if (mlt_transition_get_b_track(tr) == b_track && mlt_properties_get_int(props, "internal_added") == 237 && (qstrcmp(mlt_properties_get(props, "mlt_service"), "mix") == 0) == mix) {
+                if (mlt_properties_get_int(props, "kdenlive:content_segment") == 1) {
+                    segments << tr;
+                } else {
+                    primary = tr;
+                }
+            }
+            if (nextservice == nullptr) {
+                break;
+            }
+            type = mlt_service_identify(nextservice);
+        }
+        if (primary == nullptr) {
+            continue;
+        }
+        // Remove the copies that are not needed anymore
+        while (segments.count() > qMax(0, ranges.count() - 1)) {
+            Mlt::Transition transition(segments.takeLast());
+            m_index.remove(transition.get_transition());
+            field->disconnect_service(transition);
+            changed = true;
+        }
+        Mlt::Transition transition(primary);
+        if (ranges.isEmpty()) {
+            // Nothing to blend on an empty track
+            if (transition.get_int("disable") == 0) {
+                transition.set("disable", 1);
+                transition.set("empty_disable", 1);
+                changed = true;
+            }
+            continue;
+        }
+        if (transition.get_int("empty_disable") == 1) {
+            transition.set("disable", 0);
+            transition.set("empty_disable", (char *) nullptr);
+            changed = true;
+        }
+        // Blanks before, between and after the clips do not need blending
+        for (int i = 0; i <= segments.count() && i < ranges.count(); ++i) {
+            mlt_transition tr = i == 0 ? primary : segments.at(i - 1);
+            const QPair<int, int> &range = ranges.at(i);
+            if (mlt_properties_get_int(MLT_TRANSITION_PROPERTIES(tr), "always_active") == 0 && mlt_transition_get_in(tr) == range.first && mlt_transition_get_out(tr) == range.second - 1) {
+                continue;
+            }
+            const int order = m_index.remove(tr);
+            mlt_properties_set_int(MLT_TRANSITION_PROPERTIES(tr), "always_active", 0);
+            mlt_transition_set_in_and_out(tr, range.first, range.second - 1);
+            m_index.reinsert(tr, order);
+            changed = true;
+        }
+        if (ranges.count() > segments.count() + 1) {
+            QList<Mlt::Transition *> copies;
+            for (int i = segments.count() + 1; i < ranges.count(); ++i) {
+                Mlt::Transition *copy = new Mlt::Transition(*m_tractor->profile(), transition.get("mlt_service"));
+                Mlt::Properties source(transition.get_properties());
+                Mlt::Properties dest(copy->get_properties());
+                cloneProperties(dest, source);
+                copy->set("id", (char *) nullptr);
+                copy->set("kdenlive:content_segment", 1);
+                copy->set_in_and_out(ranges.at(i).first, ranges.at(i).second - 1);
+                copies << copy;
+            }
+            plantAbove(field.data(), copies, primary);
+            qDeleteAll(copies);
+            changed = true;
+        }
+    }
+    field->unlock();
+    return changed;
+}
+
+void TransitionHandler::plantAbove(Mlt::Field *field, const QList<Mlt::Transition *> &transitions, mlt_transition below)
+{
+    // Transitions are processed from the tail of the field chain, keep the track order by replanting the ones above
+    QList<Mlt::Transition *> trList;
+    mlt_service nextservice = mlt_service_get_producer(field->get_service());
+    mlt_service_type type = mlt_service_identify(nextservice);
+    while (type == transition_type && nextservice != MLT_TRANSITION_SERVICE(below)) {
+        Mlt::Transition transition((mlt_transition) nextservice);
+        nextservice = mlt_service_producer(nextservice);
+        Mlt::Properties trans_props(transition.get_properties());
+        Mlt::Transition *cp = new Mlt::Transition(*m_tractor->profile(), transition.get("mlt_service"));
+        Mlt::Properties new_trans_props(cp->get_properties());
+        cloneProperties(new_trans_props, trans_props);
+        trList.append(cp);
+        field->disconnect_service(transition);
+        if (nextservice == nullptr) {
+            break;
+        }
+        type = mlt_service_identify(nextservice);
+    }
+    foreach (Mlt::Transition *tr, transitions) {
+        field->plant_transition(*tr, tr->get_a_track(), tr->get_b_track());
+    }
+    for (int i = trList.count() - 1; i >= 0; --i) {
+        field->plant_transition(*trList.at(i), trList.at(i)->get_a_track(), trList.at(i)->get_b_track());
+    }
+    qDeleteAll(trList);
+    m_index.invalidate();
+}
+
 // static
 const QString TransitionHandler::compositeTransition()
 {
     if (KdenliveSettings::gpu_accel()) {
         return QStringLiteral("movit.overlay");
     }
-    if (MainWindow::transitions.hasTransition(QStringLiteral("qtblend"))) {
-        return QStringLiteral("qtblend");
-    }
-    if (MainWindow::transitions.hasTransition(QStringLiteral("frei0r.cairoblend"))) {
-        return QStringLiteral("frei0r.cairoblend");
-    }
-    return QStringLiteral("composite");
+    return TrackCompositing::preferredComposite([](const QString &name) {
+        return MainWindow::transitions.hasTransition(name);
+    });
 }
 
 void TransitionHandler::rebuildTransitions(int mode, const QList<int> &videoTracks, int maxTrack)
@@ -626,6 +703,7 @@ void TransitionHandler::rebuildTransitions(int mode, const QList<int> &videoTrac
     QScopedPointer<Mlt::Service> service(m_tractor->field());
     Mlt::Field *field = m_tractor->field();
     field->lock();
+    m_index.invalidate();
     // Get the list of composite transitions
     while (service && service->is_valid()) {
         if (service->type() == transition_type) {
@@ -695,7 +773,6 @@ void TransitionHandler::rebuildTransitions(int mode, const QList<int> &videoTrac
 
 // static
 bool TransitionHandler::sumAudioMixAvailable() {
-    // TODO: remove whenever we require MLT > 6.4.x
-    return (LIBMLT_VERSION_MAJOR > 6 || (LIBMLT_VERSION_MAJOR == 6 && LIBMLT_VERSION_MINOR > 4));
+    return TrackCompositing::sumAudioMixAvailable();
 }
 
@@ -27,14 +27,19 @@
 #define TRANSITIONHANDLER_H
 
 #include "definitions.h"
+#include "transitionindex.h"
 #include <mlt++/Mlt.h>
 
+#include <QHash>
+#include <QMap>
+
 class TransitionHandler : public QObject
 {
     Q_OBJECT
 
 public:
     explicit TransitionHandler(Mlt::Tractor *tractor);
+    ~TransitionHandler();
     bool addTransition(const QString &tag, int a_track, int b_track, GenTime in, GenTime out, const QDomElement &xml);
     /** @brief Initialize transition settings if necessary and return an array of values. */
     QMap<QString, QString> getTransitionParamsFromXml(const QDomElement &xml);
@@ -61,9 +66,22 @@ public:
     /** @brief Initialize transition settings. */
     void initTransition(const QDomElement &xml);
     static bool sumAudioMixAvailable();
+    /** @brief Restrict the track compositing and audio mix of @param b_track to the frame @param ranges covered by clips.
+     *  The first range is set on the automatic transitions, a copy marked with kdenlive:content_segment is planted for each other range.
+     *  Both are disabled if the track is empty (no range). Returns true if a transition was changed. */
+    bool setTrackContentRanges(int b_track, const QList<QPair<int, int> > &ranges);
+    /** @brief Mark the transition index as outdated, needed when transitions are planted, removed or moved without using this class. */
+    void invalidateIndex();
 
 private:
     Mlt::Tractor *m_tractor;
+    mutable TransitionIndex m_index;
+    /** @brief Plants @param transitions right above @param below in the field chain, so that they are processed in the same track order. */
+    void plantAbove(Mlt::Field *field, const QList<Mlt::Transition *> &transitions, mlt_transition below);
+    /** @brief Returns the transition @param tag on @param b_track with the exact range @param in - @param out. */
+    mlt_transition findTransition(const QString &tag, int b_track, int in, int out) const;
+    /** @brief Returns the transition @param tag on @param b_track that contains @param position. */
+    mlt_transition findTransitionAt(const QString &tag, int b_track, int position) const;
 
 signals:
     void refresh();
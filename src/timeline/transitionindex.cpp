@@ -0,0 +1,131 @@
+/*
+Copyright (C) 2018  Jean-Baptiste Mardelle <jb@kdenlive.org>
+This file is part of Kdenlive. See www.kdenlive.org.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "transitionindex.h"
+
+#include <QScopedPointer>
+
+TransitionIndex::TransitionIndex(Mlt::Tractor *tractor) :
+    m_tractor(tractor)
+    , m_dirty(true)
+    , m_headOrder(0)
+{
+}
+
+TransitionIndex::~TransitionIndex()
+{
+    clear();
+}
+
+void TransitionIndex::invalidate()
+{
+    m_dirty = true;
+}
+
+bool TransitionIndex::isValid() const
+{
+    return !m_dirty;
+}
+
+void TransitionIndex::clear()
+{
+    for (auto track = m_index.constBegin(); track != m_index.constEnd(); ++track) {
+        for (const IndexEntry &entry : track.value()) {
+            mlt_transition_close(entry.transition);
+        }
+    }
+    m_index.clear();
+    m_maxLength.clear();
+}
+
+void TransitionIndex::rebuild()
+{
+    clear();
+    QScopedPointer<Mlt::Field> field(m_tractor->field());
+    mlt_service nextservice = mlt_service_get_producer(field->get_service());
+    int order = 0;
+    while (nextservice != nullptr && mlt_service_identify(nextservice) == transition_type) {
+        insert((mlt_transition) nextservice, order++);
+        nextservice = mlt_service_producer(nextservice);
+    }
+    m_headOrder = 0;
+    m_dirty = false;
+}
+
+void TransitionIndex::insert(mlt_transition tr, int order)
+{
+    mlt_properties_inc_ref(MLT_TRANSITION_PROPERTIES(tr));
+    IndexEntry entry;
+    entry.transition = tr;
+    entry.out = (int) mlt_transition_get_out(tr);
+    entry.order = order;
+    const int b_track = mlt_transition_get_b_track(tr);
+    const int in = (int) mlt_transition_get_in(tr);
+    m_index[b_track].insert(in, entry);
+    int &maxLength = m_maxLength[b_track];
+    maxLength = qMax(maxLength, entry.out - in);
+}
+
+void TransitionIndex::addHead(mlt_transition tr)
+{
+    if (!m_dirty) {
+        insert(tr, --m_headOrder);
+    }
+}
+
+int TransitionIndex::remove(mlt_transition tr)
+{
+    if (m_dirty) {
+        return INT_MIN;
+    }
+    auto track = m_index.find(mlt_transition_get_b_track(tr));
+    if (track == m_index.end()) {
+        m_dirty = true;
+        return INT_MIN;
+    }
+    QMultiMap<int, IndexEntry> &entries = track.value();
+    auto i = entries.find((int) mlt_transition_get_in(tr));
+    while (i != entries.end() && i.value().transition != tr) {
+        ++i;
+    }
+    if (i == entries.end()) {
+        // Range was changed outside of the index, search the whole track
+        for (i = entries.begin(); i != entries.end() && i.value().transition != tr; ++i) {}
+        if (i == entries.end()) {
+            m_dirty = true;
+            return INT_MIN;
+        }
+    }
+    const int order = i.value().order;
+    entries.erase(i);
+    mlt_transition_close(tr);
+    return order;
+}
+
+void TransitionIndex::reinsert(mlt_transition tr, int order)
+{
+    if (order == INT_MIN) {
+        m_dirty = true;
+    } else if (!m_dirty) {
+        // The transition keeps its place in the field chain
+        insert(tr, order);
+    }
+}
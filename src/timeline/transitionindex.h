@@ -0,0 +1,113 @@
+/*
+Copyright (C) 2018  Jean-Baptiste Mardelle <jb@kdenlive.org>
+This file is part of Kdenlive. See www.kdenlive.org.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TRANSITIONINDEX_H
+#define TRANSITIONINDEX_H
+
+#include <mlt++/Mlt.h>
+
+#include <QHash>
+#include <QMultiMap>
+#include <climits>
+
+/**
+ * @class TransitionIndex
+ * @brief Index of the transitions of a tractor field, by b_track and then by in point.
+ *
+ * Each entry holds a reference on its transition and its position in the field chain, so that lookups return
+ * the same transition as a walk of the chain. Code that plants, removes or moves transitions without updating
+ * the index must call invalidate(), the index is then rebuilt on the next lookup.
+ */
+class TransitionIndex
+{
+public:
+    explicit TransitionIndex(Mlt::Tractor *tractor);
+    ~TransitionIndex();
+    /** @brief Mark the index as outdated. */
+    void invalidate();
+    /** @brief Returns false if the index will be rebuilt on the next lookup. */
+    bool isValid() const;
+    /** @brief Index @param tr, which was just planted at the head of the field chain. */
+    void addHead(mlt_transition tr);
+    /** @brief Remove @param tr from the index and returns its order, or INT_MIN if it was not indexed. */
+    int remove(mlt_transition tr);
+    /** @brief Index @param tr again after its range was changed, with the @param order returned by remove(). */
+    void reinsert(mlt_transition tr, int order);
+    /** @brief Returns the first transition on @param b_track with an in point between @param minIn and @param maxIn accepted by @param match, without a new reference.
+     *  If @param containing is true, minIn is ignored and all transitions that can contain maxIn are tested. */
+    template <typename Match> mlt_transition find(int b_track, int minIn, int maxIn, bool containing, Match match);
+
+private:
+    struct IndexEntry {
+        mlt_transition transition;
+        int out;
+        /** @brief Position in the field chain, lower values are closer to the tractor */
+        int order;
+    };
+    Mlt::Tractor *m_tractor;
+    /** @brief Transitions of the field by b_track, then by in point. Each entry holds a reference on its transition */
+    QHash<int, QMultiMap<int, IndexEntry> > m_index;
+    /** @brief Longest transition on each b_track, limits the search for a transition containing a position */
+    QHash<int, int> m_maxLength;
+    bool m_dirty;
+    /** @brief Order given to the next transition planted at the head of the field chain */
+    int m_headOrder;
+    void rebuild();
+    void clear();
+    void insert(mlt_transition tr, int order);
+};
+
+template <typename Match>
+mlt_transition TransitionIndex::find(int b_track, int minIn, int maxIn, bool containing, Match match)
+{
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        if (m_dirty) {
+            rebuild();
+        }
+        mlt_transition result = nullptr;
+        int resultOrder = INT_MAX;
+        bool stale = false;
+        auto track = m_index.constFind(b_track);
+        if (track != m_index.constEnd()) {
+            // A transition containing maxIn cannot start before the longest transition of the track
+            const int first = containing ? maxIn - m_maxLength.value(b_track) : minIn;
+            for (auto i = track.value().lowerBound(first); i != track.value().constEnd() && i.key() <= maxIn; ++i) {
+                const IndexEntry &entry = i.value();
+                // Transitions can be modified directly through MLT, check that the entry still matches
+                if (mlt_transition_get_b_track(entry.transition) != b_track || (int) mlt_transition_get_in(entry.transition) != i.key() || (int) mlt_transition_get_out(entry.transition) != entry.out) {
+                    stale = true;
+                    break;
+                }
+                if (entry.order < resultOrder && match(entry.transition, i.key(), entry.out)) {
+                    result = entry.transition;
+                    resultOrder = entry.order;
+                }
+            }
+        }
+        if (!stale) {
+            return result;
+        }
+        m_dirty = true;
+    }
+    return nullptr;
+}
+
+#endif
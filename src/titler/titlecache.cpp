@@ -0,0 +1,216 @@
+/*
+Copyright (C) 2018  Jean-Baptiste Mardelle <jb@kdenlive.org>
+This file is part of Kdenlive. See www.kdenlive.org.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "titlecache.h"
+#include "titledocument.h"
+#include "effectslist/effectslist.h"
+#include "project/cachemanager.h"
+#include "core.h"
+#include "kdenlive_debug.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QMutex>
+#include <QThread>
+#include <QPainter>
+#include <QSaveFile>
+#include <QDomDocument>
+#include <QApplication>
+#include <QGraphicsScene>
+#include <QGraphicsRectItem>
+#include <QCryptographicHash>
+
+static QMutex folderMutex;
+static QString cacheFolder;
+
+// static
+void TitleCache::setCacheFolder(const QString &folder)
+{
+    QMutexLocker lock(&folderMutex);
+    cacheFolder = folder;
+}
+
+// static
+bool TitleCache::isStatic(const QString &xml)
+{
+    QDomDocument doc;
+    if (!doc.setContent(xml)) {
+        return false;
+    }
+    const QDomElement root = doc.documentElement();
+    const QDomNodeList contents = root.elementsByTagName(QStringLiteral("content"));
+    for (int i = 0; i < contents.count(); ++i) {
+        if (contents.at(i).toElement().hasAttribute(QStringLiteral("typewriter"))) {
+            return false;
+        }
+    }
+    const QDomElement start = root.firstChildElement(QStringLiteral("startviewport"));
+    const QDomElement end = root.firstChildElement(QStringLiteral("endviewport"));
+    return start.attribute(QStringLiteral("rect")) == end.attribute(QStringLiteral("rect"));
+}
+
+// static
+QString TitleCache::fileName(const QString &xml, const QSize &size)
+{
+    if (size.isEmpty()) {
+        return QString();
+    }
+    QCryptographicHash hasher(QCryptographicHash::Md5);
+    hasher.addData(xml.toUtf8());
+    if (xml.contains(QLatin1String("url="))) {
+        // Images and SVG files are loaded from disk, the title changes with them
+        QDomDocument doc;
+        if (doc.setContent(xml)) {
+            const QDomNodeList contents = doc.elementsByTagName(QStringLiteral("content"));
+            for (int i = 0; i < contents.count(); ++i) {
+                const QDomElement content = contents.at(i).toElement();
+                if (!content.hasAttribute(QStringLiteral("url"))) {
+                    continue;
+                }
+                const QFileInfo info(content.attribute(QStringLiteral("url")));
+                hasher.addData(QStringLiteral("%1:%2:%3").arg(info.absoluteFilePath()).arg(info.lastModified().toMSecsSinceEpoch()).arg(info.size()).toUtf8());
+            }
+        }
+    }
+    const QByteArray hash = hasher.result().toHex();
+    QMutexLocker lock(&folderMutex);
+    if (cacheFolder.isEmpty()) {
+        return QString();
+    }
+    return cacheFolder + QLatin1Char('/') + QString::fromLatin1(hash) + QStringLiteral("-%1x%2.png").arg(size.width()).arg(size.height());
+}
+
+// static
+QString TitleCache::imagePath(const QString &xml, const QSize &size)
+{
+    const QString path = fileName(xml, size);
+    if (path.isEmpty() || QFile::exists(path)) {
+        return path;
+    }
+    if (QThread::currentThread() != qApp->thread()) {
+        // Title items use pixmaps, they can only be created in the GUI thread
+        return QString();
+    }
+    const QImage img = render(xml, size);
+    if (img.isNull()) {
+        return QString();
+    }
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || !img.save(&file, "PNG") || !file.commit()) {
+        qCDebug(KDENLIVE_LOG) << "Cannot write title image" << path;
+        return QString();
+    }
+    pCore->cacheManager()->addFile(path);
+    return path;
+}
+
+// static
+QImage TitleCache::cachedImage(const QString &xml, const QSize &size)
+{
+    const QString path = fileName(xml, size);
+    if (path.isEmpty()) {
+        return QImage();
+    }
+    QImage img(path);
+    if (img.isNull()) {
+        return img;
+    }
+    return img.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+}
+
+// static
+QImage TitleCache::render(const QString &xml, const QSize &size)
+{
+    QDomDocument doc;
+    if (!doc.setContent(xml)) {
+        return QImage();
+    }
+    // Use the title's own size so that the document does not warn about a different frame size
+    int width = doc.documentElement().attribute(QStringLiteral("width"), QString::number(size.width())).toInt();
+    int height = doc.documentElement().attribute(QStringLiteral("height"), QString::number(size.height())).toInt();
+    if (width <= 0 || height <= 0) {
+        return QImage();
+    }
+    QGraphicsScene scene;
+    scene.setSceneRect(0, 0, width, height);
+    QGraphicsRectItem *background = scene.addRect(0, 0, width, height, QPen(Qt::NoPen), QBrush(Qt::transparent));
+    background->setZValue(-1100);
+    QGraphicsRectItem startViewport(0, 0, width, height);
+    QGraphicsRectItem endViewport(0, 0, width, height);
+    TitleDocument titleDoc;
+    titleDoc.setScene(&scene, width, height);
+    int duration;
+    titleDoc.loadFromXml(doc, &startViewport, &endViewport, &duration);
+
+    // Same painting as the kdenlivetitle producer, the start viewport is stretched to the frame
+    QImage img(size, QImage::Format_ARGB32_Premultiplied);
+    img.fill(Qt::transparent);
+    QPainter painter(&img);
+    painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing | QPainter::SmoothPixmapTransform);
+    const QRectF source(startViewport.pos(), startViewport.rect().size());
+    scene.render(&painter, QRectF(0, 0, size.width(), size.height()), source, Qt::IgnoreAspectRatio);
+    painter.end();
+    return img;
+}
+
+// static
+int TitleCache::replaceStaticTitles(QDomDocument &doc)
+{
+    const QDomElement profile = doc.documentElement().firstChildElement(QStringLiteral("profile"));
+    const QSize size(profile.attribute(QStringLiteral("width")).toInt(), profile.attribute(QStringLiteral("height")).toInt());
+    if (size.isEmpty()) {
+        return 0;
+    }
+    const double sar = profile.attribute(QStringLiteral("sample_aspect_num")).toDouble() / qMax(1, profile.attribute(QStringLiteral("sample_aspect_den")).toInt());
+    int replaced = 0;
+    QDomNodeList producers = doc.elementsByTagName(QStringLiteral("producer"));
+    for (int i = 0; i < producers.count(); ++i) {
+        QDomElement e = producers.item(i).toElement();
+        if (EffectsList::property(e, QStringLiteral("mlt_service")) != QLatin1String("kdenlivetitle")) {
+            continue;
+        }
+        // Template titles replace their text when they are rendered
+        if (!EffectsList::property(e, QStringLiteral("resource")).isEmpty() || !EffectsList::property(e, QStringLiteral("templatetext")).isEmpty()) {
+            continue;
+        }
+        const QString xml = EffectsList::property(e, QStringLiteral("xmldata"));
+        if (xml.isEmpty() || !isStatic(xml)) {
+            continue;
+        }
+        const QString path = imagePath(xml, size);
+        if (path.isEmpty()) {
+            continue;
+        }
+        EffectsList::setProperty(e, QStringLiteral("mlt_service"), QStringLiteral("qimage"));
+        EffectsList::removeProperty(e, QStringLiteral("resource"));
+        EffectsList::setProperty(e, QStringLiteral("resource"), path);
+        EffectsList::removeProperty(e, QStringLiteral("xmldata"));
+        if (sar > 0) {
+            // The image has the profile size, it must not be scaled again
+            EffectsList::setProperty(e, QStringLiteral("force_aspect_ratio"), QString::number(sar));
+        }
+        replaced++;
+    }
+    return replaced;
+}
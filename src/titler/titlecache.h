@@ -0,0 +1,62 @@
+/*
+Copyright (C) 2018  Jean-Baptiste Mardelle <jb@kdenlive.org>
+This file is part of Kdenlive. See www.kdenlive.org.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of
+the License or (at your option) version 3 or any later version
+accepted by the membership of KDE e.V. (or its successor approved
+by the membership of KDE e.V.), which shall act as a proxy
+defined in Section 14 of version 3 of the license.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TITLECACHE_H
+#define TITLECACHE_H
+
+#include <QString>
+#include <QSize>
+#include <QImage>
+
+class QDomDocument;
+
+/**
+ * @class TitleCache
+ * @brief Rasterized images of the title clips that have no animation.
+ *
+ * A static title is rendered once at the profile size and stored in the titles cache folder of the
+ * project, keyed by a hash of its xml, of the path, modification time and size of the images it
+ * uses, and of the frame size. The image is then used for thumbnails and replaces the kdenlivetitle
+ * producer in render and preview playlists, so the title xml does not need to be parsed and laid
+ * out again. Titles with a typewriter effect or a viewport animation
+ * always use the kdenlivetitle producer.
+ */
+class TitleCache
+{
+public:
+    /** @brief Set the folder where images are stored, empty to disable the cache. */
+    static void setCacheFolder(const QString &folder);
+    /** @brief Returns true if the title @param xml looks the same on all frames. */
+    static bool isStatic(const QString &xml);
+    /** @brief Returns the path of the image of title @param xml at @param size.
+     *  The title is rendered if it is not cached and we are in the GUI thread, otherwise an empty string is returned. */
+    static QString imagePath(const QString &xml, const QSize &size);
+    /** @brief Returns the cached image of title @param xml at @param size, or a null image. Can be called from any thread. */
+    static QImage cachedImage(const QString &xml, const QSize &size);
+    /** @brief Replace the static title producers of the MLT playlist @param doc with image producers. Returns the number of replaced titles. */
+    static int replaceStaticTitles(QDomDocument &doc);
+
+private:
+    static QString fileName(const QString &xml, const QSize &size);
+    static QImage render(const QString &xml, const QSize &size);
+};
+
+#endif
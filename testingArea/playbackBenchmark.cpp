@@ -0,0 +1,420 @@
+/*
+Copyright (C) 2018  Jean-Baptiste Mardelle <jb@kdenlive.org>
+This file is part of kdenlive. See www.kdenlive.org.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+*/
+
+#include <QFile>
+#include <QMap>
+#include <QVector>
+#include <QStringList>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QCoreApplication>
+#include <mlt++/Mlt.h>
+#include <iostream>
+#include <algorithm>
+
+#include "../src/timeline/trackcompositing.h"
+
+// Length of the synthetic clips and of the gaps between them, in frames
+static const int clipLength = 50;
+static const int gapLength = 25;
+
+void printUsage(const char *path)
+{
+    std::cout << "This executable plays a Kdenlive project without display or audio device" << std::endl
+              << "and reports the frame rate, frame times and memory used." << std::endl << std::endl
+              << path << " <project.kdenlive>" << std::endl
+              << "\t-h, --help\n\t\tDisplay this help" << std::endl
+              << "\t--generate=<file>\n\t\tWrite a synthetic project made of color, noise and tone clips to <file>" << std::endl
+              << "\t\tand use it for the benchmark" << std::endl
+              << "\t--tracks=<n>\n\t\tNumber of video and of audio tracks of the synthetic project (default 3)" << std::endl
+              << "\t--content-ranges\n\t\tRestrict the track compositing and audio mix of the synthetic project to the clips" << std::endl
+              << "\t\tlike the Kdenlive timeline does, instead of keeping them always active." << std::endl
+              << "\t\tThey are always restricted in a loaded project, like when it is opened in Kdenlive" << std::endl
+              << "\t--profile=<profile>\n\t\tProfile of the synthetic project (default atsc_1080p_25)" << std::endl
+              << "\t--frames=<n>\n\t\tNumber of frames pulled for each pattern (default 500)" << std::endl
+              << "\t--patterns=<list>\n\t\tComma separated patterns among playback, scrub and reverse (default all)" << std::endl
+              << "\t--json\n\t\tWrite one JSON object per pattern" << std::endl
+              ;
+}
+
+/** Same choice as TransitionHandler::compositeTransition() without GPU processing */
+QString compositeService()
+{
+    Mlt::Properties *transitions = Mlt::Factory::repository()->transitions();
+    QStringList available;
+    for (int i = 0; i < transitions->count(); ++i) {
+        available << transitions->get_name(i);
+    }
+    delete transitions;
+    return TrackCompositing::preferredComposite([&available](const QString &name) {
+        return available.contains(name);
+    });
+}
+
+/** Plant the internal transition @param service of @param track, once for each of its content @param ranges if not empty */
+void plantTrackTransition(Mlt::Field *field, Mlt::Profile &profile, const QString &service, int track, const QList<QPair<int, int> > &ranges)
+{
+    const int count = qMax(1, ranges.count());
+    for (int i = 0; i < count; ++i) {
+        Mlt::Transition transition(profile, service.toUtf8().constData());
+        if (ranges.isEmpty()) {
+            transition.set("always_active", 1);
+        } else {
+            transition.set_in_and_out(ranges.at(i).first, ranges.at(i).second - 1);
+        }
+        if (service == QLatin1String("mix")) {
+            if (TrackCompositing::sumAudioMixAvailable()) {
+                transition.set("sum", 1);
+            } else {
+                transition.set("combine", 1);
+            }
+        } else if (service == QLatin1String("composite")) {
+            transition.set("valign", "middle");
+            transition.set("halign", "centre");
+            transition.set("fill", 1);
+            transition.set("geometry", QStringLiteral("0=0/0:%1x%2").arg(profile.width()).arg(profile.height()).toUtf8().constData());
+        }
+        transition.set("a_track", 0);
+        transition.set("b_track", track);
+        transition.set("internal_added", 237);
+        field->plant_transition(transition, 0, track);
+    }
+}
+
+/** Build a project with the same track layout and internal transitions as a Kdenlive timeline */
+bool generateProject(const QString &path, const std::string &profileName, int tracks, bool contentRanges)
+{
+    Mlt::Profile profile(profileName.c_str());
+    Mlt::Tractor tractor(profile);
+    int length = tracks * (clipLength + gapLength) * 4;
+
+    Mlt::Playlist black(profile);
+    Mlt::Producer blackClip(profile, "color:black");
+    blackClip.set("mlt_image_format", "rgb24a");
+    black.append(blackClip, 0, length - 1);
+    tractor.set_track(black, 0);
+
+    QList<int> videoTracks;
+    QMap<int, QList<QPair<int, int> > > trackRanges;
+    const char *colors[] = {"#ff0000", "#00ff00", "#0000ff", "#ffff00"};
+    for (int i = 1; i <= 2 * tracks; ++i) {
+        Mlt::Playlist playlist(profile);
+        bool audio = i <= tracks;
+        playlist.set("kdenlive:track_name", QStringLiteral("%1 %2").arg(audio ? QStringLiteral("Audio") : QStringLiteral("Video")).arg(i).toUtf8().constData());
+        if (audio) {
+            playlist.set("kdenlive:audio_track", 1);
+        }
+        // Offset the clips of each track so that the tracks do not all start and end together
+        playlist.blank(i * gapLength - 1);
+        for (int pos = i * gapLength, clip = 0; pos + clipLength < length; pos += clipLength + gapLength, ++clip) {
+            Mlt::Producer *producer;
+            if (audio) {
+                producer = new Mlt::Producer(profile, "tone");
+                producer->set("frequency", 220. * i);
+            } else if (clip % 2) {
+                producer = new Mlt::Producer(profile, "noise");
+            } else {
+                producer = new Mlt::Producer(profile, "color", colors[clip % 4]);
+            }
+            if (!producer->is_valid()) {
+                std::cerr << "Cannot create synthetic producer" << std::endl;
+                delete producer;
+                return false;
+            }
+            producer->set("length", clipLength);
+            playlist.append(*producer, 0, clipLength - 1);
+            trackRanges[i] << QPair<int, int>(pos, pos + clipLength);
+            playlist.blank(gapLength - 1);
+            delete producer;
+        }
+        tractor.set_track(playlist, i);
+        if (audio) {
+            tractor.track(i)->set("hide", 1);
+        } else {
+            videoTracks << i;
+        }
+    }
+
+    if (contentRanges) {
+        // Same ranges as Timeline::slotUpdateCompositing
+        for (int i = 1; i <= 2 * tracks; ++i) {
+            trackRanges[i] = TrackCompositing::mergeRanges(trackRanges.value(i), qRound(profile.fps()), TrackCompositing::maxRanges);
+        }
+    } else {
+        trackRanges.clear();
+    }
+    Mlt::Field *field = tractor.field();
+    for (int i = 1; i <= 2 * tracks; ++i) {
+        plantTrackTransition(field, profile, QStringLiteral("mix"), i, trackRanges.value(i));
+    }
+    const QString composite = compositeService();
+    foreach (int track, videoTracks) {
+        plantTrackTransition(field, profile, composite, track, trackRanges.value(track));
+    }
+    delete field;
+
+    Mlt::Consumer xml(profile, "xml", path.toUtf8().constData());
+    if (!xml.is_valid()) {
+        return false;
+    }
+    xml.set("title", "Kdenlive playback benchmark");
+    xml.connect(tractor);
+    xml.run();
+    return QFile::exists(path);
+}
+
+/** Restrict the always active internal transitions of a loaded project to the track content, like Timeline::slotUpdateCompositing */
+void applyContentRanges(Mlt::Producer &producer, Mlt::Profile &profile)
+{
+    Mlt::Service service(producer.parent().get_service());
+    if (service.type() != tractor_type) {
+        return;
+    }
+    Mlt::Tractor tractor(service);
+    // Same ranges as Track::contentRanges
+    const int minGap = qRound(profile.fps());
+    QMap<int, QList<QPair<int, int> > > trackRanges;
+    for (int i = 1; i < tractor.count(); ++i) {
+        Mlt::Producer *track = tractor.track(i);
+        Mlt::Playlist playlist(*track);
+        delete track;
+        QList<QPair<int, int> > ranges;
+        for (int j = 0; playlist.is_valid() && j < playlist.count(); ++j) {
+            if (!playlist.is_blank(j)) {
+                int start = playlist.clip_start(j);
+                ranges << QPair<int, int>(start, start + playlist.clip_length(j));
+            }
+        }
+        trackRanges[i] = TrackCompositing::mergeRanges(ranges, minGap, TrackCompositing::maxRanges);
+    }
+
+    Mlt::Field *field = tractor.field();
+    // List the transitions first, planting the copies changes the field chain
+    QList<mlt_transition> automatic;
+    mlt_service nextservice = mlt_service_get_producer(field->get_service());
+    while (nextservice != nullptr && mlt_service_identify(nextservice) == transition_type) {
+        mlt_transition tr = (mlt_transition) nextservice;
+        mlt_properties props = MLT_TRANSITION_PROPERTIES(tr);
+        if (mlt_properties_get_int(props, "internal_added") == 237 && mlt_properties_get_int(props, "always_active") == 1
+            && trackRanges.contains(mlt_transition_get_b_track(tr))) {
+            automatic << tr;
+        }
+        nextservice = mlt_service_producer(nextservice);
+    }
+    foreach (mlt_transition tr, automatic) {
+        Mlt::Transition transition(tr);
+        const QList<QPair<int, int> > ranges = trackRanges.value(transition.get_b_track());
+        if (ranges.isEmpty()) {
+            // Nothing to blend on an empty track
+            transition.set("disable", 1);
+            continue;
+        }
+        transition.set("always_active", 0);
+        transition.set_in_and_out(ranges.first().first, ranges.first().second - 1);
+        // Copies for the other ranges are planted on top, the stacking order does not change the work done for each frame
+        for (int i = 1; i < ranges.count(); ++i) {
+            Mlt::Transition copy(profile, transition.get("mlt_service"));
+            Mlt::Properties source(transition.get_properties());
+            for (int j = 0; j < source.count(); ++j) {
+                char *name = source.get_name(j);
+                char *value = source.get(j);
+                if (name != nullptr && value != nullptr && name[0] != '_') {
+                    copy.set(name, value);
+                }
+            }
+            copy.set("id", (char *) nullptr);
+            copy.set_in_and_out(ranges.at(i).first, ranges.at(i).second - 1);
+            field->plant_transition(copy, transition.get_a_track(), transition.get_b_track());
+        }
+    }
+    delete field;
+}
+
+/** Returns the peak resident memory of the process in kB and resets it, or -1 if unknown */
+qint64 takePeakMemory()
+{
+    qint64 peak = -1;
+    QFile status(QStringLiteral("/proc/self/status"));
+    if (status.open(QIODevice::ReadOnly)) {
+        const QList<QByteArray> lines = status.readAll().split('\n');
+        for (const QByteArray &line : lines) {
+            if (line.startsWith("VmHWM:")) {
+                peak = line.mid(6).trimmed().split(' ').first().toLongLong();
+                break;
+            }
+        }
+    }
+    // Since Linux 4.0, writing 5 resets the peak to the current usage
+    QFile clear(QStringLiteral("/proc/self/clear_refs"));
+    if (clear.open(QIODevice::WriteOnly)) {
+        clear.write("5");
+    }
+    return peak;
+}
+
+/** Pull one frame in the format requested by the monitor (FrameRenderer::showFrame) and return the time it took, in nanoseconds */
+qint64 pullFrame(Mlt::Producer &producer, Mlt::Profile &profile, bool audio)
+{
+    QElapsedTimer timer;
+    timer.start();
+    int position = producer.position();
+    Mlt::Frame *frame = producer.get_frame();
+    mlt_image_format format = mlt_image_yuv420p;
+    int width = profile.width();
+    int height = profile.height();
+    frame->get_image(format, width, height);
+    if (audio) {
+        mlt_audio_format audioFormat = mlt_audio_s16;
+        int frequency = 48000;
+        int channels = 2;
+        int samples = mlt_sample_calculator(profile.fps(), frequency, position);
+        frame->get_audio(audioFormat, frequency, channels, samples);
+    }
+    delete frame;
+    return timer.nsecsElapsed();
+}
+
+void runPattern(const QString &pattern, Mlt::Producer &producer, Mlt::Profile &profile, int frames, bool json)
+{
+    const int length = producer.get_playtime();
+    QVector<qint64> times;
+    times.reserve(frames);
+    takePeakMemory();
+    QElapsedTimer timer;
+    timer.start();
+    if (pattern == QLatin1String("playback")) {
+        producer.seek(0);
+        producer.set_speed(1);
+        for (int i = 0; i < frames; ++i) {
+            if (producer.position() >= length - 1) {
+                producer.seek(0);
+            }
+            times << pullFrame(producer, profile, true);
+        }
+    } else if (pattern == QLatin1String("reverse")) {
+        producer.seek(length - 1);
+        producer.set_speed(-1);
+        for (int i = 0; i < frames; ++i) {
+            if (producer.position() <= 0) {
+                producer.seek(length - 1);
+            }
+            times << pullFrame(producer, profile, false);
+        }
+    } else {
+        // Scrubbing: jumps back and forth of varying size, always the same sequence
+        producer.set_speed(0);
+        qsrand(1);
+        int position = 0;
+        for (int i = 0; i < frames; ++i) {
+            position = qBound(0, position + (int) (qrand() % 101) - 50, length - 1);
+            producer.seek(position);
+            times << pullFrame(producer, profile, false);
+        }
+    }
+    const qint64 elapsed = timer.nsecsElapsed();
+    producer.set_speed(0);
+    const qint64 peak = takePeakMemory();
+    std::sort(times.begin(), times.end());
+    const double fps = elapsed > 0 ? times.count() * 1e9 / elapsed : 0.;
+    const double p50 = times.isEmpty() ? 0. : times.at(times.count() / 2) / 1e6;
+    const double p99 = times.isEmpty() ? 0. : times.at(qMin(times.count() - 1, times.count() * 99 / 100)) / 1e6;
+    if (json) {
+        QJsonObject result;
+        result.insert(QStringLiteral("pattern"), pattern);
+        result.insert(QStringLiteral("frames"), times.count());
+        result.insert(QStringLiteral("fps"), fps);
+        result.insert(QStringLiteral("p50_ms"), p50);
+        result.insert(QStringLiteral("p99_ms"), p99);
+        result.insert(QStringLiteral("peak_kb"), peak);
+        std::cout << QJsonDocument(result).toJson(QJsonDocument::Compact).constData() << std::endl;
+    } else {
+        std::cout << pattern.toStdString() << ": " << times.count() << " frames, " << fps << " fps, p50 " << p50 << " ms, p99 " << p99
+                  << " ms, peak memory " << peak << " kB" << std::endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+    args.removeAt(0);
+
+    std::string profileName = "atsc_1080p_25";
+    QString generate;
+    QStringList patterns = QStringList() << QStringLiteral("playback") << QStringLiteral("scrub") << QStringLiteral("reverse");
+    int tracks = 3;
+    int frames = 500;
+    bool json = false;
+    bool contentRanges = false;
+    QString project;
+
+    foreach (const QString &str, args) {
+        if (str.startsWith(QLatin1String("--generate="))) {
+            generate = str.section(QLatin1Char('='), 1);
+        } else if (str.startsWith(QLatin1String("--tracks="))) {
+            tracks = qMax(1, str.section(QLatin1Char('='), 1).toInt());
+        } else if (str.startsWith(QLatin1String("--profile="))) {
+            profileName = str.section(QLatin1Char('='), 1).toStdString();
+        } else if (str.startsWith(QLatin1String("--frames="))) {
+            frames = qMax(1, str.section(QLatin1Char('='), 1).toInt());
+        } else if (str.startsWith(QLatin1String("--patterns="))) {
+            patterns = str.section(QLatin1Char('='), 1).split(QLatin1Char(','), QString::SkipEmptyParts);
+        } else if (str == QLatin1String("--content-ranges")) {
+            contentRanges = true;
+        } else if (str == QLatin1String("--json")) {
+            json = true;
+        } else if (str == QLatin1String("-h") || str == QLatin1String("--help")) {
+            printUsage(argv[0]);
+            return 0;
+        } else {
+            project = str;
+        }
+    }
+
+    Mlt::Factory::init();
+    if (!generate.isEmpty()) {
+        if (!generateProject(generate, profileName, tracks, contentRanges)) {
+            std::cerr << "Cannot write synthetic project " << generate.toStdString() << std::endl;
+            return 1;
+        }
+        project = generate;
+    }
+    if (project.isEmpty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // The profile is read from the project, like Render::setSceneList does
+    Mlt::Profile profile;
+    profile.set_explicit(false);
+    QElapsedTimer timer;
+    timer.start();
+    Mlt::Producer producer(profile, "xml", project.toUtf8().constData());
+    if (!producer.is_valid()) {
+        std::cerr << "Cannot load project " << project.toStdString() << std::endl;
+        return 1;
+    }
+    producer.optimise();
+    std::cerr << "Loaded " << project.toStdString() << " (" << profile.width() << "x" << profile.height() << ", " << profile.fps() << " fps, "
+              << producer.get_playtime() << " frames) in " << timer.elapsed() << " ms" << std::endl;
+    if (generate.isEmpty()) {
+        applyContentRanges(producer, profile);
+    }
+
+    foreach (const QString &pattern, patterns) {
+        if (pattern != QLatin1String("playback") && pattern != QLatin1String("scrub") && pattern != QLatin1String("reverse")) {
+            std::cerr << "Unknown pattern " << pattern.toStdString() << std::endl;
+            continue;
+        }
+        runPattern(pattern, producer, profile, frames, json);
+    }
+    return 0;
+}
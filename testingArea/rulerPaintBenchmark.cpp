@@ -0,0 +1,149 @@
+/*
+Copyright (C) 2018  Jean-Baptiste Mardelle <jb@kdenlive.org>
+This file is part of kdenlive. See www.kdenlive.org.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+*/
+
+#include <QImage>
+#include <QPainter>
+#include <QVector>
+#include <QStringList>
+#include <QFontMetrics>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QGuiApplication>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+#include "../src/timeline/rulertiles.h"
+
+void printUsage(const char *path)
+{
+    std::cout << "This executable measures the time needed to paint the labels and marks of the timeline ruler" << std::endl
+              << "during playback, with the cached tiles used by Kdenlive and with direct drawing." << std::endl << std::endl
+              << path << std::endl
+              << "\t-h, --help\n\t\tDisplay this help" << std::endl
+              << "\t--width=<n>\n\t\tWidth of the ruler in pixels (default 1920)" << std::endl
+              << "\t--frame-width=<n>\n\t\tWidth of a frame in pixels (default 6)" << std::endl
+              << "\t--fps=<n>\n\t\tFrame rate of the timecodes (default 25)" << std::endl
+              << "\t--frames=<n>\n\t\tNumber of paints for each pattern (default 1000)" << std::endl
+              << "\t--json\n\t\tWrite one JSON object per pattern and drawing method" << std::endl
+              << "Patterns: 'still' moves the cursor in a fixed view, 'scroll' also scrolls the view by one frame per paint." << std::endl
+              ;
+}
+
+RulerTiles::Layout rulerLayout(double frameWidth, double fps)
+{
+    RulerTiles::Layout layout;
+    QFontMetrics metrics(layout.font);
+    layout.timecode = Timecode(Timecode::HH_MM_SS_FF, fps);
+    layout.factor = frameWidth;
+    layout.littleMarks = frameWidth;
+    layout.mediumMarks = frameWidth * fps;
+    layout.bigMarks = frameWidth * fps * 60;
+    // One label every few seconds, like CustomRuler at a medium zoom level
+    const double second = frameWidth * fps;
+    layout.textSpacing = second * std::ceil((metrics.boundingRect(QStringLiteral("00:00:00:00")).width() + 10) / second);
+    layout.labelBottom = metrics.ascent();
+    layout.height = 2 * layout.labelBottom - 1;
+    const int markLength = layout.height - layout.labelBottom - 1;
+    layout.mediumMarkTop = layout.labelBottom + markLength / 3;
+    layout.littleMarkTop = layout.labelBottom + markLength / 2;
+    layout.textColor = Qt::black;
+    layout.markColor = Qt::darkGray;
+    return layout;
+}
+
+void report(const QString &pattern, const QString &method, QVector<qint64> &times, int tiles, bool json)
+{
+    std::sort(times.begin(), times.end());
+    qint64 total = 0;
+    for (qint64 time : times) {
+        total += time;
+    }
+    const double mean = times.isEmpty() ? 0. : total / 1e3 / times.count();
+    const double p50 = times.isEmpty() ? 0. : times.at(times.count() / 2) / 1e3;
+    const double p99 = times.isEmpty() ? 0. : times.at(qMin(times.count() - 1, times.count() * 99 / 100)) / 1e3;
+    if (json) {
+        QJsonObject result;
+        result.insert(QStringLiteral("pattern"), pattern);
+        result.insert(QStringLiteral("method"), method);
+        result.insert(QStringLiteral("paints"), times.count());
+        result.insert(QStringLiteral("mean_us"), mean);
+        result.insert(QStringLiteral("p50_us"), p50);
+        result.insert(QStringLiteral("p99_us"), p99);
+        result.insert(QStringLiteral("tiles"), tiles);
+        std::cout << QJsonDocument(result).toJson(QJsonDocument::Compact).constData() << std::endl;
+    } else {
+        std::cout << pattern.toStdString() << ", " << method.toStdString() << ": " << times.count() << " paints, mean " << mean << " us, p50 " << p50
+                  << " us, p99 " << p99 << " us" << std::endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    // Paint without a display
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QGuiApplication app(argc, argv);
+    QStringList args = app.arguments();
+    args.removeAt(0);
+
+    int width = 1920;
+    double frameWidth = 6;
+    double fps = 25;
+    int frames = 1000;
+    bool json = false;
+    foreach (const QString &str, args) {
+        if (str.startsWith(QLatin1String("--width="))) {
+            width = qMax(1, str.section(QLatin1Char('='), 1).toInt());
+        } else if (str.startsWith(QLatin1String("--frame-width="))) {
+            frameWidth = qMax(1., str.section(QLatin1Char('='), 1).toDouble());
+        } else if (str.startsWith(QLatin1String("--fps="))) {
+            fps = qMax(1., str.section(QLatin1Char('='), 1).toDouble());
+        } else if (str.startsWith(QLatin1String("--frames="))) {
+            frames = qMax(1, str.section(QLatin1Char('='), 1).toInt());
+        } else if (str == QLatin1String("--json")) {
+            json = true;
+        } else {
+            printUsage(argv[0]);
+            return str == QLatin1String("-h") || str == QLatin1String("--help") ? 0 : 1;
+        }
+    }
+
+    const RulerTiles::Layout layout = rulerLayout(frameWidth, fps);
+    QImage target(width, layout.height + 1, QImage::Format_ARGB32_Premultiplied);
+    const QStringList patterns = QStringList() << QStringLiteral("still") << QStringLiteral("scroll");
+    for (const QString &pattern : patterns) {
+        for (int cached = 1; cached >= 0; --cached) {
+            RulerTiles tiles;
+            tiles.setLayout(layout);
+            QVector<qint64> times;
+            times.reserve(frames);
+            for (int i = 0; i < frames; ++i) {
+                const int offset = pattern == QLatin1String("scroll") ? (int)(i * frameWidth) : 0;
+                QElapsedTimer timer;
+                timer.start();
+                QPainter p(&target);
+                p.fillRect(target.rect(), Qt::white);
+                if (cached) {
+                    tiles.draw(&p, 0, width - 1, offset);
+                } else {
+                    p.translate(-offset, 0);
+                    tiles.render(&p, offset, offset + width);
+                }
+                p.end();
+                times << timer.nsecsElapsed();
+            }
+            report(pattern, cached ? QStringLiteral("tiles") : QStringLiteral("direct"), times, tiles.count(), json);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,184 @@
+/*
+Copyright (C) 2018  Jean-Baptiste Mardelle <jb@kdenlive.org>
+This file is part of kdenlive. See www.kdenlive.org.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+*/
+
+#include <QVector>
+#include <QStringList>
+#include <QElapsedTimer>
+#include <QScopedPointer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QCoreApplication>
+#include <mlt++/Mlt.h>
+#include <iostream>
+
+#include "../src/timeline/transitionindex.h"
+
+// Length of the synthetic transitions and of the gaps between them, in frames
+static const int transitionLength = 25;
+static const int gapLength = 50;
+
+struct Query {
+    int track;
+    int in;
+    int out;
+};
+
+void printUsage(const char *path)
+{
+    std::cout << "This executable compares the lookup of transitions by walking the MLT field chain" << std::endl
+              << "with the TransitionIndex used by the Kdenlive timeline." << std::endl << std::endl
+              << path << std::endl
+              << "\t-h, --help\n\t\tDisplay this help" << std::endl
+              << "\t--tracks=<n>\n\t\tNumber of tracks (default 6)" << std::endl
+              << "\t--transitions=<n>\n\t\tNumber of transitions on each track (default 200)" << std::endl
+              << "\t--lookups=<n>\n\t\tNumber of lookups (default 2000)" << std::endl
+              << "\t--json\n\t\tWrite the result as a JSON object" << std::endl
+              ;
+}
+
+/** Build a field with one mix transition per track, like the timeline, and @param count luma transitions on each track */
+void fillField(Mlt::Tractor &tractor, Mlt::Profile &profile, int tracks, int count)
+{
+    const int length = count * (transitionLength + gapLength);
+    Mlt::Producer black(profile, "color:black");
+    for (int i = 0; i <= tracks; ++i) {
+        Mlt::Playlist playlist(profile);
+        playlist.append(black, 0, length - 1);
+        tractor.set_track(playlist, i);
+    }
+    Mlt::Field *field = tractor.field();
+    for (int i = 1; i <= tracks; ++i) {
+        Mlt::Transition mix(profile, "mix");
+        mix.set("always_active", 1);
+        mix.set("internal_added", 237);
+        field->plant_transition(mix, 0, i);
+    }
+    for (int i = 1; i <= tracks; ++i) {
+        for (int j = 0; j < count; ++j) {
+            Mlt::Transition luma(profile, "luma");
+            const int in = j * (transitionLength + gapLength) + i;
+            luma.set_in_and_out(in, in + transitionLength - 1);
+            field->plant_transition(luma, i - 1, i);
+        }
+    }
+    delete field;
+}
+
+/** Lookup by walking the field chain, as TransitionHandler did before the index */
+mlt_transition walkField(Mlt::Tractor &tractor, const Query &query)
+{
+    QScopedPointer<Mlt::Field> field(tractor.field());
+    mlt_service nextservice = mlt_service_get_producer(field->get_service());
+    while (nextservice != nullptr && mlt_service_identify(nextservice) == transition_type) {
+        mlt_transition tr = (mlt_transition) nextservice;
+        if (mlt_transition_get_b_track(tr) == query.track && (int) mlt_transition_get_in(tr) == query.in && (int) mlt_transition_get_out(tr) == query.out && qstrcmp(mlt_properties_get(MLT_TRANSITION_PROPERTIES(tr), "mlt_service"), "luma") == 0) {
+            return tr;
+        }
+        nextservice = mlt_service_producer(nextservice);
+    }
+    return nullptr;
+}
+
+mlt_transition findIndexed(TransitionIndex &index, const Query &query)
+{
+    const int out = query.out;
+    return index.find(query.track, query.in, query.in, false, [out](mlt_transition tr, int, int trOut) {
+        return trOut == out && qstrcmp(mlt_properties_get(MLT_TRANSITION_PROPERTIES(tr), "mlt_service"), "luma") == 0;
+    });
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+    args.removeAt(0);
+
+    int tracks = 6;
+    int count = 200;
+    int lookups = 2000;
+    bool json = false;
+    foreach (const QString &str, args) {
+        if (str.startsWith(QLatin1String("--tracks="))) {
+            tracks = qMax(1, str.section(QLatin1Char('='), 1).toInt());
+        } else if (str.startsWith(QLatin1String("--transitions="))) {
+            count = qMax(1, str.section(QLatin1Char('='), 1).toInt());
+        } else if (str.startsWith(QLatin1String("--lookups="))) {
+            lookups = qMax(1, str.section(QLatin1Char('='), 1).toInt());
+        } else if (str == QLatin1String("--json")) {
+            json = true;
+        } else {
+            printUsage(argv[0]);
+            return str == QLatin1String("-h") || str == QLatin1String("--help") ? 0 : 1;
+        }
+    }
+
+    Mlt::Factory::init();
+    Mlt::Profile profile("atsc_1080p_25");
+    Mlt::Tractor tractor(profile);
+    fillField(tractor, profile, tracks, count);
+
+    // Always the same sequence of existing transitions
+    QVector<Query> queries;
+    queries.reserve(lookups);
+    qsrand(1);
+    for (int i = 0; i < lookups; ++i) {
+        Query query;
+        query.track = 1 + qrand() % tracks;
+        query.in = (qrand() % count) * (transitionLength + gapLength) + query.track;
+        query.out = query.in + transitionLength - 1;
+        queries << query;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    int found = 0;
+    for (const Query &query : queries) {
+        found += walkField(tractor, query) != nullptr ? 1 : 0;
+    }
+    const qint64 walkTime = timer.nsecsElapsed();
+    if (found != lookups) {
+        std::cerr << "Field walk found " << found << " of " << lookups << " transitions" << std::endl;
+        return 1;
+    }
+
+    TransitionIndex index(&tractor);
+    timer.start();
+    // The first lookup builds the index
+    found = findIndexed(index, queries.first()) != nullptr ? 1 : 0;
+    const qint64 buildTime = timer.nsecsElapsed();
+    timer.start();
+    for (int i = 1; i < queries.count(); ++i) {
+        found += findIndexed(index, queries.at(i)) != nullptr ? 1 : 0;
+    }
+    const qint64 indexTime = timer.nsecsElapsed();
+    if (found != lookups) {
+        std::cerr << "Index found " << found << " of " << lookups << " transitions" << std::endl;
+        return 1;
+    }
+
+    const int total = tracks * (count + 1);
+    const double walkUs = walkTime / 1e3 / lookups;
+    const double indexUs = lookups > 1 ? indexTime / 1e3 / (lookups - 1) : 0.;
+    const double buildMs = buildTime / 1e6;
+    if (json) {
+        QJsonObject result;
+        result.insert(QStringLiteral("transitions"), total);
+        result.insert(QStringLiteral("lookups"), lookups);
+        result.insert(QStringLiteral("walk_us"), walkUs);
+        result.insert(QStringLiteral("index_us"), indexUs);
+        result.insert(QStringLiteral("index_build_ms"), buildMs);
+        std::cout << QJsonDocument(result).toJson(QJsonDocument::Compact).constData() << std::endl;
+    } else {
+        std::cout << total << " transitions, " << lookups << " lookups" << std::endl
+                  << "field walk: " << walkUs << " us per lookup" << std::endl
+                  << "index: " << indexUs << " us per lookup, built in " << buildMs << " ms" << std::endl;
+    }
+    return 0;
+}